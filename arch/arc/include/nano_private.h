@@ -187,6 +187,11 @@ struct tcs {
 #ifdef CONFIG_THREAD_MONITOR
 	struct __thread_entry *entry; /* thread entry and parameters description */
 	struct tcs *next_thread;  /* next item in list of ALL fiber+tasks */
+#endif
+	struct tcs *wait_prev; /* previous fiber in wait queue, if not head */
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+	/* other end of the run of same priority fibers in a wait queue */
+	struct tcs *wait_prio_peer;
 #endif
 #ifdef CONFIG_NANO_TIMEOUTS
 	struct _nano_timeout nano_timeout;
@@ -225,7 +230,9 @@ struct s_NANO {
 
 	struct firq_regs firq_regs;
 #if defined(CONFIG_NANO_TIMEOUTS) || defined(CONFIG_NANO_TIMERS)
+#ifndef CONFIG_TIMEOUT_WHEEL
 	sys_dlist_t timeout_q;
+#endif
 	int32_t task_timeout;
 #endif
 };
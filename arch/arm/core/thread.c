@@ -135,6 +135,14 @@ void _new_thread(char *pStackMem, unsigned stackSize, _thread_entry_t pEntry,
 	tcs->custom_data = NULL;
 #endif
 
+#ifdef CONFIG_THREAD_CPU_ACCOUNTING
+	tcs->cpu_cycles = 0;
+#endif
+
+#ifdef CONFIG_NANO_TIMESLICING
+	tcs->slice_ticks = 0;
+#endif
+
 #ifdef CONFIG_THREAD_MONITOR
 	/*
 	 * In debug mode tcs->entry give direct access to the thread entry
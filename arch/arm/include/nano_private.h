@@ -99,6 +99,7 @@ typedef struct preempt tPreempt;
 #define INT_ACTIVE 0x002     /* 1 = executino context is interrupt handler */
 #define EXC_ACTIVE 0x004     /* 1 = executino context is exception handler */
 #define USE_FP 0x010	 /* 1 = thread uses floating point unit */
+#define SLICE_EXPIRED 0x040 /* 1 = fiber to swap out on interrupt exit */
 #define PREEMPTIBLE                                            \
 	0x020 /* 1 = preemptible thread                       \
 	       * NOTE: the value must be < 0x100 to be able to \
@@ -132,6 +133,11 @@ struct tcs {
 #if defined(CONFIG_THREAD_MONITOR)
 	struct __thread_entry *entry; /* thread entry and parameters description */
 	struct tcs *next_thread; /* next item in list of ALL fiber+tasks */
+#endif
+	struct tcs *wait_prev; /* previous fiber in wait queue, if not head */
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+	/* other end of the run of same priority fibers in a wait queue */
+	struct tcs *wait_prio_peer;
 #endif
 #ifdef CONFIG_NANO_TIMEOUTS
 	struct _nano_timeout nano_timeout;
@@ -139,6 +145,12 @@ struct tcs {
 #ifdef CONFIG_ERRNO
 	int errno_var;
 #endif
+#ifdef CONFIG_THREAD_CPU_ACCOUNTING
+	uint64_t cpu_cycles; /* hardware clock cycles the thread ran for */
+#endif
+#ifdef CONFIG_NANO_TIMESLICING
+	int32_t slice_ticks; /* ticks the fiber ran for in its time slice */
+#endif
 };
 
 struct s_NANO {
@@ -160,7 +172,9 @@ struct s_NANO {
 #endif
 
 #if defined(CONFIG_NANO_TIMEOUTS) || defined(CONFIG_NANO_TIMERS)
+#ifndef CONFIG_TIMEOUT_WHEEL
 	sys_dlist_t timeout_q;
+#endif
 	int32_t task_timeout;
 #endif
 };
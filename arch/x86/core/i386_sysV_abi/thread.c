@@ -92,6 +92,14 @@ static void _new_thread_internal(char *pStackMem, unsigned stackSize,
 	tcs->custom_data = NULL;
 #endif
 
+#ifdef CONFIG_THREAD_CPU_ACCOUNTING
+	tcs->cpu_cycles = 0;
+#endif
+
+#ifdef CONFIG_NANO_TIMESLICING
+	tcs->slice_ticks = 0;
+#endif
+
 
 	/*
 	 * The creation of the initial stack for the task has already been done.
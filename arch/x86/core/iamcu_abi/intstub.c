@@ -112,11 +112,15 @@ void _execute_handler(int_handler_t function, int context)
 		/* switch to kernel stack */
 		__asm__ volatile ("popl %esp");
 
-		/* if the interrupted context was a task we need to
-		 * swap back to the interrupted context
+		/* if the interrupted context was a task, or a fiber whose
+		 * time slice has expired, we need to swap back to the
+		 * interrupted context
 		 */
-		if ((_nanokernel.current->flags & PREEMPTIBLE) &&
-			_nanokernel.fiber) {
+		if ((_nanokernel.current->flags &
+		     (PREEMPTIBLE | SLICE_EXPIRED)) && _nanokernel.fiber) {
+#ifdef CONFIG_NANO_TIMESLICING
+			_nanokernel.current->flags &= ~SLICE_EXPIRED;
+#endif
 			/* move flags into arg0 we can't use local
 			 * variables here since the stack may have
 			 * changed.
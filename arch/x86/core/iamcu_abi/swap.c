@@ -24,6 +24,12 @@ extern void _sys_k_event_logger_context_switch(void);
 #define _sys_k_event_logger_context_switch()
 #endif
 
+#ifdef CONFIG_THREAD_CPU_ACCOUNTING
+extern void _sys_thread_cpu_accounting_switch(void);
+#else
+#define _sys_thread_cpu_accounting_switch()
+#endif
+
 /* Stack protector disabled here; we switch stacks, so the sentinel
  * placed by the stack protection code isn't there when it checks for it
  * at the end of the function
@@ -47,6 +53,7 @@ _Swap(unsigned int eflags)
 			 :"=m" (_nanokernel.current->coopReg.esp));
 
 	_sys_k_event_logger_context_switch();
+	_sys_thread_cpu_accounting_switch();
 
 	/* find the next context to run */
 	if (_nanokernel.fiber) {
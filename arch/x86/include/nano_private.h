@@ -72,6 +72,7 @@
 #define EXC_ACTIVE 0x4     /* 1 = executing context is exception handler */
 #define USE_FP 0x10	       /* 1 = thread uses floating point unit */
 #define USE_SSE 0x20       /* 1 = thread uses SSEx instructions */
+#define SLICE_EXPIRED 0x40 /* 1 = fiber to swap out on interrupt exit */
 #define PREEMPTIBLE 0x100  /* 1 = preemptible thread */
 #define ESSENTIAL 0x200    /* 1 = system thread that must not abort */
 #define NO_METRICS 0x400   /* 1 = _Swap() not to update task metrics */
@@ -669,6 +670,11 @@ struct tcs {
 	void *custom_data;     /* available for custom use */
 #endif
 
+	struct tcs *wait_prev; /* previous fiber in wait queue, if not head */
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+	/* other end of the run of same priority fibers in a wait queue */
+	struct tcs *wait_prio_peer;
+#endif
 #ifdef CONFIG_NANO_TIMEOUTS
 	struct _nano_timeout nano_timeout;
 #endif
@@ -677,6 +683,13 @@ struct tcs {
 	int errno_var;
 #endif
 
+#ifdef CONFIG_THREAD_CPU_ACCOUNTING
+	uint64_t cpu_cycles; /* hardware clock cycles the thread ran for */
+#endif
+#ifdef CONFIG_NANO_TIMESLICING
+	int32_t slice_ticks; /* ticks the fiber ran for in its time slice */
+#endif
+
 	/*
 	 * The location of all floating point related structures/fields MUST be
 	 * located at the end of struct tcs.  This way only the
@@ -728,7 +741,9 @@ typedef struct s_NANO {
 	struct tcs *current_fp; /* thread (fiber or task) that owns the FP regs */
 #endif			  /* CONFIG_FP_SHARING */
 #if defined(CONFIG_NANO_TIMEOUTS) || defined(CONFIG_NANO_TIMERS)
+#ifndef CONFIG_TIMEOUT_WHEEL
 	sys_dlist_t timeout_q;
+#endif
 	int32_t task_timeout;
 #endif
 } tNANO;
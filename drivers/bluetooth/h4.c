@@ -204,6 +204,8 @@ static void bt_uart_isr(struct device *unused)
 
 static int h4_send(struct net_buf *buf)
 {
+	struct net_buf *frag;
+
 	switch (bt_buf_get_type(buf)) {
 	case BT_BUF_ACL_OUT:
 		uart_poll_out(h4_dev, H4_ACL);
@@ -215,8 +217,10 @@ static int h4_send(struct net_buf *buf)
 		return -EINVAL;
 	}
 
-	while (buf->len) {
-		uart_poll_out(h4_dev, net_buf_pull_u8(buf));
+	for (frag = buf; frag; frag = frag->frags) {
+		while (frag->len) {
+			uart_poll_out(h4_dev, net_buf_pull_u8(frag));
+		}
 	}
 
 	net_buf_unref(buf);
@@ -302,13 +302,11 @@ static uint8_t h5_slip_byte(uint8_t byte)
 	}
 }
 
-static void h5_send(const uint8_t *payload, uint8_t type, int len)
+static void h5_send_hdr(uint8_t type, int len)
 {
 	uint8_t hdr[4];
 	int i;
 
-	hexdump("<= ", payload, len);
-
 	memset(hdr, 0, sizeof(hdr));
 
 	/* Set ACK for outgoing packet and stop delayed fiber */
@@ -338,6 +336,15 @@ static void h5_send(const uint8_t *payload, uint8_t type, int len)
 	for (i = 0; i < 4; i++) {
 		h5_slip_byte(hdr[i]);
 	}
+}
+
+static void h5_send(const uint8_t *payload, uint8_t type, int len)
+{
+	int i;
+
+	hexdump("<= ", payload, len);
+
+	h5_send_hdr(type, len);
 
 	for (i = 0; i < len; i++) {
 		h5_slip_byte(payload[i]);
@@ -346,6 +353,24 @@ static void h5_send(const uint8_t *payload, uint8_t type, int len)
 	uart_poll_out(h5_dev, SLIP_DELIMITER);
 }
 
+static void h5_send_buf(struct net_buf *buf, uint8_t type)
+{
+	struct net_buf *frag;
+	int i;
+
+	h5_send_hdr(type, net_buf_frags_len(buf));
+
+	for (frag = buf; frag; frag = frag->frags) {
+		hexdump("<= ", frag->data, frag->len);
+
+		for (i = 0; i < frag->len; i++) {
+			h5_slip_byte(frag->data[i]);
+		}
+	}
+
+	uart_poll_out(h5_dev, SLIP_DELIMITER);
+}
+
 /* Delayed fiber taking care about retransmitting packets */
 static void retx_fiber(int arg1, int arg2)
 {
@@ -637,7 +662,7 @@ static void tx_fiber(void)
 			buf = nano_fifo_get(&h5.tx_queue, TICKS_UNLIMITED);
 			type = h5_get_type(buf);
 
-			h5_send(buf->data, type, buf->len);
+			h5_send_buf(buf, type);
 
 			/* buf is dequeued from tx_queue and queued to unack
 			 * queue.
@@ -89,7 +89,9 @@ static uint32_t clock_accumulated_count;
 extern uint32_t _hw_irq_to_c_handler_latency;
 #endif
 
-#ifdef CONFIG_SYS_POWER_MANAGEMENT
+#if defined(CONFIG_NANOKERNEL) && defined(CONFIG_TICKLESS_IDLE)
+extern void _power_save_idle_exit(void);
+#elif defined(CONFIG_SYS_POWER_MANAGEMENT)
 extern int32_t _NanoIdleValGet(void);
 extern void _NanoIdleValClear(void);
 extern void _sys_power_save_idle_exit(int32_t ticks);
@@ -250,7 +252,9 @@ void _TIMER_INT_HANDLER(void *unused)
 #endif
 
 #ifdef CONFIG_SYS_POWER_MANAGEMENT
+#if !defined(CONFIG_NANOKERNEL) || !defined(CONFIG_TICKLESS_IDLE)
 	int32_t numIdleTicks;
+#endif
 
 	/*
 	 * All interrupts are disabled when handling idle wakeup.
@@ -291,8 +295,15 @@ void _TIMER_INT_HANDLER(void *unused)
 		 * Increment the tick because _timer_idle_exit does not
 		 * account for the tick due to the timer interrupt itself.
 		 * Also, if not in tickless mode, _sys_idle_elapsed_ticks will be 0.
+		 * The nanokernel announces the ticks right away instead and
+		 * does not clear _sys_idle_elapsed_ticks: only this tick is
+		 * left to announce.
 		 */
+#ifdef CONFIG_MICROKERNEL
 		_sys_idle_elapsed_ticks++;
+#else
+		_sys_idle_elapsed_ticks = 1;
+#endif
 
 		/*
 		 * If we transition from 0 elapsed ticks to 1 we need to
@@ -318,6 +329,15 @@ void _TIMER_INT_HANDLER(void *unused)
 	_sys_clock_tick_announce();
 #endif /* CONFIG_TICKLESS_IDLE */
 
+#if defined(CONFIG_NANOKERNEL) && defined(CONFIG_TICKLESS_IDLE)
+	/*
+	 * Complete nanokernel idle processing. This calls _timer_idle_exit()
+	 * too, which does nothing since the timer is back in periodic mode
+	 * and the ticks have been announced above: only the kernel idle
+	 * setting is cleared.
+	 */
+	_power_save_idle_exit();
+#else
 	numIdleTicks = _NanoIdleValGet(); /* get # of idle ticks requested */
 
 	if (numIdleTicks) {
@@ -330,6 +350,7 @@ void _TIMER_INT_HANDLER(void *unused)
 		 */
 		_sys_power_save_idle_exit(numIdleTicks);
 	}
+#endif
 
 	__asm__(" cpsie i"); /* re-enable interrupts (PRIMASK = 0) */
 
@@ -56,7 +56,7 @@ struct bt_driver {
 	/* Open the HCI transport */
 	int (*open)(void);
 
-	/* Send HCI buffer to controller */
+	/* Send HCI buffer to controller, including its fragments */
 	int (*send)(struct net_buf *buf);
 };
 
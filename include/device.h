@@ -19,6 +19,8 @@
 #define _DEVICE_H_
 
 #include <errno.h>
+#include <stdint.h>
+#include <atomic.h>
 
 /**
  * @brief Device Driver APIs
@@ -78,6 +80,12 @@ extern "C" {
  * that need automatic configuration. These devices can use all services
  * provided by the kernel during configuration.
  *
+ * LAZY: Used for devices that are not needed to boot, such as those whose
+ * configuration waits for slow hardware. With CONFIG_DEVICE_INIT_LAZY, these
+ * devices are configured by the first device_get_binding() call that finds
+ * them, instead of during system initialization, and must not be used through
+ * DEVICE_GET(). Otherwise, they are configured after the APPLICATION level.
+ *
  * @param prio The initialization priority of the device, relative to
  * other devices of the same initialization level. Specified as an integer
  * value in the range 0 to 99; lower values indicate earlier initialization.
@@ -147,6 +155,12 @@ extern "C" {
  * that need automatic configuration. These devices can use all services
  * provided by the kernel during configuration.
  *
+ * LAZY: Used for devices that are not needed to boot, such as those whose
+ * configuration waits for slow hardware. With CONFIG_DEVICE_INIT_LAZY, these
+ * devices are configured by the first device_get_binding() call that finds
+ * them, instead of during system initialization, and must not be used through
+ * DEVICE_GET(). Otherwise, they are configured after the APPLICATION level.
+ *
  * @param prio The initialization priority of the device, relative to
  * other devices of the same initialization level. Specified as an integer
  * value in the range 0 to 99; lower values indicate earlier initialization.
@@ -276,15 +290,27 @@ struct device_config {
  * @param driver_api pointer to structure containing the API functions for
  * the device type. This pointer is filled in by the driver at init time.
  * @param driver_data river instance data. For driver use only
+ * @param lazy_init Lazy initialization state. For kernel use only
+ * @param init_cycles Duration of the initialization, when boot time
+ * measurement is enabled
  */
 struct device {
 	struct device_config *config;
 	void *driver_api;
 	void *driver_data;
+#ifdef CONFIG_DEVICE_INIT_LAZY
+	/* LAZY device init function started (bit 0) and done (bit 1) */
+	atomic_t lazy_init;
+#endif
+#ifdef CONFIG_BOOT_TIME_MEASUREMENT
+	/* duration of the init function, in CPU clock cycles */
+	uint32_t init_cycles;
+#endif
 };
 
 void _sys_device_do_config_level(int level);
 struct device* device_get_binding(char *name);
+int device_get_bindings(char *names[], struct device *devices[], int count);
 
 #ifdef CONFIG_DEVICE_POWER_MANAGEMENT
 /**
@@ -69,6 +69,7 @@
 		DEVICE_INIT_LEVEL(NANOKERNEL)	\
 		DEVICE_INIT_LEVEL(MICROKERNEL)	\
 		DEVICE_INIT_LEVEL(APPLICATION)	\
+		DEVICE_INIT_LEVEL(LAZY)		\
 		__device_init_end = .;			\
 
 
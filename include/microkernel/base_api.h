@@ -22,6 +22,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <toolchain.h>
+#include <atomic.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -64,6 +65,26 @@ struct k_block {
 	uint32_t req_size;
 };
 
+/**
+ * Mailbox message fragment.  The descriptor lives at the start of the memory
+ * pool block that holds the fragment data; the data follows the descriptor.
+ */
+struct k_mbox_frag {
+	/** next fragment of the message, or NULL */
+	struct k_mbox_frag *next;
+	/** memory pool block holding this fragment */
+	struct k_block block;
+	/** number of data bytes in this fragment */
+	uint32_t size;
+};
+
+struct k_pipe_span {
+	kpipe_t pipe_id;
+	void *data;
+	int size;
+	int xfer_id;
+};
+
 struct k_msg {
 	/** Mailbox ID */
 	kmbox_t mailbox;
@@ -150,6 +171,7 @@ struct _k_sem_struct {
 struct _k_fifo_struct {
 	int Nelms;
 	int element_size;
+	void (*copy)(char *dst, const char *src, int size);
 	char *base;
 	char *end_point;
 	char *enqueue_point;
@@ -233,7 +255,11 @@ struct _k_mem_map_struct {
 	int Nelms;
 	int element_size;
 	char *base;
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+	atomic_t free_list;
+#else
 	char *free;
+#endif
 	struct k_args *waiters;
 	int num_used;
 	int high_watermark;
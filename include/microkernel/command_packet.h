@@ -41,6 +41,74 @@ extern "C" {
 
 typedef uint32_t cmdPkt_t[CMD_PKT_SIZE_IN_WORDS];
 
+/**
+ * @brief Prepare a command packet that gives a semaphore
+ *
+ * The packet can then be submitted with task_cmd_pkts_submit().
+ *
+ * @param pkt Command packet to prepare
+ * @param sema Semaphore to give
+ *
+ * @return N/A
+ */
+extern void task_cmd_pkt_sem_give(cmdPkt_t *pkt, ksem_t sema);
+
+/**
+ * @brief Prepare a command packet that adds an element to a FIFO
+ *
+ * The element is copied when the packet is processed, so @a data must remain
+ * valid until task_cmd_pkts_submit() returns. The request does not wait for
+ * room in the FIFO: use task_cmd_pkt_rcode_get() after the submission to
+ * know whether the element was added (RC_OK) or not (RC_FAIL).
+ *
+ * @param pkt Command packet to prepare
+ * @param queue FIFO to add the element to
+ * @param data Pointer to the element
+ *
+ * @return N/A
+ */
+extern void task_cmd_pkt_fifo_put(cmdPkt_t *pkt, kfifo_t queue, void *data);
+
+/**
+ * @brief Prepare a command packet that signals an event
+ *
+ * @param pkt Command packet to prepare
+ * @param event Event to signal
+ *
+ * @return N/A
+ */
+extern void task_cmd_pkt_event_send(cmdPkt_t *pkt, kevent_t event);
+
+/**
+ * @brief Submit a batch of command packets to the microkernel server
+ *
+ * All the packets are queued on the command stack before the server gets to
+ * run, so that it processes the whole batch, in array order, with a single
+ * context switch and a single rescheduling decision, instead of one of each
+ * per request. The routine returns once all the packets have been processed.
+ *
+ * Only packets prepared with the task_cmd_pkt_xxx() routines, which never
+ * make the task wait, can be submitted. A batch larger than the free room of
+ * the command stack, less CONFIG_COMMAND_STACK_RESERVE packets kept for ISRs
+ * and fibers, is submitted in several chunks, with one context switch per
+ * chunk.
+ *
+ * @param pkts Array of command packets
+ * @param num Number of command packets
+ *
+ * @return N/A
+ */
+extern void task_cmd_pkts_submit(cmdPkt_t *pkts, int num);
+
+/**
+ * @brief Get the return code of a processed command packet
+ *
+ * @param pkt Command packet submitted with task_cmd_pkts_submit()
+ *
+ * @return RC_OK or RC_FAIL, for the requests that report a return code
+ */
+extern int task_cmd_pkt_rcode_get(cmdPkt_t *pkt);
+
 #ifdef __cplusplus
 }
 #endif
@@ -44,13 +44,31 @@ extern "C" {
  */
 extern int _task_fifo_ioctl(kfifo_t queue, int op);
 
+/*
+ * Element copy routines: word-copy variants for 4, 8 and 16 byte elements,
+ * and a generic one for any other element size.
+ */
+extern void _k_fifo_copy(char *dst, const char *src, int size);
+extern void _k_fifo_copy_4(char *dst, const char *src, int size);
+extern void _k_fifo_copy_8(char *dst, const char *src, int size);
+extern void _k_fifo_copy_16(char *dst, const char *src, int size);
+
 /**
- * @brief Initializer for microkernel FIFO
+ * @brief Element copy routine specialized for FIFO element size
  */
-#define __K_FIFO_DEFAULT(depth, width, buffer) \
+#define __K_FIFO_COPY(width) \
+	((width) == 4 ? _k_fifo_copy_4 : \
+	 (width) == 8 ? _k_fifo_copy_8 : \
+	 (width) == 16 ? _k_fifo_copy_16 : _k_fifo_copy)
+
+/**
+ * @brief Initializer for microkernel FIFO with given element copy routine
+ */
+#define __K_FIFO_INIT(depth, width, buffer, copy_fn) \
 	{ \
 	  .Nelms = depth,\
 	  .element_size = width,\
+	  .copy = copy_fn,\
 	  .base = buffer,\
 	  .end_point = (buffer + (depth * width)),\
 	  .enqueue_point = buffer,\
@@ -61,6 +79,12 @@ extern int _task_fifo_ioctl(kfifo_t queue, int op);
 	  .count = 0,\
 	}
 
+/**
+ * @brief Initializer for microkernel FIFO
+ */
+#define __K_FIFO_DEFAULT(depth, width, buffer) \
+	__K_FIFO_INIT(depth, width, buffer, __K_FIFO_COPY(width))
+
 /**
  * @endcond
  */
@@ -137,7 +161,7 @@ extern int task_fifo_get(kfifo_t queue, void *data, int32_t timeout);
  * @param width Width of the FIFO.
  */
 #define DEFINE_FIFO(name, depth, width) \
-	static char __noinit __##name_buffer[(depth * width)]; \
+	static char __noinit __aligned(4) __##name_buffer[(depth * width)]; \
 	struct _k_fifo_struct _k_fifo_obj_##name = \
 	       __K_FIFO_DEFAULT(depth, width, __##name_buffer); \
 	const kfifo_t name = (kfifo_t)&_k_fifo_obj_##name;
@@ -154,6 +154,87 @@ extern int task_mbox_get(kmbox_t mbox, struct k_msg *M, int32_t timeout);
 extern int task_mbox_data_block_get(struct k_msg *M, struct k_block *block,
 					kmemory_pool_t pool_id, int32_t timeout);
 
+/**
+ * @brief Get a pointer to the data of a mailbox message fragment.
+ *
+ * @param frag Fragment.
+ */
+#define K_MBOX_FRAG_DATA(frag) ((void *)((struct k_mbox_frag *)(frag) + 1))
+
+/**
+ * @brief Allocate a mailbox message fragment, with time-limited waiting.
+ *
+ * The fragment descriptor and @a size bytes of data are allocated as a single
+ * block from memory pool @a pool_id. The fragment is not linked to any other
+ * fragment; use its @b next field to build a chain.
+ *
+ * @param frag Pointer to the allocated fragment.
+ * @param pool_id Memory pool name.
+ * @param size Number of data bytes in the fragment.
+ * @param timeout Determines the action to take when no block is available.
+ * For TICKS_NONE, return immediately.
+ * For TICKS_UNLIMITED, wait as long as necessary.
+ * Otherwise, wait up to the specified number of ticks before timing out.
+ *
+ * @retval RC_OK Successfully allocated fragment.
+ * @retval RC_TIME Timed out while waiting for a block.
+ * @retval RC_FAIL Failed to immediately allocate fragment when
+ * @a timeout = TICKS_NONE.
+ * @sa TICKS_NONE, TICKS_UNLIMITED
+ */
+extern int task_mbox_frag_alloc(struct k_mbox_frag **frag,
+				kmemory_pool_t pool_id, int size,
+				int32_t timeout);
+
+/**
+ * @brief Free a chain of mailbox message fragments.
+ *
+ * @param frags First fragment of the chain.
+ *
+ * @return N/A
+ */
+extern void task_mbox_frags_free(struct k_mbox_frag *frags);
+
+/**
+ * @brief Send a chain of fragments asynchronously to a mailbox.
+ *
+ * This routine works like @a task_mbox_block_put(), but the message data is
+ * the chain of fragments @a frags instead of a single block. The message size
+ * is the sum of the fragment sizes. Ownership of the fragments passes to the
+ * mailbox: they are either handed to the receiver without copying, or freed
+ * once their data has been delivered.
+ *
+ * @param mbox Mailbox to which to send message.
+ * @param prio Priority of data transfer.
+ * @param M Pointer to message to send.
+ * @param frags First fragment of the chain.
+ * @param sema Semaphore to signal when transfer is complete.
+ *
+ * @return N/A
+ */
+extern void task_mbox_frags_put(kmbox_t mbox, kpriority_t prio,
+				struct k_msg *M, struct k_mbox_frag *frags,
+				ksem_t sema);
+
+/**
+ * @brief Take over the fragment chain of a received message.
+ *
+ * Call this routine after a @a task_mbox_get() that did not supply a buffer
+ * for a message sent by @a task_mbox_frags_put(). The chain is handed to the
+ * receiving task without copying any data, and the message is deleted. The
+ * receiving task is responsible for freeing the chain, or it may pass the
+ * chain on to another mailbox with @a task_mbox_frags_put().
+ *
+ * @param M Message from which to get data.
+ * @param frags Pointer to the first fragment of the chain.
+ *
+ * @retval RC_OK Successfully took over the fragments.
+ * @retval RC_FAIL The message does not carry fragments, or its data has
+ * already been retrieved.
+ */
+extern int task_mbox_data_frags_get(struct k_msg *M,
+				    struct k_mbox_frag **frags);
+
 /**
  * @brief Define a private microkernel mailbox.
  *
@@ -102,6 +102,61 @@ extern int task_mem_map_used_get(kmemory_map_t map);
  */
 extern int task_mem_map_alloc(kmemory_map_t mmap, void **mptr, int32_t timeout);
 
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+/**
+ * @brief Allocate memory map block from an ISR.
+ *
+ * This routine allocates a block from memory map @a mmap without waiting,
+ * and saves the block's address in the area indicated by @a mptr. It does
+ * not involve the microkernel server.
+ *
+ * @param mmap Memory map name.
+ * @param mptr Pointer to memory block address area.
+ *
+ * @retval RC_OK Successfully allocated memory block.
+ * @retval RC_FAIL No memory block is available.
+ */
+extern int isr_mem_map_alloc(kmemory_map_t mmap, void **mptr);
+
+/**
+ * @brief Allocate memory map block from a fiber.
+ *
+ * Like isr_mem_map_alloc(), but called from a fiber.
+ *
+ * @param mmap Memory map name.
+ * @param mptr Pointer to memory block address area.
+ *
+ * @retval RC_OK Successfully allocated memory block.
+ * @retval RC_FAIL No memory block is available.
+ */
+extern int fiber_mem_map_alloc(kmemory_map_t mmap, void **mptr);
+
+/**
+ * @brief Return memory map block from an ISR.
+ *
+ * This routine returns a block to the specified memory map. If a task is
+ * waiting for a block, the microkernel server is asked to give it one.
+ *
+ * @param mmap Memory map name.
+ * @param mptr Pointer to memory block address area.
+ *
+ * @return N/A
+ */
+extern void isr_mem_map_free(kmemory_map_t mmap, void **mptr);
+
+/**
+ * @brief Return memory map block from a fiber.
+ *
+ * Like isr_mem_map_free(), but called from a fiber.
+ *
+ * @param mmap Memory map name.
+ * @param mptr Pointer to memory block address area.
+ *
+ * @return N/A
+ */
+extern void fiber_mem_map_free(kmemory_map_t mmap, void **mptr);
+#endif
+
 /**
  * @brief Define a private microkernel memory map.
  *
@@ -133,6 +133,73 @@ extern int _task_pipe_block_put(kpipe_t id,
 			_task_pipe_block_put(id, block, size, sema)
 
 
+/**
+ * @brief Reserve space in a pipe for zero-copy writing.
+ *
+ * This routine reserves a contiguous area of the pipe buffer, which the
+ * caller fills in place and then hands to readers of the pipe by calling
+ * task_pipe_put_commit(). The routine does not wait for free space, and
+ * fails if other tasks already wait to write to the pipe.
+ *
+ * @param id Pipe ID.
+ * @param span Span descriptor, filled in with the area reserved.
+ * @param size Number of bytes to reserve.
+ * @param options Pipe options. With _ALL_N, exactly @a size bytes are
+ * reserved; otherwise, the area reserved may be smaller, e.g. when the
+ * free space wraps around the end of the pipe buffer.
+ *
+ * @retval RC_OK Successfully reserved space in the pipe.
+ * @retval RC_ALIGNMENT Size is improperly aligned.
+ * @retval RC_FAIL Failed to reserve space in the pipe.
+ */
+extern int task_pipe_put_reserve(kpipe_t id, struct k_pipe_span *span,
+				 int size, K_PIPE_OPTION options);
+
+/**
+ * @brief Commit data written to a reserved pipe span.
+ *
+ * This routine makes all the data in a span obtained from
+ * task_pipe_put_reserve() available to readers of the pipe.
+ *
+ * @param span Span descriptor.
+ *
+ * @return N/A
+ */
+extern void task_pipe_put_commit(struct k_pipe_span *span);
+
+/**
+ * @brief Peek at data in a pipe for zero-copy reading.
+ *
+ * This routine gives the caller access to a contiguous area of the pipe
+ * buffer holding the oldest data in the pipe. The data is consumed when
+ * the caller calls task_pipe_get_release(). The routine does not wait for
+ * data, and fails if other tasks already wait to read from the pipe.
+ *
+ * @param id Pipe ID.
+ * @param span Span descriptor, filled in with the area to read.
+ * @param size Number of bytes to read.
+ * @param options Pipe options. With _ALL_N, exactly @a size bytes are
+ * obtained; otherwise, the area obtained may be smaller.
+ *
+ * @retval RC_OK Successfully obtained data from the pipe.
+ * @retval RC_ALIGNMENT Size is improperly aligned.
+ * @retval RC_FAIL Failed to obtain data from the pipe.
+ */
+extern int task_pipe_get_peek(kpipe_t id, struct k_pipe_span *span,
+			      int size, K_PIPE_OPTION options);
+
+/**
+ * @brief Release data read from a pipe span.
+ *
+ * This routine returns the area of a span obtained from task_pipe_get_peek()
+ * to the pipe as free space.
+ *
+ * @param span Span descriptor.
+ *
+ * @return N/A
+ */
+extern void task_pipe_get_release(struct k_pipe_span *span);
+
 /**
  * @brief Define a private microkernel pipe.
  *
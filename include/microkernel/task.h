@@ -186,6 +186,21 @@ extern ktask_t task_id_get(void);
  */
 extern kpriority_t task_priority_get(void);
 
+#ifdef CONFIG_THREAD_CPU_ACCOUNTING
+/**
+ * @brief Gets the CPU time used by a task
+ *
+ * @param task Task
+ *
+ * @return number of hardware clock cycles the task has been running for
+ */
+static inline uint64_t task_cpu_cycles_get(ktask_t task)
+{
+	return sys_thread_cpu_cycles_get(
+		(nano_thread_id_t)((struct k_task *)task)->workspace);
+}
+#endif
+
 /**
  * @brief Start a task
  * @param t Task to start
@@ -37,6 +37,7 @@ extern "C" {
 struct event_logger {
 	struct nano_sem sync_sema;
 	struct ring_buf ring_buf;
+	atomic_t event_count; /* events logged, for batched collector wakeups */
 };
 
 /**
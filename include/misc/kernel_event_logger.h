@@ -191,6 +191,38 @@ void _sys_k_event_logger_enter_sleep(void);
 static inline void _sys_k_event_logger_enter_sleep(void) {};
 #endif
 
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_EXPORT
+
+/*
+ * Kernel event export stream
+ *
+ * The stream is a sequence of records, in the byte order of the target:
+ *
+ *	uint16_t event_id;	ID of the event
+ *	uint8_t dropped;	number of events dropped before this one
+ *	uint8_t size32;		number of 32-bit data words that follow
+ *	uint32_t data[size32];	data of the event
+ *
+ * The first record has the KERNEL_EVENT_LOGGER_EXPORT_HEADER_EVENT_ID ID,
+ * and four data words: KERNEL_EVENT_LOGGER_EXPORT_MAGIC, the stream format
+ * version, the number of ticks per second and the number of hardware cycles
+ * per tick. Event ID 0 is reserved for it.
+ */
+#define KERNEL_EVENT_LOGGER_EXPORT_HEADER_EVENT_ID              0x0000
+#define KERNEL_EVENT_LOGGER_EXPORT_MAGIC                        0x56454b5a
+#define KERNEL_EVENT_LOGGER_EXPORT_VERSION                      1
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_EXPORT_RAM
+/**
+ * RAM buffer holding the exported event stream, and number of bytes of the
+ * stream stored in it, for a debugger to dump.
+ */
+extern uint8_t sys_k_event_export_ram[];
+extern uint32_t sys_k_event_export_ram_used;
+#endif
+
+#endif /* CONFIG_KERNEL_EVENT_LOGGER_EXPORT */
+
 #endif /* _ASMLANGUAGE */
 
 #else /* !CONFIG_KERNEL_EVENT_LOGGER */
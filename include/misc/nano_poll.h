@@ -0,0 +1,162 @@
+/* nano_poll.h: nanokernel multi-object wait */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ *
+ * @brief Nanokernel multi-object wait
+ *
+ * A fiber can wait on several nanokernel semaphores, FIFOs, LIFOs and timers
+ * at once, and is woken up as soon as one of them becomes ready: a semaphore
+ * is given, data is put in a FIFO or a LIFO, or a timer expires. Polling does
+ * not take anything from the objects; the caller takes the semaphore or gets
+ * the data afterwards, without waiting.
+ *
+ * An object can be polled by only one fiber at a time.
+ */
+
+#ifndef _misc_nano_poll__h_
+#define _misc_nano_poll__h_
+
+#include <nanokernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Type of the object of a poll event
+ */
+enum nano_poll_type {
+	NANO_POLL_TYPE_SEM,	/* ready when the semaphore count is not 0 */
+	NANO_POLL_TYPE_FIFO,	/* ready when the FIFO is not empty */
+	NANO_POLL_TYPE_LIFO,	/* ready when the LIFO is not empty */
+	NANO_POLL_TYPE_TIMER,	/* ready from the timer expiry until tested */
+};
+
+/**
+ * @cond internal
+ */
+struct _nano_poller;
+/**
+ * @endcond
+ */
+
+/**
+ * @brief Poll event: an object to wait on
+ */
+struct nano_poll_event {
+	enum nano_poll_type type;
+	void *obj;
+	/* set while a fiber is waiting on the object */
+	struct _nano_poller *poller;
+};
+
+/**
+ * @brief Statically initialize a poll event
+ *
+ * @param event_type Type of the object, one of enum nano_poll_type
+ * @param event_obj Semaphore, FIFO, LIFO or timer
+ */
+#define NANO_POLL_EVENT_INITIALIZER(event_type, event_obj) \
+	{ \
+		.type = event_type, \
+		.obj = event_obj, \
+		.poller = NULL, \
+	}
+
+/**
+ * @brief Initialize a poll event
+ *
+ * @param event Poll event
+ * @param type Type of the object
+ * @param obj Semaphore, FIFO, LIFO or timer
+ *
+ * @return N/A
+ */
+static inline void nano_poll_event_init(struct nano_poll_event *event,
+					enum nano_poll_type type, void *obj)
+{
+	event->type = type;
+	event->obj = obj;
+	event->poller = NULL;
+}
+
+/**
+ * @brief Wait for one of several objects to become ready
+ *
+ * Returns the index of the first ready object in @a events. The object is
+ * left untouched: the caller takes it afterwards with TICKS_NONE, which fails
+ * if another thread took it first.
+ *
+ * Another thread can also take a signalled object before a waiting fiber
+ * runs. With TICKS_UNLIMITED, the fiber then waits again. With a finite
+ * timeout, it returns -EAGAIN, possibly before the timeout expired.
+ *
+ * This routine is a convenience wrapper for the execution context-specific
+ * APIs. It is helpful whenever the exact execution context is not known.
+ * Its use should be avoided when the context is known up-front, to avoid
+ * unnecessary overhead. An ISR can only use TICKS_NONE.
+ *
+ * @param events Array of poll events
+ * @param num_events Number of poll events
+ * @param timeout_in_ticks Affects the action taken should none of the
+ * objects be ready. If TICKS_NONE, then return immediately. If
+ * TICKS_UNLIMITED, then wait as long as necessary. Otherwise wait up to the
+ * specified number of ticks before timing out.
+ *
+ * @return index of a ready object, -EAGAIN if none is ready within the
+ * timeout or if a fiber lost a signalled object to another thread before a
+ * finite timeout, -EADDRINUSE if one of the objects is polled by another fiber
+ */
+extern int nano_poll(struct nano_poll_event *events, int num_events,
+		     int32_t timeout_in_ticks);
+
+/**
+ * @brief Wait for one of several objects to become ready, from an ISR
+ *
+ * @sa nano_poll
+ */
+extern int nano_isr_poll(struct nano_poll_event *events, int num_events,
+			 int32_t timeout_in_ticks);
+
+/**
+ * @brief Wait for one of several objects to become ready, from a fiber
+ *
+ * @sa nano_poll
+ */
+extern int nano_fiber_poll(struct nano_poll_event *events, int num_events,
+			   int32_t timeout_in_ticks);
+
+/**
+ * @brief Wait for one of several objects to become ready, from a task
+ *
+ * A task does not pend on the objects: it checks them each time it is woken
+ * up from idle, like the other nano_task_* routines, and can therefore poll
+ * objects that a fiber is polling.
+ *
+ * @sa nano_poll
+ */
+extern int nano_task_poll(struct nano_poll_event *events, int num_events,
+			  int32_t timeout_in_ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _misc_nano_poll__h_ */
@@ -0,0 +1,247 @@
+/* nano_work.h: nanokernel work queues */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ *
+ * @brief Nanokernel work queues
+ *
+ * A work queue is a fiber that runs the work items submitted to it, one at a
+ * time, in submission order. Work items can be submitted from any context;
+ * delayed work items are submitted when a nanokernel timeout expires.
+ */
+
+#ifndef _misc_nano_work__h_
+#define _misc_nano_work__h_
+
+#include <nanokernel.h>
+#include <atomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct nano_work;
+
+/**
+ * @brief Work item handler, run by the work queue fiber
+ */
+typedef void (*work_handler_t)(struct nano_work *work);
+
+/**
+ * @brief Work queue
+ */
+struct nano_workqueue {
+	struct nano_fifo fifo;
+};
+
+/**
+ * @cond internal
+ */
+enum {
+	NANO_WORK_STATE_PENDING,	/* work item must be run */
+	NANO_WORK_STATE_QUEUED,		/* work item is in a work queue fifo */
+};
+/**
+ * @endcond
+ */
+
+/**
+ * @brief Work item
+ */
+struct nano_work {
+	/* used by the nano_fifo implementation */
+	void *_reserved;
+	work_handler_t handler;
+	atomic_t flags[1];
+};
+
+/**
+ * @brief Start a work queue fiber
+ *
+ * @param wq Work queue
+ * @param stack Stack of the work queue fiber
+ * @param stack_size Stack size in bytes
+ * @param prio Priority of the work queue fiber
+ *
+ * @return N/A
+ */
+extern void nano_workqueue_start(struct nano_workqueue *wq, char *stack,
+				 unsigned stack_size, unsigned prio);
+
+/**
+ * @brief Initialize a work item
+ *
+ * @param work Work item
+ * @param handler Handler to run when the work item is processed
+ *
+ * @return N/A
+ */
+static inline void nano_work_init(struct nano_work *work,
+				  work_handler_t handler)
+{
+	atomic_clear(work->flags);
+	work->handler = handler;
+}
+
+/**
+ * @brief Submit a work item to a work queue
+ *
+ * Can be called from any context. Submitting a work item that is already
+ * pending has no effect: it runs only once. A work item may resubmit itself
+ * from its handler.
+ *
+ * @param wq Work queue
+ * @param work Work item
+ *
+ * @return N/A
+ */
+static inline void nano_work_submit_to_queue(struct nano_workqueue *wq,
+					     struct nano_work *work)
+{
+	atomic_set_bit(work->flags, NANO_WORK_STATE_PENDING);
+
+	if (!atomic_test_and_set_bit(work->flags, NANO_WORK_STATE_QUEUED)) {
+		nano_fifo_put(&wq->fifo, work);
+	}
+}
+
+/**
+ * @brief Tell if a work item is pending
+ *
+ * @param work Work item
+ *
+ * @return non-zero if the work item is submitted and has not run yet
+ */
+static inline int nano_work_pending(struct nano_work *work)
+{
+	return atomic_test_bit(work->flags, NANO_WORK_STATE_PENDING);
+}
+
+/**
+ * @brief Cancel a pending work item
+ *
+ * The handler of a cancelled work item does not run, unless the work item is
+ * submitted again. A handler that is already running is not interrupted.
+ *
+ * @param work Work item
+ *
+ * @return 0 if cancelled, -EINVAL if the work item was not pending
+ */
+extern int nano_work_cancel(struct nano_work *work);
+
+#if defined(CONFIG_NANO_TIMEOUTS)
+
+/**
+ * @brief Delayed work item
+ */
+struct nano_delayed_work {
+	struct nano_work work;
+	struct _nano_timeout timeout;
+	struct nano_workqueue *wq;
+};
+
+/**
+ * @brief Initialize a delayed work item
+ *
+ * @param work Delayed work item
+ * @param handler Handler to run when the work item is processed
+ *
+ * @return N/A
+ */
+extern void nano_delayed_work_init(struct nano_delayed_work *work,
+				   work_handler_t handler);
+
+/**
+ * @brief Submit a delayed work item to a work queue
+ *
+ * The work item is submitted to @a wq once @a ticks system clock ticks have
+ * elapsed, or immediately if @a ticks is 0. Submitting a delayed work item
+ * whose timeout has not expired yet reschedules it.
+ *
+ * Can be called from any context.
+ *
+ * @param wq Work queue
+ * @param work Delayed work item
+ * @param ticks Delay in system clock ticks
+ *
+ * @return 0 on success, -EADDRINUSE if the work item is scheduled or pending
+ * on another work queue
+ */
+extern int nano_delayed_work_submit_to_queue(struct nano_workqueue *wq,
+					     struct nano_delayed_work *work,
+					     int ticks);
+
+/**
+ * @brief Cancel a delayed work item
+ *
+ * Stops the timeout of the work item if it has not expired yet, and cancels
+ * the work item if it has been submitted but has not run yet.
+ *
+ * @param work Delayed work item
+ *
+ * @return 0 if cancelled, -EINVAL if the work item was neither scheduled nor
+ * pending
+ */
+extern int nano_delayed_work_cancel(struct nano_delayed_work *work);
+
+#endif /* CONFIG_NANO_TIMEOUTS */
+
+#if defined(CONFIG_SYSTEM_WORKQUEUE)
+
+/**
+ * @brief System work queue, started at boot
+ */
+extern struct nano_workqueue sys_workqueue;
+
+/**
+ * @brief Submit a work item to the system work queue
+ *
+ * @param work Work item
+ *
+ * @return N/A
+ */
+static inline void nano_work_submit(struct nano_work *work)
+{
+	nano_work_submit_to_queue(&sys_workqueue, work);
+}
+
+#if defined(CONFIG_NANO_TIMEOUTS)
+/**
+ * @brief Submit a delayed work item to the system work queue
+ *
+ * @param work Delayed work item
+ * @param ticks Delay in system clock ticks
+ *
+ * @return 0 on success, -EADDRINUSE if the work item is scheduled or pending
+ * on another work queue
+ */
+static inline int nano_delayed_work_submit(struct nano_delayed_work *work,
+					   int ticks)
+{
+	return nano_delayed_work_submit_to_queue(&sys_workqueue, work, ticks);
+}
+#endif /* CONFIG_NANO_TIMEOUTS */
+
+#endif /* CONFIG_SYSTEM_WORKQUEUE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _misc_nano_work__h_ */
@@ -23,6 +23,7 @@
 #include <nanokernel.h>
 #include <misc/debug/object_tracing_common.h>
 #include <misc/util.h>
+#include <atomic.h>
 #include <errno.h>
 
 #ifdef __cplusplus
@@ -50,6 +51,10 @@ struct ring_buf {
 	uint32_t size;   /**< Size of buf in 32-bit chunks */
 	uint32_t *buf;	 /**< Memory region for stored entries */
 	uint32_t mask;   /**< Modulo mask if size is a power of 2 */
+#ifdef CONFIG_RING_BUFFER_LOCK_FREE
+	atomic_t reserve; /**< Index in buf past the last reserved element */
+	atomic_t nesting; /**< Number of lock-free puts in progress */
+#endif
 #ifdef CONFIG_DEBUG_TRACING_KERNEL_OBJECTS
 	struct ring_buf *__next;
 #endif
@@ -106,6 +111,10 @@ static inline void sys_ring_buf_init(struct ring_buf *buf, uint32_t size,
 	buf->head = 0;
 	buf->tail = 0;
 	buf->dropped_put_count = 0;
+#ifdef CONFIG_RING_BUFFER_LOCK_FREE
+	buf->reserve = 0;
+	buf->nesting = 0;
+#endif
 	buf->size = size;
 	buf->buf = data;
 	if (is_power_of_two(size)) {
@@ -166,6 +175,32 @@ static inline int sys_ring_buf_space_get(struct ring_buf *buf)
 int sys_ring_buf_put(struct ring_buf *buf, uint16_t type, uint8_t value,
 		     uint32_t *data, uint8_t size32);
 
+#ifdef CONFIG_RING_BUFFER_LOCK_FREE
+/**
+ * @brief Place an entry into the ring buffer without locking
+ *
+ * Unlike sys_ring_buf_put(), this routine can be called concurrently by
+ * producers running in different contexts (tasks, fibers and ISRs) without
+ * locking interrupts. A producer first reserves room for the entry by
+ * atomically advancing a reservation index, then writes the entry. The tail
+ * index, which the consumer reads, is only advanced by the outermost
+ * producer, once every reserved entry is written: a producer that interrupts
+ * or preempts another one always completes before it resumes on a single CPU.
+ *
+ * All producers of a given ring buffer must use this routine; the consumer
+ * uses sys_ring_buf_get() as usual.
+ *
+ * @param buf Ring buffer to insert data to
+ * @param type Application-specific type identifier
+ * @param value Integral data to include, application specific
+ * @param data Pointer to a buffer containing data to enqueue
+ * @param size32 Size of data buffer, in 32-bit chunks (not bytes)
+ * @return 0 on success, -EMSGSIZE if there isn't sufficient space
+ */
+int sys_ring_buf_put_lock_free(struct ring_buf *buf, uint16_t type,
+			       uint8_t value, uint32_t *data, uint8_t size32);
+#endif
+
 /**
  * @brief Fetch data from the ring buffer
  *
@@ -55,16 +55,38 @@ struct tcs;
 struct _nano_queue {
 	void *head;
 	void *tail;
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+	/* when used as a wait queue, non-zero if ordered by fiber priority */
+	int prio_order;
+#endif
 };
 
 #include <misc/dlist.h>
 
+struct _timeout_wheel_node {
+	sys_dnode_t node;
+	uint32_t expiry;
+};
+
+struct _nano_timeout;
+typedef void (*_nano_timeout_func_t)(struct _nano_timeout *t);
+
 struct _nano_timeout {
+#ifdef CONFIG_TIMEOUT_WHEEL
+	struct _timeout_wheel_node node;
+#else
 	sys_dlist_t node;
+#endif
 	struct tcs *tcs;
 	struct _nano_queue *wait_q;
+	/* with the timing wheel, only tells if the timeout is queued (!= -1) */
 	int32_t delta_ticks_from_prev;
+	/* if not NULL, called from the tick handler when the timeout expires */
+	_nano_timeout_func_t func;
 };
+
+/* see misc/nano_poll.h */
+struct nano_poll_event;
 /**
  * @endcond
  */
@@ -135,6 +157,48 @@ extern int _is_thread_essential(nano_thread_id_t pCtx);
  */
 extern void sys_thread_busy_wait(uint32_t usec_to_wait);
 
+#ifdef CONFIG_THREAD_CPU_ACCOUNTING
+/**
+ *
+ * @brief Return the CPU time used by a thread.
+ *
+ * This routine returns the number of hardware clock cycles a task or fiber
+ * has been running for, including the time spent servicing the interrupts
+ * which preempted it.
+ *
+ * @param thread ID of the thread.
+ *
+ * @return Number of hardware clock cycles used by the thread.
+ */
+extern uint64_t sys_thread_cpu_cycles_get(nano_thread_id_t thread);
+
+#ifdef CONFIG_THREAD_MONITOR
+/**
+ * @brief CPU time used by a thread, see sys_thread_cpu_usage_get().
+ */
+struct sys_thread_cpu_usage {
+	nano_thread_id_t thread;
+	uint64_t cycles;
+};
+
+/**
+ *
+ * @brief Return the CPU time used by each thread.
+ *
+ * This routine takes a snapshot of the CPU time used by every task and
+ * fiber, as returned by sys_thread_cpu_cycles_get().
+ *
+ * @param usage Array receiving the CPU time used by each thread.
+ * @param max Number of entries of the array.
+ *
+ * @return Number of threads, which may be larger than @a max: only the first
+ * @a max threads are then reported.
+ */
+extern int sys_thread_cpu_usage_get(struct sys_thread_cpu_usage *usage,
+				    int max);
+#endif /* CONFIG_THREAD_MONITOR */
+#endif /* CONFIG_THREAD_CPU_ACCOUNTING */
+
 /**
  * @}
  */
@@ -214,6 +278,24 @@ extern nano_thread_id_t fiber_fiber_start(char *pStack, unsigned int stackSize,
  */
 extern void fiber_yield(void);
 
+#ifdef CONFIG_NANO_TIMESLICING
+/**
+ * @brief Set the time slice of the fibers.
+ *
+ * Once a fiber of priority @a prio or lower has run for @a ticks system
+ * clock ticks, it is preempted by the tick interrupt if another fiber of the
+ * same or higher priority is runnable, as if it had called fiber_yield().
+ * The ticks a fiber runs for are accounted across its runs until its time
+ * slice expires.
+ *
+ * @param ticks Time slice size in ticks, 0 to disable time slicing.
+ * @param prio Highest priority of the fibers subject to time slicing.
+ *
+ * @return N/A
+ */
+extern void sys_fiber_time_slice_set(int32_t ticks, int prio);
+#endif
+
 
 /**
  * @brief Abort the currently executing fiber.
@@ -410,6 +492,9 @@ struct nano_fifo {
 		struct _nano_queue data_q;
 	};
 	int stat;
+#ifdef CONFIG_NANO_POLL
+	struct nano_poll_event *poll_event;
+#endif
 #ifdef CONFIG_DEBUG_TRACING_KERNEL_OBJECTS
 	struct nano_fifo *__next;
 #endif
@@ -440,6 +525,25 @@ struct nano_fifo {
  * @return N/A
  */
 extern void nano_fifo_init(struct nano_fifo *fifo);
+
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+/**
+ * @brief Wake up the fibers waiting on a FIFO in priority order.
+ *
+ * By default, fibers waiting on a FIFO are woken up in the order they
+ * started waiting. After this call, the highest priority fiber is woken up
+ * first, fibers of the same priority still being woken up in the order they
+ * started waiting.
+ *
+ * It must be called after nano_fifo_init(), before any fiber waits on the
+ * FIFO.
+ *
+ * @param fifo FIFO to configure.
+ *
+ * @return N/A
+ */
+extern void nano_fifo_wait_prio_set(struct nano_fifo *fifo);
+#endif
 /* execution context-independent methods (when context is not known) */
 
 /**
@@ -621,6 +725,9 @@ extern void *nano_task_fifo_get(struct nano_fifo *fifo,
 struct nano_lifo {
 	struct _nano_queue wait_q;
 	void *list;
+#ifdef CONFIG_NANO_POLL
+	struct nano_poll_event *poll_event;
+#endif
 #ifdef CONFIG_DEBUG_TRACING_KERNEL_OBJECTS
 	struct nano_lifo *__next;
 #endif
@@ -640,6 +747,25 @@ struct nano_lifo {
  */
 extern void nano_lifo_init(struct nano_lifo *lifo);
 
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+/**
+ * @brief Wake up the fibers waiting on a LIFO in priority order.
+ *
+ * By default, fibers waiting on a LIFO are woken up in the order they
+ * started waiting. After this call, the highest priority fiber is woken up
+ * first, fibers of the same priority still being woken up in the order they
+ * started waiting.
+ *
+ * It must be called after nano_lifo_init(), before any fiber waits on the
+ * LIFO.
+ *
+ * @param lifo LIFO to configure.
+ *
+ * @return N/A
+ */
+extern void nano_lifo_wait_prio_set(struct nano_lifo *lifo);
+#endif
+
 /**
  * @brief Prepend an element to a LIFO.
  *
@@ -808,6 +934,9 @@ extern void *nano_task_lifo_get(struct nano_lifo *lifo,
 struct nano_sem {
 	struct _nano_queue wait_q;
 	int nsig;
+#ifdef CONFIG_NANO_POLL
+	struct nano_poll_event *poll_event;
+#endif
 #ifdef CONFIG_DEBUG_TRACING_KERNEL_OBJECTS
 	struct nano_sem *__next;
 #endif
@@ -828,6 +957,25 @@ struct nano_sem {
  */
 extern void nano_sem_init(struct nano_sem *sem);
 
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+/**
+ * @brief Wake up the fibers waiting on a semaphore in priority order.
+ *
+ * By default, fibers waiting on a semaphore are woken up in the order they
+ * started waiting. After this call, the highest priority fiber is woken up
+ * first, fibers of the same priority still being woken up in the order they
+ * started waiting.
+ *
+ * It must be called after nano_sem_init(), before any fiber waits on the
+ * semaphore.
+ *
+ * @param sem Pointer to a nano_sem structure.
+ *
+ * @return N/A
+ */
+extern void nano_sem_wait_prio_set(struct nano_sem *sem);
+#endif
+
 /* execution context-independent methods (when context is not known) */
 
 /**
@@ -1198,6 +1346,11 @@ struct nano_timer {
 	 * has to return NULL
 	 */
 	void *user_data_backup;
+#ifdef CONFIG_NANO_POLL
+	struct nano_poll_event *poll_event;
+	/* expired, and not tested since it was started */
+	int expired;
+#endif
 #ifdef CONFIG_DEBUG_TRACING_KERNEL_OBJECTS
 	struct nano_timer *__next;
 #endif
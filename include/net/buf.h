@@ -37,6 +37,14 @@ struct net_buf {
 	/** FIFO uses first 4 bytes itself, reserve space */
 	int _unused;
 
+	/** Fragments associated with this buffer. */
+	struct net_buf *frags;
+
+	/** Buffer whose data storage is shared by this clone, NULL if
+	 *  the buffer uses its own storage.
+	 */
+	struct net_buf *shared;
+
 	/** Size of the user data associated with this buffer. */
 	const uint16_t user_data_size;
 
@@ -131,10 +139,25 @@ struct net_buf {
  */
 struct net_buf *net_buf_get(struct nano_fifo *fifo, size_t reserve_head);
 
+/** @brief Get a new buffer from the pool, waiting at most a given time.
+ *
+ *  Same as net_buf_get() but waits at most @a timeout ticks for a
+ *  buffer to become available. With TICKS_NONE the call never blocks.
+ *
+ *  @param fifo Which FIFO to take the buffer from.
+ *  @param reserve_head How much headroom to reserve.
+ *  @param timeout Ticks to wait, or TICKS_NONE or TICKS_UNLIMITED.
+ *
+ *  @return New buffer or NULL if out of buffers.
+ */
+struct net_buf *net_buf_get_timeout(struct nano_fifo *fifo,
+				    size_t reserve_head, int32_t timeout);
+
 /** @brief Decrements the reference count of a buffer.
  *
  *  Decrements the reference count of a buffer and puts it back into the
- *  pool if the count reaches zero.
+ *  pool if the count reaches zero. The fragments of the buffer are
+ *  released with it.
  *
  *  @param buf Buffer.
  */
@@ -151,6 +174,13 @@ struct net_buf *net_buf_ref(struct net_buf *buf);
 /** @brief Duplicate buffer
  *
  *  Duplicate given buffer including any data and headers currently stored.
+ *  The data is not copied: the clone refers to the storage of the original
+ *  buffer, which is kept until the clone is released. Adding data to the
+ *  clone or pushing headers to it first gives it a private copy of the
+ *  data, see net_buf_unshare().
+ *
+ *  The data of the original buffer must not be modified as long as the
+ *  clone uses it, including the data pulled from it after the cloning.
  *
  *  @param buf Buffer.
  *
@@ -158,6 +188,85 @@ struct net_buf *net_buf_ref(struct net_buf *buf);
  */
 struct net_buf *net_buf_clone(struct net_buf *buf);
 
+/** @brief Duplicate buffer using a buffer of another pool
+ *
+ *  Same as net_buf_clone(), but the clone is taken from the given FIFO
+ *  instead of the pool of the original buffer. Since the data is not
+ *  copied, the buffers of that pool may have no data storage of their
+ *  own, in which case the clone must not be modified.
+ *
+ *  @param fifo Which FIFO to take the clone from.
+ *  @param buf Buffer.
+ *
+ *  @return Cloned buffer or NULL if out of buffers.
+ */
+struct net_buf *net_buf_clone_get(struct nano_fifo *fifo, struct net_buf *buf);
+
+/** @brief Give a buffer a private copy of its data
+ *
+ *  Copy the data of a clone made with net_buf_clone() to its own storage
+ *  and release the storage of the original buffer. Does nothing if the
+ *  buffer uses its own storage already.
+ *
+ *  @param buf Buffer.
+ */
+void net_buf_unshare(struct net_buf *buf);
+
+/** @brief Find the last fragment in the fragment list.
+ *
+ *  @param frags Buffer or fragment list.
+ *
+ *  @return Pointer to last fragment in the list.
+ */
+struct net_buf *net_buf_frag_last(struct net_buf *frags);
+
+/** @brief Insert a new fragment to a chain of bufs.
+ *
+ *  Insert a new fragment into the buffer fragments list after the parent.
+ *  The reference of the caller to the fragment is handed over to the
+ *  parent.
+ *
+ *  @param parent Parent buffer/fragment.
+ *  @param frag Fragment to insert, may itself have fragments.
+ */
+void net_buf_frag_insert(struct net_buf *parent, struct net_buf *frag);
+
+/** @brief Add a new fragment to the end of a chain of bufs.
+ *
+ *  Append a new fragment into the buffer fragments list. The reference
+ *  of the caller to the fragment is handed over to the chain.
+ *
+ *  @param head Head of the fragment chain, may be NULL.
+ *  @param frag Fragment to add.
+ *
+ *  @return The head of the chain, @a frag if @a head was NULL.
+ */
+struct net_buf *net_buf_frag_add(struct net_buf *head, struct net_buf *frag);
+
+/** @brief Delete existing fragment from a chain of bufs.
+ *
+ *  Remove the fragment following the parent, or the head of the chain
+ *  if the parent is NULL, and release it.
+ *
+ *  @param parent Parent buffer/fragment, or NULL if there is no parent.
+ *  @param frag Fragment to delete.
+ *
+ *  @return Pointer to the buffer following the fragment, or NULL if it
+ *  had no further fragments.
+ */
+struct net_buf *net_buf_frag_del(struct net_buf *parent, struct net_buf *frag);
+
+/** @brief Calculate amount of bytes stored in fragments.
+ *
+ *  Calculates the total amount of data stored in the given buffer and the
+ *  fragments linked to it.
+ *
+ *  @param buf Buffer to start off with.
+ *
+ *  @return Number of bytes in the buffer and its fragments.
+ */
+size_t net_buf_frags_len(struct net_buf *buf);
+
 /** Get a pointer to the user data of a buffer.
  *
  *  @param buf  The buffer in question.
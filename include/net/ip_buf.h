@@ -231,6 +231,19 @@ struct ip_buf {
  */
 #define NET_BUF_UDP(buf)  ((struct uip_udp_hdr *)&uip_buf(buf)[UIP_LLIPH_LEN])
 
+/** NET_BUF_TCP
+ *
+ * @brief This macro returns TCP header information struct stored in net_buf.
+ *
+ * @details The macro returns pointer to uip_tcp_hdr struct which
+ * contains TCP header information.
+ *
+ * @param buf Network buffer.
+ *
+ * @return Pointer to uip_tcp_hdr.
+ */
+#define NET_BUF_TCP(buf)  ((struct uip_tcp_hdr *)&uip_buf(buf)[UIP_LLIPH_LEN])
+
 /**
  * @brief Get buffer from the available buffers pool.
  *
@@ -283,6 +296,28 @@ struct net_buf *ip_buf_get_reserve_rx(uint16_t reserve_head);
 struct net_buf *ip_buf_get_reserve_tx(uint16_t reserve_head);
 #endif
 
+/**
+ * @brief Get TX buffer from pool without waiting, and reserve headroom
+ * for potential headers.
+ *
+ * @details Same as ip_buf_get_reserve_tx() but returns NULL instead of
+ * waiting when the pool is empty. Used by the IP stack fibers, which
+ * must not block on buffers they are themselves releasing.
+ *
+ * @param reserve_head How many bytes to reserve for headroom.
+ *
+ * @return Network buffer if successful, NULL otherwise.
+ */
+#ifdef DEBUG_IP_BUFS
+#define ip_buf_get_reserve_tx_nowait(res)				\
+	ip_buf_get_reserve_tx_nowait_debug(res, __func__, __LINE__)
+struct net_buf *ip_buf_get_reserve_tx_nowait_debug(uint16_t reserve_head,
+						   const char *caller,
+						   int line);
+#else
+struct net_buf *ip_buf_get_reserve_tx_nowait(uint16_t reserve_head);
+#endif
+
 /**
  * @brief Place buffer back into the available buffers pool.
  *
@@ -39,7 +39,13 @@ extern "C" {
  * 5-tuple (protocol, remote address, remote port, source
  * address and source port).
  *
- * @param ip_proto Protocol to use. Currently only UDP is supported.
+ * A TCP context with a remote port connects to the remote
+ * address and port, the data given to net_send() is sent once
+ * the connection is open. A TCP context without a remote port
+ * listens on the local port, see net_context_accept().
+ * TCP needs CONFIG_NETWORKING_WITH_TCP and IPv6.
+ *
+ * @param ip_proto Protocol to use, UDP or TCP.
  * @param remote_addr Remote IPv6/IPv4 address.
  * @param remote_port Remote UDP/TCP port.
  * @param local_addr Local IPv6/IPv4 address. If the local address is
@@ -72,6 +78,8 @@ struct net_tuple *net_context_get_tuple(struct net_context *context);
  *
  * @details Free the resources allocated for the context.
  * All network listeners tied to this context are removed.
+ * A TCP connection is closed after the data already given to
+ * net_send() has been sent, the data not yet read is discarded.
  *
  * @param context Network context.
  *
@@ -84,6 +92,8 @@ void net_context_put(struct net_context *context);
  * @details Send user specified data to network. This
  * requires that net_buf is tied to context. This means
  * that the net_buf was allocated using net_buf_get().
+ * On a TCP context the call waits until the connection has
+ * room for the data, and the data is delivered in order.
  *
  * @param buf Network buffer.
  *
@@ -108,11 +118,32 @@ int net_send(struct net_buf *buf);
  * with CONFIG_NANO_TIMEOUTS. If CONFIG_NANO_TIMEOUT is not
  * defined, then value > 0 means not to wait.
  *
+ * On a TCP context, the buffers return the received stream in
+ * order. Once the peer closed the connection and all the data
+ * has been read, NULL is returned without waiting.
+ *
  * @return Network buffer if successful, NULL otherwise.
  */
 struct net_buf *net_receive(struct net_context *context,
 			    int32_t timeout);
 
+#ifdef CONFIG_NETWORKING_WITH_TCP
+/**
+ * @brief Accept a TCP connection.
+ *
+ * @details Wait for a connection on a listening TCP context,
+ * that is a TCP context got without a remote port. The
+ * returned context is released with net_context_put().
+ *
+ * @param context Listening network context.
+ * @param timeout Timeout to wait, as with net_receive().
+ *
+ * @return Network context of the connection, NULL if none.
+ */
+struct net_context *net_context_accept(struct net_context *context,
+				       int32_t timeout);
+#endif
+
 /**
  * @brief Get the UDP connection pointer from net_context.
  *
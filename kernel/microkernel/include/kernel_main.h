@@ -278,6 +278,10 @@ extern void _k_pipe_get_timeout(struct k_args *Reader);
 extern void _k_pipe_get_reply(struct k_args *Reader);
 extern void _k_pipe_get_ack(struct k_args *Reader);
 extern void _k_pipe_movedata_ack(struct k_args *pEOXfer);
+extern void _k_pipe_put_reserve(struct k_args *A);
+extern void _k_pipe_put_commit(struct k_args *A);
+extern void _k_pipe_get_peek(struct k_args *A);
+extern void _k_pipe_get_release(struct k_args *A);
 extern void _k_event_test_timeout(struct k_args *A);
 
 #ifdef __cplusplus
@@ -23,6 +23,9 @@
 #include <micro_private_types.h>
 #include <kernel_main.h>
 #include <nano_private.h>
+#ifdef CONFIG_TIMEOUT_WHEEL
+#include <timeout_wheel.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -44,8 +47,8 @@ extern "C" {
 /* give the specified semaphore */
 #define KERNEL_CMD_SEMAPHORE_TYPE	(2u)
 
-/* not used */
-#define KERNEL_CMD_RESERVED_TYPE	(3u)
+/* hand freed blocks of the specified memory map to waiting tasks */
+#define KERNEL_CMD_MEM_MAP_TYPE		(3u)
 
 /* mask for isolating the 2 type bits */
 #define KERNEL_CMD_TYPE_MASK		(3u)
@@ -65,8 +68,12 @@ extern const kmemory_pool_t _heap_mem_pool_id;
 extern struct k_task *_k_current_task;
 extern uint32_t _k_task_priority_bitmap[];
 
+#ifdef CONFIG_TIMEOUT_WHEEL
+extern struct _timeout_wheel _k_timer_wheel;
+#else
 extern struct k_timer *_k_timer_list_head;
 extern struct k_timer *_k_timer_list_tail;
+#endif
 
 extern struct nano_stack _k_command_stack;
 extern struct nano_lifo _k_server_command_packet_free;
@@ -82,10 +89,12 @@ extern void _k_timeout_cancel(struct k_args *A);
 extern void _k_timer_list_update(int ticks);
 
 extern void _k_do_event_signal(kevent_t event);
+extern void _k_mem_map_waiters_get(struct _k_mem_map_struct *M);
 
 extern void _k_state_bit_set(struct k_task *, uint32_t);
 extern void _k_state_bit_reset(struct k_task *, uint32_t);
 extern void _k_task_call(struct k_args *);
+extern void _k_task_call_batch(struct k_args *cmd_packets, int num);
 
 /*
  * The task status flags may be OR'ed together to form a task's state.  The
@@ -37,6 +37,9 @@ struct k_timer {
 	int32_t duration;
 	int32_t period;
 	struct k_args *args;
+#ifdef CONFIG_TIMEOUT_WHEEL
+	struct _timeout_wheel_node node;
+#endif
 #ifdef CONFIG_DEBUG_TRACING_KERNEL_OBJECTS
 	/*List all user allocated timers*/
 	struct k_timer *__next;
@@ -127,6 +130,10 @@ struct k_timer {
 #define _K_SVC_PIPE_GET_REPLY				_k_pipe_get_reply
 #define _K_SVC_PIPE_GET_ACK				_k_pipe_get_ack
 #define _K_SVC_PIPE_MOVEDATA_ACK			_k_pipe_movedata_ack
+#define _K_SVC_PIPE_PUT_RESERVE				_k_pipe_put_reserve
+#define _K_SVC_PIPE_PUT_COMMIT				_k_pipe_put_commit
+#define _K_SVC_PIPE_GET_PEEK				_k_pipe_get_peek
+#define _K_SVC_PIPE_GET_RELEASE				_k_pipe_get_release
 
 /* Task queue header */
 
@@ -179,6 +186,14 @@ struct _pipe_req_arg {
 	int dummy;
 };
 
+struct _pipe_span_arg {
+	kpipe_t id;
+	unsigned char *data;
+	int size;
+	int xfer_id;      /* ID of the registered buffer Xfer */
+	K_PIPE_OPTION option;
+};
+
 struct _pipe_xfer_req_arg {
 	struct req_info req_info;
 	void *data_ptr; /* if NULL, data is embedded in cmd packet */
@@ -340,6 +355,7 @@ union k_args_args {
 	struct _pipe_xfer_ack_arg pipe_xfer_ack;
 	struct _pipe_req_arg pipe_req;
 	struct _pipe_ack_arg pipe_ack;
+	struct _pipe_span_arg pipe_span;
 };
 
 /*
@@ -380,6 +396,9 @@ struct k_args {
 struct block_stat {
 	char *mem_blocks;
 	uint32_t mem_status;
+#ifdef CONFIG_MEM_POOL_BUDDY
+	sys_dnode_t free_node;
+#endif
 };
 
 struct pool_block {
@@ -387,6 +406,9 @@ struct pool_block {
 	int nr_of_entries;
 	struct block_stat *blocktable;
 	int count;
+#ifdef CONFIG_MEM_POOL_BUDDY
+	sys_dlist_t free_list;
+#endif
 };
 
 struct pool_struct {
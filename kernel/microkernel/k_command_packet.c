@@ -24,6 +24,8 @@
 #include <microkernel/command_packet.h>
 #include <micro_private.h>
 #include <sections.h>
+#include <misc/__assert.h>
+#include <misc/util.h>
 
 /**
  * Generate build error by defining a negative-size array if the hard-coded
@@ -33,6 +35,14 @@
 uint32_t _k_test_cmd_pkt_size
 	[0 - ((CMD_PKT_SIZE_IN_WORDS * sizeof(uint32_t)) != sizeof(struct k_args))];
 
+/*
+ * Command stack entries a batch may fill: ISRs and fibers push onto the
+ * command stack without checking for room, so a batch leaves them a reserve.
+ */
+#define BATCH_RESERVE \
+	min(CONFIG_COMMAND_STACK_RESERVE, CONFIG_COMMAND_STACK_SIZE / 2)
+#define BATCH_ROOM (CONFIG_COMMAND_STACK_SIZE - BATCH_RESERVE)
+
 /**
  *
  * @brief Send command packet to be processed by _k_server
@@ -45,3 +55,87 @@ void _k_task_call(struct k_args *cmd_packet)
 	_k_current_task->args = cmd_packet;
 	nano_task_stack_push(&_k_command_stack, (uint32_t)cmd_packet);
 }
+
+/**
+ *
+ * @brief Send a batch of command packets to be processed by _k_server
+ *
+ * The command stack is LIFO, so the packets are pushed in reverse order,
+ * except for the first one which is handed over directly to the server if it
+ * is waiting for work. The server only gets to run once all the packets have
+ * been queued, and processes them all before selecting the next task.
+ *
+ * A batch larger than the free room of the command stack, less the room
+ * reserved for ISRs and fibers, is sent in chunks that fit, the server
+ * processing each chunk before the next one is queued. If the command stack is
+ * full and no server can empty it, the packets left fail with RC_FAIL.
+ *
+ * @param cmd_packets Array of command packets
+ * @param num Number of command packets
+ * @return N/A
+ */
+void _k_task_call_batch(struct k_args *cmd_packets, int num)
+{
+	struct nano_stack *stack = &_k_command_stack;
+	unsigned int imask;
+	int room;
+	int count;
+	int first;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		cmd_packets[i].alloc = false;
+	}
+
+	while (num > 0) {
+		imask = irq_lock();
+
+		first = 0;
+		if (stack->fiber) {
+			nano_isr_stack_push(stack, (uint32_t)&cmd_packets[0]);
+			first = 1;
+		}
+
+		/* queue as many packets as the room left above the reserve */
+		room = BATCH_ROOM - (stack->next - stack->base);
+		count = first + max(room, 0);
+		if (count > num) {
+			count = num;
+		}
+
+		if (count == 0 && !_nanokernel.fiber) {
+			irq_unlock(imask);
+			__ASSERT(0, "No server to empty the command stack");
+			for (i = 0; i < num; i++) {
+				cmd_packets[i].Time.rcode = RC_FAIL;
+			}
+			return;
+		}
+
+		for (i = count - 1; i >= first; i--) {
+			nano_isr_stack_push(stack, (uint32_t)&cmd_packets[i]);
+		}
+		if (count > 0) {
+			_k_current_task->args = &cmd_packets[count - 1];
+		}
+
+		cmd_packets += count;
+		num -= count;
+
+		if (_nanokernel.fiber) {
+			_Swap(imask);
+		} else {
+			irq_unlock(imask);
+		}
+	}
+}
+
+void task_cmd_pkts_submit(cmdPkt_t *pkts, int num)
+{
+	_k_task_call_batch((struct k_args *)pkts, num);
+}
+
+int task_cmd_pkt_rcode_get(cmdPkt_t *pkt)
+{
+	return ((struct k_args *)pkt)->Time.rcode;
+}
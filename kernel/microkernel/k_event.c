@@ -20,6 +20,7 @@
 */
 
 #include <micro_private.h>
+#include <microkernel/command_packet.h>
 #include "microkernel/event.h"
 #include <toolchain.h>
 #include <sections.h>
@@ -200,6 +201,16 @@ void _k_event_signal(struct k_args *A)
 	A->Time.rcode = RC_OK;
 }
 
+void task_cmd_pkt_event_send(cmdPkt_t *pkt, kevent_t event)
+{
+	struct k_args *A = (struct k_args *)pkt;
+
+	ASSERT_EVENT_IS_VALID(event, __func__);
+
+	A->Comm = _K_SVC_EVENT_SIGNAL;
+	A->args.e1.event = event;
+}
+
 int task_event_send(kevent_t event)
 {
 	struct k_args A;
@@ -26,10 +26,80 @@
 
 
 #include <micro_private.h>
+#include <microkernel/command_packet.h>
 #include <string.h>
 #include <toolchain.h>
 #include <sections.h>
 
+/*
+ * FIFO buffers are word aligned, so the word-copy routines only fall back to
+ * memcpy() when the caller's data area is not.
+ */
+#define FIFO_UNALIGNED(dst, src) ((((uint32_t)(dst)) | ((uint32_t)(src))) & 3)
+
+/**
+ *
+ * @brief Copy a FIFO element of any size
+ *
+ * @return N/A
+ */
+void _k_fifo_copy(char *dst, const char *src, int size)
+{
+	memcpy(dst, src, size);
+}
+
+/**
+ *
+ * @brief Copy a 4 byte FIFO element
+ *
+ * @return N/A
+ */
+void _k_fifo_copy_4(char *dst, const char *src, int size)
+{
+	if (unlikely(FIFO_UNALIGNED(dst, src))) {
+		memcpy(dst, src, size);
+		return;
+	}
+
+	*(uint32_t *)dst = *(const uint32_t *)src;
+}
+
+/**
+ *
+ * @brief Copy an 8 byte FIFO element
+ *
+ * @return N/A
+ */
+void _k_fifo_copy_8(char *dst, const char *src, int size)
+{
+	if (unlikely(FIFO_UNALIGNED(dst, src))) {
+		memcpy(dst, src, size);
+		return;
+	}
+
+	((uint32_t *)dst)[0] = ((const uint32_t *)src)[0];
+	((uint32_t *)dst)[1] = ((const uint32_t *)src)[1];
+}
+
+/**
+ *
+ * @brief Copy a 16 byte FIFO element
+ *
+ * @return N/A
+ */
+void _k_fifo_copy_16(char *dst, const char *src, int size)
+{
+	if (unlikely(FIFO_UNALIGNED(dst, src))) {
+		memcpy(dst, src, size);
+		return;
+	}
+
+	((uint32_t *)dst)[0] = ((const uint32_t *)src)[0];
+	((uint32_t *)dst)[1] = ((const uint32_t *)src)[1];
+	((uint32_t *)dst)[2] = ((const uint32_t *)src)[2];
+	((uint32_t *)dst)[3] = ((const uint32_t *)src)[3];
+}
+
 /**
  *
  * @brief Finish performing an incomplete FIFO enqueue request
@@ -92,7 +162,7 @@ void _k_fifo_enque_request(struct k_args *A)
 		if (W) {
 			Q->waiters = W->next;
 			p = W->args.q1.data;
-			memcpy(p, q, w);
+			Q->copy(p, q, w);
 
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 			if (W->Time.timer) {
@@ -108,7 +178,7 @@ void _k_fifo_enque_request(struct k_args *A)
 #endif
 		else {
 			p = Q->enqueue_point;
-			memcpy(p, q, w);
+			Q->copy(p, q, w);
 			p = (char *)((int)p + w);
 			if (p == Q->end_point)
 				Q->enqueue_point = Q->base;
@@ -145,9 +215,50 @@ void _k_fifo_enque_request(struct k_args *A)
 	}
 }
 
+void task_cmd_pkt_fifo_put(cmdPkt_t *pkt, kfifo_t queue, void *data)
+{
+	struct k_args *A = (struct k_args *)pkt;
+
+	A->Comm = _K_SVC_FIFO_ENQUE_REQUEST;
+	A->Time.ticks = TICKS_NONE;
+	A->args.q1.data = (char *)data;
+	A->args.q1.queue = queue;
+}
+
 int task_fifo_put(kfifo_t queue, void *data, int32_t timeout)
 {
 	struct k_args A;
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_fifo_struct *Q = (struct _k_fifo_struct *)queue;
+	unsigned int key = irq_lock();
+
+	/*
+	 * Enqueue directly if no task waits to dequeue: the microkernel
+	 * server cannot run while interrupts are locked.
+	 */
+	if (Q->num_used < Q->Nelms && Q->waiters == NULL) {
+		int w = OCTET_TO_SIZEOFUNIT(Q->element_size);
+		char *p = Q->enqueue_point;
+
+		Q->copy(p, data, w);
+		p += w;
+		Q->enqueue_point = (p == Q->end_point) ? Q->base : p;
+		Q->num_used++;
+#ifdef CONFIG_OBJECT_MONITOR
+		if (Q->high_watermark < Q->num_used)
+			Q->high_watermark = Q->num_used;
+		Q->count++;
+#endif
+		irq_unlock(key);
+		return RC_OK;
+	}
+
+	if (Q->num_used == Q->Nelms && timeout == TICKS_NONE) {
+		irq_unlock(key);
+		return RC_FAIL;
+	}
+	irq_unlock(key);
+#endif
 
 	A.Comm = _K_SVC_FIFO_ENQUE_REQUEST;
 	A.Time.ticks = timeout;
@@ -218,7 +329,7 @@ void _k_fifo_deque_request(struct k_args *A)
 	n = Q->num_used;
 	if (n) {
 		q = Q->dequeue_point;
-		memcpy(p, q, w);
+		Q->copy(p, q, w);
 		q = (char *)((int)q + w);
 		if (q == Q->end_point)
 			Q->dequeue_point = Q->base;
@@ -232,7 +343,7 @@ void _k_fifo_deque_request(struct k_args *A)
 			p = Q->enqueue_point;
 			q = W->args.q1.data;
 			w = OCTET_TO_SIZEOFUNIT(Q->element_size);
-			memcpy(p, q, w);
+			Q->copy(p, q, w);
 			p = (char *)((int)p + w);
 			if (p == Q->end_point)
 				Q->enqueue_point = Q->base;
@@ -279,6 +390,29 @@ void _k_fifo_deque_request(struct k_args *A)
 int task_fifo_get(kfifo_t queue, void *data, int32_t timeout)
 {
 	struct k_args A;
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_fifo_struct *Q = (struct _k_fifo_struct *)queue;
+	unsigned int key = irq_lock();
+
+	/* dequeue directly if no task waits to enqueue */
+	if (Q->num_used && Q->waiters == NULL) {
+		int w = OCTET_TO_SIZEOFUNIT(Q->element_size);
+		char *q = Q->dequeue_point;
+
+		Q->copy(data, q, w);
+		q += w;
+		Q->dequeue_point = (q == Q->end_point) ? Q->base : q;
+		Q->num_used--;
+		irq_unlock(key);
+		return RC_OK;
+	}
+
+	if (Q->num_used == 0 && timeout == TICKS_NONE) {
+		irq_unlock(key);
+		return RC_FAIL;
+	}
+	irq_unlock(key);
+#endif
 
 	A.Comm = _K_SVC_FIFO_DEQUE_REQUEST;
 	A.Time.ticks = timeout;
@@ -364,11 +364,15 @@ void _sys_power_save_idle_exit(int32_t ticks)
  */
 static inline int32_t _get_next_timer_expiry(void)
 {
+#ifdef CONFIG_TIMEOUT_WHEEL
+	uint32_t closest_deadline = _timeout_wheel_deadline(&_k_timer_wheel);
+#else
 	uint32_t closest_deadline = (uint32_t)TICKS_UNLIMITED;
 
 	if (_k_timer_list_head) {
 		closest_deadline = _k_timer_list_head->duration;
 	}
+#endif
 
 	return (int32_t)min(closest_deadline, _nano_get_earliest_deadline());
 }
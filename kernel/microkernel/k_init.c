@@ -84,6 +84,9 @@ void _main(void)
 	 * initialized at runtime.
 	 */
 	_k_init_dynamic();
+#ifdef CONFIG_TIMEOUT_WHEEL
+	_timeout_wheel_init(&_k_timer_wheel);
+#endif
 
 	task_fiber_start(_k_server_stack,
 			   CONFIG_MICROKERNEL_SERVER_STACK_SIZE,
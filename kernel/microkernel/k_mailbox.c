@@ -35,6 +35,19 @@
  */
 #define ISASYNCMSG(message) ((message)->tx_block.pool_id != 0)
 
+/*
+ * Pool ID used to mark an asynchronous message whose data is a chain of
+ * fragments rather than a single block. [tx_block.pointer_to_data] then
+ * points to the first struct k_mbox_frag of the chain.
+ */
+#define MBOX_FRAGS_POOL_ID ((kmemory_pool_t)(-2))
+
+/**
+ *
+ * @brief Determines if mailbox message carries a chain of fragments
+ */
+#define ISFRAGMSG(message) ((message)->tx_block.pool_id == MBOX_FRAGS_POOL_ID)
+
 /**
  *
  * @brief Copy a packet
@@ -154,8 +167,12 @@ static bool prepare_transfer(struct k_args *move,
 		move->args.moved_req.extra.setup.continuation_send = NULL;
 		move->args.moved_req.extra.setup.continuation_receive = NULL;
 
-		/* reader: */
-		if (reader->args.m1.mess.rx_data == NULL) {
+		/*
+		 * reader: a chain of fragments is never moved by the kernel;
+		 * it is handed over (or gathered) from the receiving task.
+		 */
+		if (reader->args.m1.mess.rx_data == NULL ||
+		    ISFRAGMSG(&(writer->args.m1.mess))) {
 			all_data_present = false;
 			__ASSERT_NO_MSG(0 == reader->args.m1.mess.extra
 					    .transfer); /* == extra.sema */
@@ -208,6 +225,33 @@ static void transfer(struct k_args *pMvdReq)
 	FREEARGS(pMvdReq);
 }
 
+/**
+ * @brief Release the blocks of a fragment chain from the kernel server
+ *
+ * @param frag First fragment of the chain
+ *
+ * @return N/A
+ */
+static void frags_release(struct k_mbox_frag *frag)
+{
+	struct k_mbox_frag *next;
+	struct k_args A;
+
+	A.alloc = false;
+	A.Comm = _K_SVC_MEM_POOL_BLOCK_RELEASE;
+
+	while (frag != NULL) {
+		/* the descriptor is gone once its block is released */
+		next = frag->next;
+		A.args.p1.pool_id = frag->block.pool_id;
+		A.args.p1.rep_poolptr = frag->block.address_in_pool;
+		A.args.p1.rep_dataptr = frag->block.pointer_to_data;
+		A.args.p1.req_size = frag->block.req_size;
+		_k_mem_pool_block_release(&A);
+		frag = next;
+	}
+}
+
 /**
  * @brief Process the acknowledgment to a mailbox send request
  *
@@ -233,6 +277,14 @@ void _k_mbox_send_ack(struct k_args *pCopyWriter)
 			_k_sem_signal(&A);
 		}
 
+		if (ISFRAGMSG(&(pCopyWriter->args.m1.mess))) {
+			/* the receiver did not take over the fragments */
+			frags_release(pCopyWriter->args.m1.mess.tx_block
+					      .pointer_to_data);
+			FREEARGS(pCopyWriter);
+			return;
+		}
+
 		/*
 		 * release the block from the memory pool
 		 * unless this an asynchronous transfer.
@@ -649,12 +701,92 @@ void _k_mbox_receive_request(struct k_args *Reader)
 }
 
 
+/**
+ * @brief Release the sender of an asynchronous message
+ *
+ * Called by the receiving task once it has taken over the data of an
+ * asynchronous message, so that the data is not released on SEND_ACK.
+ *
+ * @param M Received message
+ *
+ * @return N/A
+ */
+static void async_sender_release(struct k_msg *M)
+{
+	struct k_args *MoveD;
+	struct k_args *Writer;
+
+	/* This is the MOVED packet */
+	MoveD = M->extra.transfer;
+
+	/*
+	 * This is the first of the continuation packets for
+	 * continuation on send.  It should be the only one.
+	 * That is, it should not have any followers.  To
+	 * prevent [tx_block] from being released when the
+	 * SEND_ACK is processed, change its [pool_id] to -1.
+	 */
+
+	Writer = MoveD->args.moved_req.extra.setup.continuation_send;
+	__ASSERT_NO_MSG(Writer != NULL);
+	__ASSERT_NO_MSG(Writer->next == NULL);
+
+	Writer->args.m1.mess.tx_block.pool_id = (uint32_t)(-1);
+	nano_task_stack_push(&_k_command_stack, (uint32_t)Writer);
+
+#ifdef ACTIV_ASSERTS
+	struct k_args *dummy;
+
+	/*
+	 * Confirm that there are not any continuation packets
+	 * for continuation on receive.
+	 */
+
+	dummy = MoveD->args.moved_req.extra.setup.continuation_receive;
+	__ASSERT_NO_MSG(dummy == NULL);
+#endif
+
+	FREEARGS(MoveD); /* Clean up MOVED */
+	M->extra.transfer = NULL;
+}
+
+/**
+ * @brief Gather a fragment chain into the receiver's buffer
+ *
+ * Used when the receiver of a fragmented message asked for its data to be
+ * copied into a buffer.  The fragments are freed afterwards.
+ *
+ * @param M Received message, with [rx_data] set
+ *
+ * @return N/A
+ */
+static void frags_gather(struct k_msg *M)
+{
+	struct k_mbox_frag *frags = M->tx_block.pointer_to_data;
+	struct k_mbox_frag *frag;
+	char *dst = M->rx_data;
+	uint32_t left = M->size;
+	uint32_t n;
+
+	async_sender_release(M);
+
+	for (frag = frags; (frag != NULL) && (left != 0); frag = frag->next) {
+		n = min(frag->size, left);
+		memcpy(dst, K_MBOX_FRAG_DATA(frag), n);
+		dst += n;
+		left -= n;
+	}
+
+	task_mbox_frags_free(frags);
+}
+
 int task_mbox_get(kmbox_t mbox, struct k_msg *M, int32_t timeout)
 {
 	struct k_args A;
 
 	M->rx_task = _k_current_task->id;
 	M->mailbox = mbox;
+	M->tx_block.pool_id = 0; /* set by an asynchronous sender */
 	M->extra.transfer = 0;
 
 	/*
@@ -669,6 +801,12 @@ int task_mbox_get(kmbox_t mbox, struct k_msg *M, int32_t timeout)
 
 	KERNEL_ENTRY(&A);
 	*M = A.args.m1.mess;
+
+	if ((A.Time.rcode == RC_OK) && ISFRAGMSG(M) &&
+	    (M->rx_data != NULL) && (M->extra.transfer != NULL)) {
+		frags_gather(M);
+	}
+
 	return A.Time.rcode;
 }
 
@@ -682,7 +820,7 @@ void _task_mbox_block_put(kmbox_t mbox,
 
 	__ASSERT(0xFFFFFFFF != M->size, "Invalid mailbox data specification\n");
 
-	if (M->size == 0) {
+	if ((M->size == 0) && !ISFRAGMSG(M)) {
 		/*
 		 * trick: special value to indicate that tx_block
 		 * should NOT be released in the SND_ACK
@@ -762,6 +900,11 @@ void _task_mbox_data_get(struct k_msg *M)
 		return;
 	}
 
+	if (ISFRAGMSG(M)) {
+		frags_gather(M);
+		return;
+	}
+
 	A.args.m1.mess = *M;
 	A.Comm = _K_SVC_MBOX_RECEIVE_DATA;
 
@@ -773,7 +916,6 @@ int task_mbox_data_block_get(struct k_msg *M, struct k_block *block,
 			  kmemory_pool_t pool_id, int32_t timeout)
 {
 	int retval;
-	struct k_args *MoveD;
 
 	/* sanity checks: */
 	if (M->extra.transfer == NULL) {
@@ -788,46 +930,13 @@ int task_mbox_data_block_get(struct k_msg *M, struct k_block *block,
 
 	/* special flow to check for possible optimisations: */
 
-	if (ISASYNCMSG(M)) {
+	if (ISASYNCMSG(M) && !ISFRAGMSG(M)) {
 		/* First transfer block */
 		__ASSERT_NO_MSG(M->tx_block.pool_id != -1);
 		*block = M->tx_block;
 
-		/* This is the MOVED packet */
-		MoveD = M->extra.transfer;
-
 		/* Then release sender (writer) */
-
-		struct k_args *Writer;
-
-		/*
-		 * This is the first of the continuation packets for
-		 * continuation on send.  It should be the only one.
-		 * That is, it should not have any followers.  To
-		 * prevent [tx_block] from being released when the
-		 * SEND_ACK is processed, change its [pool_id] to -1.
-		 */
-
-		Writer = MoveD->args.moved_req.extra.setup.continuation_send;
-		__ASSERT_NO_MSG(Writer != NULL);
-		__ASSERT_NO_MSG(Writer->next == NULL);
-
-		Writer->args.m1.mess.tx_block.pool_id = (uint32_t)(-1);
-		nano_task_stack_push(&_k_command_stack, (uint32_t)Writer);
-
-#ifdef ACTIV_ASSERTS
-		struct k_args *dummy;
-
-		/*
-		 * Confirm that there are not any continuation packets
-		 * for continuation on receive.
-		 */
-
-		dummy = MoveD->args.moved_req.extra.setup.continuation_receive;
-		__ASSERT_NO_MSG(dummy == NULL);
-#endif
-
-		FREEARGS(MoveD); /* Clean up MOVED */
+		async_sender_release(M);
 
 		return RC_OK;
 	}
@@ -845,6 +954,12 @@ int task_mbox_data_block_get(struct k_msg *M, struct k_block *block,
 		block->pool_id = (kmemory_pool_t) -1;
 	}
 
+	if (ISFRAGMSG(M)) {
+		/* copy the fragments into the block */
+		frags_gather(M);
+		return RC_OK;
+	}
+
 	/*
 	 * Invoke task_mbox_data_get() core without sanity checks, as they have
 	 * already been performed.
@@ -896,3 +1011,71 @@ void _k_mbox_send_data(struct k_args *Starter)
 		transfer(MoveD); /* and MoveD will be cleared as well */
 	}
 }
+
+int task_mbox_frag_alloc(struct k_mbox_frag **frag, kmemory_pool_t pool_id,
+			 int size, int32_t timeout)
+{
+	struct k_block block;
+	int retval;
+
+	retval = task_mem_pool_alloc(&block, pool_id,
+				     sizeof(struct k_mbox_frag) + size, timeout);
+	if (retval != RC_OK) {
+		return retval;
+	}
+
+	*frag = block.pointer_to_data;
+	(*frag)->next = NULL;
+	(*frag)->block = block;
+	(*frag)->size = size;
+
+	return RC_OK;
+}
+
+void task_mbox_frags_free(struct k_mbox_frag *frags)
+{
+	struct k_mbox_frag *next;
+	struct k_block block;
+
+	while (frags != NULL) {
+		/* the descriptor is gone once its block is freed */
+		next = frags->next;
+		block = frags->block;
+		task_mem_pool_free(&block);
+		frags = next;
+	}
+}
+
+void task_mbox_frags_put(kmbox_t mbox, kpriority_t prio, struct k_msg *M,
+			 struct k_mbox_frag *frags, ksem_t sema)
+{
+	struct k_mbox_frag *frag;
+
+	__ASSERT(frags != NULL, "Invalid mailbox fragment chain\n");
+
+	M->size = 0;
+	for (frag = frags; frag != NULL; frag = frag->next) {
+		M->size += frag->size;
+	}
+
+	M->tx_block.pool_id = MBOX_FRAGS_POOL_ID;
+	M->tx_block.address_in_pool = frags;
+	M->tx_block.pointer_to_data = frags;
+	M->tx_block.req_size = 0;
+
+	_task_mbox_block_put(mbox, prio, M, sema);
+}
+
+int task_mbox_data_frags_get(struct k_msg *M, struct k_mbox_frag **frags)
+{
+	if ((M->extra.transfer == NULL) || !ISFRAGMSG(M)) {
+		return RC_FAIL;
+	}
+
+	*frags = M->tx_block.pointer_to_data;
+
+	/* the chain now belongs to the receiver: nothing is copied */
+	async_sender_release(M);
+
+	return RC_OK;
+}
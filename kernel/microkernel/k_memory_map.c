@@ -20,12 +20,108 @@
 
 #include <micro_private.h>
 #include <sections.h>
+#include <misc/__assert.h>
 
 #include <microkernel/memory_map.h>
 
 extern kmemory_map_t _k_mem_map_ptr_start[];
 extern kmemory_map_t _k_mem_map_ptr_end[];
 
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+
+/*
+ * The free list head holds the index (plus one) of the first free block in
+ * its low 16 bits, and a tag that changes on every update of the list in its
+ * high 16 bits. Each free block holds the index (plus one) of the next free
+ * block. The tag makes the compare-and-swap of a pop fail if the list was
+ * changed by an interrupt since the head was read, even if the same block
+ * was allocated and freed again in the meantime.
+ */
+#define MAP_INDEX_MASK 0xFFFF
+#define MAP_TAG_INCR 0x10000
+
+static inline atomic_val_t map_list_head(atomic_val_t head, uint32_t index)
+{
+	return ((head + MAP_TAG_INCR) & ~MAP_INDEX_MASK) | index;
+}
+
+/**
+ * @brief Take a block off the free list of a memory map
+ *
+ * @return block address, or NULL if the memory map is exhausted
+ */
+static char *map_block_get(struct _k_mem_map_struct *M)
+{
+	atomic_val_t head;
+	uint32_t next;
+	char *block;
+
+	do {
+		head = atomic_get(&M->free_list);
+		if ((head & MAP_INDEX_MASK) == 0) {
+			return NULL;
+		}
+		block = M->base + OCTET_TO_SIZEOFUNIT(
+			((head & MAP_INDEX_MASK) - 1) * M->element_size);
+		next = *(uint32_t *)block & MAP_INDEX_MASK;
+	} while (!atomic_cas(&M->free_list, head, map_list_head(head, next)));
+
+	atomic_inc(&M->num_used);
+#ifdef CONFIG_OBJECT_MONITOR
+	atomic_inc(&M->count);
+	if (M->high_watermark < M->num_used)
+		M->high_watermark = M->num_used;
+#endif
+	return block;
+}
+
+/**
+ * @brief Put a block on the free list of a memory map
+ */
+static void map_block_put(struct _k_mem_map_struct *M, char *block)
+{
+	atomic_val_t head;
+	uint32_t index;
+
+	index = (block - M->base) / OCTET_TO_SIZEOFUNIT(M->element_size) + 1;
+
+	do {
+		head = atomic_get(&M->free_list);
+		*(uint32_t *)block = head & MAP_INDEX_MASK;
+	} while (!atomic_cas(&M->free_list, head, map_list_head(head, index)));
+
+	atomic_dec(&M->num_used);
+}
+
+/**
+ * @brief Hand free memory map blocks to waiting tasks
+ *
+ * Invoked by the microkernel server when a block was freed while tasks
+ * were waiting for one.
+ */
+void _k_mem_map_waiters_get(struct _k_mem_map_struct *M)
+{
+	struct k_args *X;
+	char *block;
+
+	while ((M->waiters != NULL) && ((block = map_block_get(M)) != NULL)) {
+		X = M->waiters;
+		M->waiters = X->next;
+		*(X->args.a1.mptr) = block;
+
+#ifdef CONFIG_SYS_CLOCK_EXISTS
+		if (X->Time.timer) {
+			_k_timeout_free(X->Time.timer);
+			X->Comm = _K_SVC_NOP;
+		}
+#endif
+		X->Time.rcode = RC_OK;
+		_k_state_bit_reset(X->Ctxt.task, TF_ALLO);
+	}
+}
+
+#endif /* CONFIG_MEM_MAP_LOCK_FREE */
+
 /**
  * @brief Initialize kernel memory map subsystem
  *
@@ -39,7 +135,9 @@ void _k_mem_map_init(void)
 
 	for (id = _k_mem_map_ptr_start; id < _k_mem_map_ptr_end; id++) {
 		char *p;
+#ifndef CONFIG_MEM_MAP_LOCK_FREE
 		char *q;
+#endif
 
 		M = (struct _k_mem_map_struct *)(*id);
 
@@ -48,14 +146,25 @@ void _k_mem_map_init(void)
 		w = OCTET_TO_SIZEOFUNIT(M->element_size);
 
 		p = M->base;
-		q = NULL;
 
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+		__ASSERT(M->Nelms < MAP_INDEX_MASK, "too many memory map blocks");
+
+		/* block j links to block j - 1; the last block is the head */
+		for (j = 0; j < M->Nelms; j++) {
+			*(uint32_t *)p = j;
+			p += w;
+		}
+		M->free_list = M->Nelms;
+#else
+		q = NULL;
 		for (j = 0; j < M->Nelms; j++) {
 			*(char **)p = q;
 			q = p;
 			p += w;
 		}
 		M->free = q;
+#endif
 		M->num_used = 0;
 		M->high_watermark = 0;
 		M->count = 0;
@@ -81,6 +190,13 @@ void _k_mem_map_alloc(struct k_args *A)
 	struct _k_mem_map_struct *M =
 	    (struct _k_mem_map_struct *)(A->args.a1.mmap);
 
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+	*(A->args.a1.mptr) = map_block_get(M);
+	if (*(A->args.a1.mptr) != NULL) {
+		A->Time.rcode = RC_OK;
+		return;
+	}
+#else
 	if (M->free != NULL) {
 		*(A->args.a1.mptr) = M->free;
 		M->free = *(char **)(M->free);
@@ -95,6 +211,7 @@ void _k_mem_map_alloc(struct k_args *A)
 		A->Time.rcode = RC_OK;
 		return;
 	}
+#endif
 
 	*(A->args.a1.mptr) = NULL;
 
@@ -110,6 +227,13 @@ void _k_mem_map_alloc(struct k_args *A)
 			A->Comm = _K_SVC_MEM_MAP_ALLOC_TIMEOUT;
 			_k_timeout_alloc(A);
 		}
+#endif
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+		/*
+		 * A fiber or ISR may have freed a block after the free list
+		 * was found empty, but before this task became a waiter.
+		 */
+		_k_mem_map_waiters_get(M);
 #endif
 	} else
 		A->Time.rcode = RC_FAIL;
@@ -118,6 +242,39 @@ void _k_mem_map_alloc(struct k_args *A)
 int task_mem_map_alloc(kmemory_map_t mmap, void **mptr, int32_t timeout)
 {
 	struct k_args A;
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+	*mptr = map_block_get((struct _k_mem_map_struct *)mmap);
+	if (*mptr != NULL) {
+		return RC_OK;
+	}
+
+	if (timeout == TICKS_NONE) {
+		return RC_FAIL;
+	}
+#elif defined(CONFIG_MICROKERNEL_FAST_PATH)
+	struct _k_mem_map_struct *M = (struct _k_mem_map_struct *)mmap;
+	unsigned int key = irq_lock();
+
+	/* the microkernel server cannot run while interrupts are locked */
+	if (M->free != NULL) {
+		*mptr = M->free;
+		M->free = *(char **)(M->free);
+		M->num_used++;
+#ifdef CONFIG_OBJECT_MONITOR
+		M->count++;
+		if (M->high_watermark < M->num_used)
+			M->high_watermark = M->num_used;
+#endif
+		irq_unlock(key);
+		return RC_OK;
+	}
+	irq_unlock(key);
+
+	if (timeout == TICKS_NONE) {
+		*mptr = NULL;
+		return RC_FAIL;
+	}
+#endif
 
 	A.Comm = _K_SVC_MEM_MAP_ALLOC;
 	A.Time.ticks = timeout;
@@ -136,6 +293,11 @@ void _k_mem_map_dealloc(struct k_args *A)
 {
 	struct _k_mem_map_struct *M =
 	    (struct _k_mem_map_struct *)(A->args.a1.mmap);
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+	map_block_put(M, *(char **)(A->args.a1.mptr));
+	*(A->args.a1.mptr) = NULL;
+	_k_mem_map_waiters_get(M);
+#else
 	struct k_args *X;
 
 	**(char ***)(A->args.a1.mptr) = M->free;
@@ -164,17 +326,73 @@ void _k_mem_map_dealloc(struct k_args *A)
 		return;
 	}
 	M->num_used--;
+#endif
 }
 
 void _task_mem_map_free(kmemory_map_t mmap, void **mptr)
 {
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+	struct _k_mem_map_struct *M = (struct _k_mem_map_struct *)mmap;
+
+	map_block_put(M, *(char **)mptr);
+	*mptr = NULL;
+
+	/* let the microkernel server hand the block to a waiting task */
+	if (M->waiters != NULL) {
+		nano_task_stack_push(&_k_command_stack,
+				     (uint32_t)mmap | KERNEL_CMD_MEM_MAP_TYPE);
+	}
+#else
 	struct k_args A;
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_mem_map_struct *M = (struct _k_mem_map_struct *)mmap;
+	unsigned int key = irq_lock();
+
+	/* free directly if no task waits for a block */
+	if (M->waiters == NULL) {
+		**(char ***)mptr = M->free;
+		M->free = *(char **)mptr;
+		*mptr = NULL;
+		M->num_used--;
+		irq_unlock(key);
+		return;
+	}
+	irq_unlock(key);
+#endif
 
 	A.Comm = _K_SVC_MEM_MAP_DEALLOC;
 	A.args.a1.mmap = mmap;
 	A.args.a1.mptr = mptr;
 	KERNEL_ENTRY(&A);
+#endif
+}
+
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+FUNC_ALIAS(isr_mem_map_alloc, fiber_mem_map_alloc, int);
+
+int isr_mem_map_alloc(kmemory_map_t mmap, void **mptr)
+{
+	*mptr = map_block_get((struct _k_mem_map_struct *)mmap);
+
+	return (*mptr != NULL) ? RC_OK : RC_FAIL;
+}
+
+FUNC_ALIAS(isr_mem_map_free, fiber_mem_map_free, void);
+
+void isr_mem_map_free(kmemory_map_t mmap, void **mptr)
+{
+	struct _k_mem_map_struct *M = (struct _k_mem_map_struct *)mmap;
+
+	map_block_put(M, *(char **)mptr);
+	*mptr = NULL;
+
+	/* let the microkernel server hand the block to a waiting task */
+	if (M->waiters != NULL) {
+		nano_isr_stack_push(&_k_command_stack,
+				    (uint32_t)mmap | KERNEL_CMD_MEM_MAP_TYPE);
+	}
 }
+#endif /* CONFIG_MEM_MAP_LOCK_FREE */
 
 int task_mem_map_used_get(kmemory_map_t mmap)
 {
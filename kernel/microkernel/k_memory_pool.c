@@ -27,6 +27,188 @@
 
 #define AUTODEFRAG AD_AFTER_SEARCH4BIGGERBLOCK
 
+#ifdef CONFIG_MEM_POOL_BUDDY
+
+/*
+ * Buddy allocator
+ *
+ * Every fragmentation level splits the blocks of the level above it into
+ * quartets of buddies, and the block status array sysgen generates for a
+ * level has exactly one entry per block of the level above. Entry <j> of a
+ * level therefore always describes the four buddies obtained by splitting
+ * block <j> of the previous level (level 0 entries describe the maximum size
+ * blocks four at a time), so the address of a block determines its entry.
+ *
+ * The low nibble of mem_status has one bit per buddy, set when the buddy is
+ * not available (allocated, split further or missing); QUAD_SPLIT is set
+ * while the quartet exists, i.e. while its parent block is split. Quartets
+ * with at least one available buddy are kept on the free list of their level.
+ */
+
+#define QUAD_USED 0xF
+#define QUAD_SPLIT 0x10
+
+/**
+ *
+ * @brief Initialize kernel memory pool subsystem
+ *
+ * Perform any initialization of memory pool that wasn't done at build time.
+ *
+ * @return N/A
+ */
+void _k_mem_pool_init(void)
+{
+	int i, j, k, remaining;
+	struct pool_struct *P;
+	struct pool_block *level;
+	struct block_stat *quad;
+
+	for (i = 0, P = _k_mem_pool_list; i < _k_mem_pool_count; i++, P++) {
+		for (k = 0; k < P->nr_of_frags; k++) {
+			level = P->frag_tab + k;
+			level->count = 0;
+			sys_dlist_init(&level->free_list);
+			for (j = 0; j < level->nr_of_entries; j++) {
+				quad = level->blocktable + j;
+				quad->mem_blocks = P->bufblock +
+					OCTET_TO_SIZEOFUNIT(4 * j * level->block_size);
+				quad->mem_status = QUAD_USED; /* parent not split */
+			}
+		}
+
+		/* all blocks of maximum size are initially free */
+		level = P->frag_tab;
+		remaining = P->nr_of_maxblocks;
+		for (j = 0; j < level->nr_of_entries; j++, remaining -= 4) {
+			quad = level->blocktable + j;
+			quad->mem_status = QUAD_SPLIT;
+			if (remaining < 4) {
+				/* mark unaccessible blocks as used */
+				quad->mem_status |= (QUAD_USED << remaining) & QUAD_USED;
+			}
+			sys_dlist_append(&level->free_list, &quad->free_node);
+		}
+	}
+}
+
+/**
+ *
+ * @brief Perform defragment memory pool request
+ *
+ * Nothing to do: freed blocks are merged with their buddies immediately.
+ *
+ * @return N/A
+ */
+void _k_defrag(struct k_args *A)
+{
+	ARG_UNUSED(A);
+}
+
+/**
+ *
+ * @brief Get a block, splitting a larger block if necessary
+ *
+ * @return pointer to allocated block, or NULL if none available
+ */
+static char *get_block_recusive(struct pool_struct *P, int index, int startindex)
+{
+	struct pool_block *level;
+	struct block_stat *quad;
+	char *larger_block;
+	int bit;
+
+	if (index < 0) {
+		return NULL; /* no more free blocks in pool */
+	}
+
+	level = P->frag_tab + index;
+
+	if (!sys_dlist_is_empty(&level->free_list)) {
+		quad = CONTAINER_OF(sys_dlist_peek_head(&level->free_list),
+				    struct block_stat, free_node);
+		bit = find_lsb_set(~quad->mem_status & QUAD_USED) - 1;
+		quad->mem_status |= (1 << bit);
+		if ((quad->mem_status & QUAD_USED) == QUAD_USED) {
+			sys_dlist_remove(&quad->free_node);
+		}
+#ifdef CONFIG_OBJECT_MONITOR
+		level->count++;
+#endif
+		return quad->mem_blocks +
+			OCTET_TO_SIZEOFUNIT(bit * level->block_size);
+	}
+
+	larger_block = get_block_recusive(P, index - 1, startindex);
+	if (larger_block == NULL) {
+		return NULL;
+	}
+
+	/* split the larger block into 4 buddies and hand out the first one */
+	quad = level->blocktable +
+		(larger_block - P->bufblock) /
+		OCTET_TO_SIZEOFUNIT(P->frag_tab[index - 1].block_size);
+	quad->mem_status = QUAD_SPLIT | 1;
+	sys_dlist_prepend(&level->free_list, &quad->free_node);
+#ifdef CONFIG_OBJECT_MONITOR
+	level->count++;
+#endif
+	return larger_block;
+}
+
+/**
+ *
+ * @brief Free a block, merging it with its buddies if they are all free
+ *
+ * @return 1 if the block was freed, 0 if it is not an allocated block
+ */
+static int block_free(struct pool_struct *P, int index, char *ptr)
+{
+	struct pool_block *level = P->frag_tab + index;
+	struct block_stat *quad;
+	uint32_t offset;
+	uint32_t block;
+	uint32_t bit;
+
+	if (ptr < P->bufblock) {
+		return 0;
+	}
+
+	offset = ptr - P->bufblock;
+	block = offset / OCTET_TO_SIZEOFUNIT(level->block_size);
+	if ((offset % OCTET_TO_SIZEOFUNIT(level->block_size)) != 0 ||
+	    (block >> 2) >= level->nr_of_entries) {
+		return 0;
+	}
+
+	quad = level->blocktable + (block >> 2);
+	bit = 1 << (block & 3);
+	if (!(quad->mem_status & QUAD_SPLIT) || !(quad->mem_status & bit)) {
+		return 0;
+	}
+
+	/* a block that is split into smaller blocks is not allocated */
+	if ((index + 1 < P->nr_of_frags) &&
+	    (level[1].blocktable[block].mem_status & QUAD_SPLIT)) {
+		return 0;
+	}
+
+	if ((quad->mem_status & QUAD_USED) == QUAD_USED) {
+		sys_dlist_prepend(&level->free_list, &quad->free_node);
+	}
+	quad->mem_status &= ~bit;
+
+	if ((index > 0) && ((quad->mem_status & QUAD_USED) == 0)) {
+		/* all 4 buddies are free: give them back to their parent */
+		sys_dlist_remove(&quad->free_node);
+		quad->mem_status = QUAD_USED;
+		return block_free(P, index - 1, quad->mem_blocks);
+	}
+
+	return 1;
+}
+
+#else
+
 /**
  *
  * @brief Initialize kernel memory pool subsystem
@@ -204,15 +386,6 @@ void _k_defrag(struct k_args *A)
 }
 
 
-void task_mem_pool_defragment(kmemory_pool_t Pid)
-{
-	struct k_args A;
-
-	A.Comm = _K_SVC_DEFRAG;
-	A.args.p1.pool_id = Pid;
-	KERNEL_ENTRY(&A);
-}
-
 /**
  *
  * @brief Allocate block using specified fragmentation level
@@ -382,6 +555,48 @@ static char *get_block_recusive(struct pool_struct *P, int index, int startindex
 	return NULL; /* now we have to report failure: no block available */
 }
 
+/**
+ *
+ * @brief Mark a block as free
+ *
+ * @return 1 if the block was freed, 0 if it is not a block of the pool
+ */
+static int block_free(struct pool_struct *P, int index, char *ptr)
+{
+	struct pool_block *block;
+	struct block_stat *blockstat;
+	int i, j;
+
+	j = 0;
+	block = P->frag_tab + index;
+
+	while ((j < block->nr_of_entries) &&
+	       ((blockstat = block->blocktable + j)->mem_blocks != 0)) {
+		for (i = 0; i < 4; i++) {
+			if (ptr == (blockstat->mem_blocks +
+				    (OCTET_TO_SIZEOFUNIT(i * block->block_size)))) {
+				/* we've found the right pointer, so free it */
+				blockstat->mem_status &= ~(1 << i);
+				return 1;
+			}
+		}
+		j++;
+	}
+
+	return 0;
+}
+
+#endif /* CONFIG_MEM_POOL_BUDDY */
+
+void task_mem_pool_defragment(kmemory_pool_t Pid)
+{
+	struct k_args A;
+
+	A.Comm = _K_SVC_DEFRAG;
+	A.args.p1.pool_id = Pid;
+	KERNEL_ENTRY(&A);
+}
+
 /**
  *
  * @brief Examine tasks that are waiting for memory pool blocks
@@ -640,11 +855,8 @@ void *task_malloc(uint32_t size)
 void _k_mem_pool_block_release(struct k_args *A)
 {
 	struct pool_struct *P;
-	struct pool_block *block;
-	struct block_stat *blockstat;
 	int Pid;
 	int start_size, offset;
-	int i, j;
 
 	Pid = A->args.p1.pool_id;
 
@@ -663,39 +875,26 @@ void _k_mem_pool_block_release(struct k_args *A)
 	/* startsize==the available size that contains the requested block size */
 	/* offset: index in fragtable of the block */
 
-	j = 0;
-	block = P->frag_tab + offset;
-
-	while ((j < block->nr_of_entries) &&
-	       ((blockstat = block->blocktable + j)->mem_blocks != 0)) {
-		for (i = 0; i < 4; i++) {
-			if (A->args.p1.rep_poolptr ==
-			    (blockstat->mem_blocks +
-			     (OCTET_TO_SIZEOFUNIT(i * block->block_size)))) {
-				/* we've found the right pointer, so free it */
-				blockstat->mem_status &= ~(1 << i);
+	if (!block_free(P, offset, A->args.p1.rep_poolptr)) {
+		return;
+	}
 
-				/* waiters? */
-				if (P->waiters != NULL) {
-					struct k_args *NewGet;
-					/*
-					 * get new command packet that calls
-					 * the function that reallocate blocks
-					 * for the waiting tasks
-					 */
-					GETARGS(NewGet);
-					*NewGet = *A;
-					NewGet->Comm = _K_SVC_BLOCK_WAITERS_GET;
-					/* push on command stack */
-					TO_ALIST(&_k_command_stack, NewGet);
-				}
-				if (A->alloc) {
-					FREEARGS(A);
-				}
-				return;
-			}
-		}
-		j++;
+	/* waiters? */
+	if (P->waiters != NULL) {
+		struct k_args *NewGet;
+		/*
+		 * get new command packet that calls
+		 * the function that reallocate blocks
+		 * for the waiting tasks
+		 */
+		GETARGS(NewGet);
+		*NewGet = *A;
+		NewGet->Comm = _K_SVC_BLOCK_WAITERS_GET;
+		/* push on command stack */
+		TO_ALIST(&_k_command_stack, NewGet);
+	}
+	if (A->alloc) {
+		FREEARGS(A);
 	}
 }
 
@@ -264,6 +264,39 @@ void _k_mutex_lock_request(struct k_args *A /* pointer to mutex lock
 int task_mutex_lock(kmutex_t mutex, int32_t timeout)
 {
 	struct k_args A; /* argument packet */
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_mutex_struct *Mutex = (struct _k_mutex_struct *)mutex;
+	unsigned int key = irq_lock();
+
+	/*
+	 * Take an unowned mutex, or nest a lock, directly: this is what
+	 * _k_mutex_lock_request() would do, and the microkernel server cannot
+	 * run while interrupts are locked.
+	 */
+	if (Mutex->level == 0 || Mutex->owner == _k_current_task->id) {
+#ifdef CONFIG_OBJECT_MONITOR
+		Mutex->count++;
+#endif
+		Mutex->owner = _k_current_task->id;
+		Mutex->current_owner_priority = _k_current_task->priority;
+		if (Mutex->level == 0) {
+			Mutex->original_owner_priority =
+				Mutex->current_owner_priority;
+		}
+		Mutex->level++;
+		irq_unlock(key);
+		return RC_OK;
+	}
+
+	if (timeout == TICKS_NONE) {
+#ifdef CONFIG_OBJECT_MONITOR
+		Mutex->num_conflicts++;
+#endif
+		irq_unlock(key);
+		return RC_FAIL;
+	}
+	irq_unlock(key);
+#endif
 
 	A.Comm = _K_SVC_MUTEX_LOCK_REQUEST;
 	A.Time.ticks = timeout;
@@ -376,6 +409,34 @@ void _k_mutex_unlock(struct k_args *A)
 void _task_mutex_unlock(kmutex_t mutex)
 {
 	struct k_args A; /* argument packet */
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_mutex_struct *Mutex = (struct _k_mutex_struct *)mutex;
+	unsigned int key = irq_lock();
+
+	/*
+	 * Release a nested lock, or a lock that no task waits for and that is
+	 * not involved in priority inheritance, directly.
+	 */
+	if (Mutex->owner == _k_current_task->id) {
+		if (Mutex->level > 1) {
+			Mutex->level--;
+			irq_unlock(key);
+			return;
+		}
+		if (Mutex->waiters == NULL &&
+		    Mutex->current_owner_priority ==
+		    Mutex->original_owner_priority) {
+#ifdef CONFIG_OBJECT_MONITOR
+			Mutex->count++;
+#endif
+			Mutex->owner = ANYTASK;
+			Mutex->level = 0;
+			irq_unlock(key);
+			return;
+		}
+	}
+	irq_unlock(key);
+#endif
 
 	A.Comm = _K_SVC_MUTEX_UNLOCK;
 	A.args.l1.mutex = mutex;
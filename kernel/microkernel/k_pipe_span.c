@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief Zero-copy pipe kernel services
+ *
+ * A span is a contiguous area of a pipe's buffer that is registered as an
+ * asynchronous buffer transfer, exactly like the transfers the pipe service
+ * itself performs through the memory move service. While the span is
+ * outstanding, the pipe service does not touch it; committing or releasing
+ * it ends the transfer and lets waiting readers or writers proceed.
+ */
+
+#include <micro_private.h>
+#include <k_pipe_buffer.h>
+#include <k_pipe_util.h>
+#include <microkernel/pipe.h>
+#include <toolchain.h>
+#include <sections.h>
+
+/**
+ *
+ * @brief Process reserve request command for a pipe
+ *
+ * @return N/A
+ */
+void _k_pipe_put_reserve(struct k_args *A)
+{
+	struct _k_pipe_struct *pipe_ptr =
+		(struct _k_pipe_struct *)A->args.pipe_span.id;
+	struct _k_pipe_desc *desc = &pipe_ptr->desc;
+	int size = A->args.pipe_span.size;
+
+	A->Time.rcode = RC_FAIL;
+
+	/* do not overtake writers that wait for free space */
+	if (pipe_ptr->writers != NULL) {
+		return;
+	}
+
+	if (size > desc->free_space_count) {
+		if (A->args.pipe_span.option == _ALL_N) {
+			return;
+		}
+		size = desc->free_space_count;
+	}
+
+	if ((size == 0) ||
+	    (BuffEnQA(desc, size, &A->args.pipe_span.data,
+		      &A->args.pipe_span.xfer_id) == 0)) {
+		return;
+	}
+
+	A->args.pipe_span.size = size;
+	A->Time.rcode = RC_OK;
+}
+
+/**
+ *
+ * @brief Process commit command for a pipe
+ *
+ * @return N/A
+ */
+void _k_pipe_put_commit(struct k_args *A)
+{
+	struct _k_pipe_struct *pipe_ptr =
+		(struct _k_pipe_struct *)A->args.pipe_span.id;
+
+	BuffEnQA_End(&pipe_ptr->desc, A->args.pipe_span.xfer_id,
+		     A->args.pipe_span.size);
+
+	/* the data may satisfy waiting readers */
+	_k_pipe_process(pipe_ptr, NULL, NULL);
+}
+
+/**
+ *
+ * @brief Process peek request command for a pipe
+ *
+ * @return N/A
+ */
+void _k_pipe_get_peek(struct k_args *A)
+{
+	struct _k_pipe_struct *pipe_ptr =
+		(struct _k_pipe_struct *)A->args.pipe_span.id;
+	struct _k_pipe_desc *desc = &pipe_ptr->desc;
+	int size = A->args.pipe_span.size;
+
+	A->Time.rcode = RC_FAIL;
+
+	/* do not overtake readers that wait for data */
+	if (pipe_ptr->readers != NULL) {
+		return;
+	}
+
+	if (size > desc->available_data_count) {
+		if (A->args.pipe_span.option == _ALL_N) {
+			return;
+		}
+		size = desc->available_data_count;
+	}
+
+	if ((size == 0) ||
+	    (BuffDeQA(desc, size, &A->args.pipe_span.data,
+		      &A->args.pipe_span.xfer_id) == 0)) {
+		return;
+	}
+
+	A->args.pipe_span.size = size;
+	A->Time.rcode = RC_OK;
+}
+
+/**
+ *
+ * @brief Process release command for a pipe
+ *
+ * @return N/A
+ */
+void _k_pipe_get_release(struct k_args *A)
+{
+	struct _k_pipe_struct *pipe_ptr =
+		(struct _k_pipe_struct *)A->args.pipe_span.id;
+
+	BuffDeQA_End(&pipe_ptr->desc, A->args.pipe_span.xfer_id,
+		     A->args.pipe_span.size);
+
+	/* the free space may satisfy waiting writers */
+	_k_pipe_process(pipe_ptr, NULL, NULL);
+}
+
+/**
+ * @brief Helper function for reserve and peek requests
+ *
+ * @return RC_OK, RC_FAIL, or RC_ALIGNMENT
+ */
+static int pipe_span_get(void (*comm)(struct k_args *), kpipe_t id,
+			 struct k_pipe_span *span, int size,
+			 K_PIPE_OPTION options)
+{
+	struct k_args A;
+
+	span->pipe_id = id;
+	span->data = NULL;
+	span->size = 0;
+
+	if (unlikely(size % SIZEOFUNIT_TO_OCTET(1))) {
+		return RC_ALIGNMENT;
+	}
+	if (unlikely(size <= 0)) {
+		return RC_FAIL;
+	}
+
+	A.Comm = comm;
+	A.args.pipe_span.id = id;
+	A.args.pipe_span.size = size;
+	A.args.pipe_span.option = options;
+	KERNEL_ENTRY(&A);
+
+	if (A.Time.rcode == RC_OK) {
+		span->data = A.args.pipe_span.data;
+		span->size = A.args.pipe_span.size;
+		span->xfer_id = A.args.pipe_span.xfer_id;
+	}
+	return A.Time.rcode;
+}
+
+/**
+ * @brief Helper function for commit and release requests
+ *
+ * @return N/A
+ */
+static void pipe_span_put(void (*comm)(struct k_args *),
+			  struct k_pipe_span *span)
+{
+	struct k_args A;
+
+	A.Comm = comm;
+	A.args.pipe_span.id = span->pipe_id;
+	A.args.pipe_span.size = span->size;
+	A.args.pipe_span.xfer_id = span->xfer_id;
+	KERNEL_ENTRY(&A);
+
+	span->data = NULL;
+	span->size = 0;
+}
+
+int task_pipe_put_reserve(kpipe_t id, struct k_pipe_span *span, int size,
+			  K_PIPE_OPTION options)
+{
+	return pipe_span_get(_K_SVC_PIPE_PUT_RESERVE, id, span, size, options);
+}
+
+void task_pipe_put_commit(struct k_pipe_span *span)
+{
+	pipe_span_put(_K_SVC_PIPE_PUT_COMMIT, span);
+}
+
+int task_pipe_get_peek(kpipe_t id, struct k_pipe_span *span, int size,
+		       K_PIPE_OPTION options)
+{
+	return pipe_span_get(_K_SVC_PIPE_GET_PEEK, id, span, size, options);
+}
+
+void task_pipe_get_release(struct k_pipe_span *span)
+{
+	pipe_span_put(_K_SVC_PIPE_GET_RELEASE, span);
+}
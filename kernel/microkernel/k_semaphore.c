@@ -25,6 +25,7 @@
 #include <sections.h>
 
 #include <micro_private.h>
+#include <microkernel/command_packet.h>
 
 /**
  *
@@ -352,6 +353,22 @@ void _k_sem_wait_request(struct k_args *A)
 int task_sem_take(ksem_t sema, int32_t timeout)
 {
 	struct k_args A;
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_sem_struct *S = (struct _k_sem_struct *)sema;
+	unsigned int key = irq_lock();
+
+	/* the server cannot run while a task has interrupts locked */
+	if (S->level) {
+		S->level--;
+		irq_unlock(key);
+		return RC_OK;
+	}
+	irq_unlock(key);
+
+	if (timeout == TICKS_NONE) {
+		return RC_FAIL;
+	}
+#endif
 
 	A.Comm = _K_SVC_SEM_WAIT_REQUEST;
 	A.Time.ticks = timeout;
@@ -389,9 +406,28 @@ void _k_sem_group_signal(struct k_args *A)
 	}
 }
 
+void task_cmd_pkt_sem_give(cmdPkt_t *pkt, ksem_t sema)
+{
+	struct k_args *A = (struct k_args *)pkt;
+
+	A->Comm = _K_SVC_SEM_SIGNAL;
+	A->args.s1.sema = sema;
+}
+
 void task_sem_give(ksem_t sema)
 {
 	struct k_args A;
+#ifdef CONFIG_MICROKERNEL_FAST_PATH
+	struct _k_sem_struct *S = (struct _k_sem_struct *)sema;
+	unsigned int key = irq_lock();
+
+	if (S->waiters == NULL) {
+		_k_sem_struct_value_update(1, S);
+		irq_unlock(key);
+		return;
+	}
+	irq_unlock(key);
+#endif
 
 	A.Comm = _K_SVC_SEM_SIGNAL;
 	A.args.s1.sema = sema;
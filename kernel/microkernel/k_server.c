@@ -122,6 +122,16 @@ FUNC_NORETURN void _k_server(int unused1, int unused2)
 				kevent_t event = (int)pArgs & ~KERNEL_CMD_TYPE_MASK;
 
 				_k_do_event_signal(event);
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+			} else if (cmd_type == KERNEL_CMD_MEM_MAP_TYPE) {
+
+				/* wake up tasks waiting for memory map blocks */
+
+				kmemory_map_t map = (int)pArgs & ~KERNEL_CMD_TYPE_MASK;
+
+				_k_mem_map_waiters_get(
+					(struct _k_mem_map_struct *)map);
+#endif
 			} else { /* cmd_type == KERNEL_CMD_SEMAPHORE_TYPE */
 
 				/* give semaphore */
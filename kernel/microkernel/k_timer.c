@@ -27,6 +27,33 @@
 
 extern struct k_timer _k_timer_blocks[];
 
+#ifdef CONFIG_TIMEOUT_WHEEL
+
+struct _timeout_wheel _k_timer_wheel;
+
+/**
+ * @brief Insert a timer into the timing wheel
+ * @param T Timer
+ * @return N/A
+ */
+void _k_timer_enlist(struct k_timer *T)
+{
+	_timeout_wheel_add(&_k_timer_wheel, &T->node, T->duration);
+}
+
+/**
+ * @brief Remove a timer from the timing wheel
+ * @param T Timer
+ * @return N/A
+ */
+void _k_timer_delist(struct k_timer *T)
+{
+	_timeout_wheel_remove(&T->node);
+	T->duration = -1;
+}
+
+#else
+
 struct k_timer  *_k_timer_list_head;
 struct k_timer  *_k_timer_list_tail;
 
@@ -82,6 +109,8 @@ void _k_timer_delist(struct k_timer *T)
 	T->duration = -1;
 }
 
+#endif /* CONFIG_TIMEOUT_WHEEL */
+
 /**
  * @brief Allocate timer used for command packet timeout
  *
@@ -138,6 +167,26 @@ void _k_timeout_free(struct k_timer *T)
 	SYS_TRACING_OBJ_REMOVE_DLL(micro_timer, T);
 }
 
+#ifdef CONFIG_TIMEOUT_WHEEL
+/**
+ * @brief Handle an expired timer, already removed from the timing wheel
+ * @param node Timer node
+ * @return N/A
+ */
+static void _k_timer_expire(struct _timeout_wheel_node *node)
+{
+	struct k_timer *T = CONTAINER_OF(node, struct k_timer, node);
+
+	if (T->period) {
+		T->duration = T->period;
+		_k_timer_enlist(T);
+	} else {
+		T->duration = -1;
+	}
+	TO_ALIST(&_k_command_stack, T->args);
+}
+#endif /* CONFIG_TIMEOUT_WHEEL */
+
 /**
  * @brief Handle expired timers
  *
@@ -157,6 +206,9 @@ void _k_timeout_free(struct k_timer *T)
  */
 void _k_timer_list_update(int ticks)
 {
+#ifdef CONFIG_TIMEOUT_WHEEL
+	_timeout_wheel_announce(&_k_timer_wheel, ticks, _k_timer_expire);
+#else
 	struct k_timer *T;
 
 	while (_k_timer_list_head != NULL) {
@@ -183,6 +235,7 @@ void _k_timer_list_update(int ticks)
 
 		ticks = 0; /* don't decrement duration for subsequent timer(s) */
 	}
+#endif /* CONFIG_TIMEOUT_WHEEL */
 }
 
 /**
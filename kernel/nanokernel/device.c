@@ -15,7 +15,10 @@
  */
 
 #include <string.h>
+#include <stdint.h>
+#include <nanokernel.h>
 #include <device.h>
+#include <init.h>
 #include <misc/util.h>
 
 extern struct device __device_init_start[];
@@ -24,14 +27,22 @@ extern struct device __device_SECONDARY_start[];
 extern struct device __device_NANOKERNEL_start[];
 extern struct device __device_MICROKERNEL_start[];
 extern struct device __device_APPLICATION_start[];
+extern struct device __device_LAZY_start[];
 extern struct device __device_init_end[];
 
+/*
+ * Without lazy initialization, the LAZY level devices are part of the
+ * APPLICATION level.
+ */
 static struct device *config_levels[] = {
 	__device_PRIMARY_start,
 	__device_SECONDARY_start,
 	__device_NANOKERNEL_start,
 	__device_MICROKERNEL_start,
 	__device_APPLICATION_start,
+#ifdef CONFIG_DEVICE_INIT_LAZY
+	__device_LAZY_start,
+#endif
 	__device_init_end,
 };
 
@@ -39,6 +50,110 @@ static struct device *config_levels[] = {
 struct device_pm_ops device_pm_ops_nop = {device_pm_nop, device_pm_nop};
 #endif
 
+#if CONFIG_DEVICE_BINDING_HASH_SIZE > 0
+
+#define DEVICE_HASH_SIZE CONFIG_DEVICE_BINDING_HASH_SIZE
+
+/*
+ * Open addressing hash table of the device names: each slot holds the index
+ * of a device plus one, or 0 if empty. Devices with the same name are
+ * inserted in initialization order, so the first one is found first, as
+ * with a linear search. The unnamed objects created by SYS_INIT() are left
+ * out.
+ */
+static uint16_t device_hash[DEVICE_HASH_SIZE];
+static int device_hash_ready;
+
+static unsigned int device_name_hash(const char *name)
+{
+	unsigned int hash = 5381;
+
+	while (*name) {
+		hash = (hash * 33) ^ (unsigned char)*name++;
+	}
+
+	return hash % DEVICE_HASH_SIZE;
+}
+
+static void device_hash_init(void)
+{
+	int count = __device_init_end - __device_init_start;
+	int named = 0;
+	unsigned int slot;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (__device_init_start[i].config->name[0] != '\0') {
+			named++;
+		}
+	}
+
+	if (named > DEVICE_HASH_SIZE) {
+		return;
+	}
+
+	for (i = 0; i < count; i++) {
+		char *name = __device_init_start[i].config->name;
+
+		if (name[0] == '\0') {
+			continue;
+		}
+
+		slot = device_name_hash(name);
+		while (device_hash[slot]) {
+			slot = (slot + 1) % DEVICE_HASH_SIZE;
+		}
+		device_hash[slot] = i + 1;
+	}
+
+	device_hash_ready = 1;
+}
+
+static struct device *device_hash_lookup(const char *name)
+{
+	unsigned int slot = device_name_hash(name);
+	struct device *info;
+	int probes;
+
+	for (probes = 0; probes < DEVICE_HASH_SIZE; probes++) {
+		if (!device_hash[slot]) {
+			break;
+		}
+
+		info = &__device_init_start[device_hash[slot] - 1];
+		if (!strcmp(name, info->config->name)) {
+			return info;
+		}
+
+		slot = (slot + 1) % DEVICE_HASH_SIZE;
+	}
+
+	return NULL;
+}
+
+#endif /* CONFIG_DEVICE_BINDING_HASH_SIZE > 0 */
+
+#ifdef CONFIG_BOOT_TIME_MEASUREMENT
+#ifdef CONFIG_X86
+#define device_timestamp() ((uint32_t)_NanoTscRead())
+#else
+#define device_timestamp() sys_cycle_get_32()
+#endif
+#endif
+
+static void device_init(struct device *info)
+{
+#ifdef CONFIG_BOOT_TIME_MEASUREMENT
+	uint32_t start = device_timestamp();
+#endif
+
+	info->config->init(info);
+
+#ifdef CONFIG_BOOT_TIME_MEASUREMENT
+	info->init_cycles = device_timestamp() - start;
+#endif
+}
+
 /**
  * @brief Execute all the device initialization functions at a given level
  *
@@ -54,11 +169,40 @@ void _sys_device_do_config_level(int level)
 {
 	struct device *info;
 
+#if CONFIG_DEVICE_BINDING_HASH_SIZE > 0
+	if (level == _SYS_INIT_LEVEL_PRIMARY) {
+		device_hash_init();
+	}
+#endif
+
 	for (info = config_levels[level]; info < config_levels[level+1]; info++) {
-		struct device_config *device = info->config;
+		device_init(info);
+	}
+}
+
+#ifdef CONFIG_DEVICE_INIT_LAZY
+/* bits of the lazy_init field of a device */
+#define LAZY_INIT_STARTED 0
+#define LAZY_INIT_DONE    1
+#endif
+
+static struct device *device_find(char *name)
+{
+	struct device *info;
 
-		device->init(info);
+#if CONFIG_DEVICE_BINDING_HASH_SIZE > 0
+	if (device_hash_ready) {
+		return device_hash_lookup(name);
+	}
+#endif
+
+	for (info = __device_init_start; info != __device_init_end; info++) {
+		if (!strcmp(name, info->config->name)) {
+			return info;
+		}
 	}
+
+	return NULL;
 }
 
 /**
@@ -69,21 +213,62 @@ void _sys_device_do_config_level(int level)
  * it can use this function to retrieve the device structure of the lower level
  * driver by the name the driver exposes to the system.
  *
+ * With lazy initialization, the first call finding a LAZY level device runs
+ * its init function, so it must be made from a fiber or a task. A call made
+ * while another thread runs that init function returns NULL, since the device
+ * is not ready for use yet.
+ *
  * @param name device name to search for.
  *
  * @return pointer to device structure, or NULL if not found.
  */
 struct device *device_get_binding(char *name)
 {
-	struct device *info;
+	struct device *info = device_find(name);
 
-	for (info = __device_init_start; info != __device_init_end; info++) {
-		if (!strcmp(name, info->config->name)) {
-			return info;
+#ifdef CONFIG_DEVICE_INIT_LAZY
+	if (info && info >= __device_LAZY_start) {
+		if (!atomic_test_and_set_bit(&info->lazy_init,
+					     LAZY_INIT_STARTED)) {
+			device_init(info);
+			atomic_set_bit(&info->lazy_init, LAZY_INIT_DONE);
+		} else if (!atomic_test_bit(&info->lazy_init,
+					    LAZY_INIT_DONE)) {
+			return NULL;
 		}
 	}
+#endif
 
-	return NULL;
+	return info;
+}
+
+/**
+ * @brief Retrieve the device structures for several drivers by name
+ *
+ * @details Looks up each name of @a names with device_get_binding(), so that
+ * a component binding to many drivers can resolve them all in one call,
+ * typically from its init function.
+ *
+ * @param names device names to search for.
+ * @param devices array filled with the pointers to the device structures,
+ * NULL for the names not found.
+ * @param count number of names.
+ *
+ * @return number of names not found.
+ */
+int device_get_bindings(char *names[], struct device *devices[], int count)
+{
+	int missing = 0;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		devices[i] = device_get_binding(names[i]);
+		if (!devices[i]) {
+			missing++;
+		}
+	}
+
+	return missing;
 }
 
 #ifdef CONFIG_DEVICE_POWER_MANAGEMENT
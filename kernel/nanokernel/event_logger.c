@@ -22,11 +22,41 @@
 #include <misc/event_logger.h>
 #include <misc/ring_buffer.h>
 
+#ifndef CONFIG_KERNEL_EVENT_LOGGER_WAKEUP_BATCH
+#define CONFIG_KERNEL_EVENT_LOGGER_WAKEUP_BATCH 1
+#endif
+
+/*
+ * When the collector is signalled once per batch of events, it can wait for
+ * the rest of an incomplete batch for a limited time only.
+ */
+#if CONFIG_KERNEL_EVENT_LOGGER_WAKEUP_BATCH > 1
+#define COLLECTOR_WAKEUP_TIMEOUT CONFIG_KERNEL_EVENT_LOGGER_WAKEUP_TIMEOUT
+#else
+#define COLLECTOR_WAKEUP_TIMEOUT TICKS_UNLIMITED
+#endif
+
 void sys_event_logger_init(struct event_logger *logger,
 	uint32_t *logger_buffer, uint32_t buffer_size)
 {
 	sys_ring_buf_init(&logger->ring_buf, buffer_size, logger_buffer);
 	nano_sem_init(&(logger->sync_sema));
+	logger->event_count = 0;
+}
+
+
+static inline void event_logger_signal(struct event_logger *logger,
+	void (*sem_give_fn)(struct nano_sem *))
+{
+#if CONFIG_KERNEL_EVENT_LOGGER_WAKEUP_BATCH > 1
+	uint32_t count = (uint32_t)atomic_inc(&logger->event_count) + 1;
+
+	if (count % CONFIG_KERNEL_EVENT_LOGGER_WAKEUP_BATCH) {
+		return;
+	}
+#endif
+	/* inform that there is event data available on the buffer */
+	sem_give_fn(&(logger->sync_sema));
 }
 
 
@@ -35,6 +65,18 @@ static void event_logger_put(struct event_logger *logger, uint16_t event_id,
 	void (*sem_give_fn)(struct nano_sem *))
 {
 	int ret;
+#ifdef CONFIG_RING_BUFFER_LOCK_FREE
+	uint32_t dropped = logger->ring_buf.dropped_put_count;
+
+	ret = sys_ring_buf_put_lock_free(&logger->ring_buf, event_id, dropped,
+					 event_data, data_size);
+	if (ret == 0) {
+		/* keep the drops other producers may have counted meanwhile */
+		atomic_sub((atomic_t *)&logger->ring_buf.dropped_put_count,
+			   dropped);
+		event_logger_signal(logger, sem_give_fn);
+	}
+#else
 	unsigned int key;
 
 	key = irq_lock();
@@ -44,10 +86,10 @@ static void event_logger_put(struct event_logger *logger, uint16_t event_id,
 			       data_size);
 	if (ret == 0) {
 		logger->ring_buf.dropped_put_count = 0;
-		/* inform that there is event data available on the buffer */
-		sem_give_fn(&(logger->sync_sema));
+		event_logger_signal(logger, sem_give_fn);
 	}
 	irq_unlock(key);
+#endif
 }
 
 
@@ -86,6 +128,14 @@ void _sys_event_logger_put_non_preemptible(struct event_logger *logger,
 }
 
 
+/*
+ * The sync semaphore only wakes up the collector: the ring buffer tells
+ * whether event messages are available. The semaphore is given for every
+ * event put while the collector takes it only when the ring buffer is
+ * empty, so the wakeups given for the events already retrieved are dropped
+ * then. The ring buffer is read again afterwards, for an event put before
+ * the semaphore is drained would otherwise not wake up the collector.
+ */
 static int event_logger_get(struct event_logger *logger,
 			    uint16_t *event_id, uint8_t *dropped_event_count,
 			    uint32_t *buffer, uint8_t *buffer_size)
@@ -94,16 +144,17 @@ static int event_logger_get(struct event_logger *logger,
 
 	ret = sys_ring_buf_get(&logger->ring_buf, event_id, dropped_event_count,
 			       buffer, buffer_size);
+	if (ret == -EAGAIN) {
+		while (nano_sem_take(&(logger->sync_sema), TICKS_NONE)) {
+		}
+		ret = sys_ring_buf_get(&logger->ring_buf, event_id,
+				       dropped_event_count, buffer,
+				       buffer_size);
+	}
 	if (likely(!ret)) {
 		return *buffer_size;
 	}
 	switch (ret) {
-	case -EMSGSIZE:
-		/* if the user can not retrieve the message, we increase the
-		 *  semaphore to indicate that the message remains in the buffer
-		 */
-		nano_fiber_sem_give(&(logger->sync_sema));
-		return -EMSGSIZE;
 	case -EAGAIN:
 		return 0;
 	default:
@@ -116,11 +167,8 @@ int sys_event_logger_get(struct event_logger *logger, uint16_t *event_id,
 			 uint8_t *dropped_event_count, uint32_t *buffer,
 			 uint8_t *buffer_size)
 {
-	if (nano_fiber_sem_take(&(logger->sync_sema), TICKS_NONE)) {
-		return event_logger_get(logger, event_id, dropped_event_count,
-					buffer, buffer_size);
-	}
-	return 0;
+	return event_logger_get(logger, event_id, dropped_event_count,
+				buffer, buffer_size);
 }
 
 
@@ -128,10 +176,15 @@ int sys_event_logger_get_wait(struct event_logger *logger,  uint16_t *event_id,
 			      uint8_t *dropped_event_count, uint32_t *buffer,
 			      uint8_t *buffer_size)
 {
-	nano_fiber_sem_take(&(logger->sync_sema), TICKS_UNLIMITED);
+	int ret;
 
-	return event_logger_get(logger, event_id, dropped_event_count, buffer,
-				buffer_size);
+	while ((ret = event_logger_get(logger, event_id, dropped_event_count,
+				       buffer, buffer_size)) == 0) {
+		nano_fiber_sem_take(&(logger->sync_sema),
+				    COLLECTOR_WAKEUP_TIMEOUT);
+	}
+
+	return ret;
 }
 
 
@@ -142,10 +195,29 @@ int sys_event_logger_get_wait_timeout(struct event_logger *logger,
 				      uint32_t *buffer, uint8_t *buffer_size,
 				      uint32_t timeout)
 {
-	if (nano_fiber_sem_take(&(logger->sync_sema), timeout)) {
-		return event_logger_get(logger, event_id, dropped_event_count,
-					buffer, buffer_size);
+	int64_t deadline = sys_tick_get() + timeout;
+	int32_t ticks = timeout;
+	int ret;
+
+	if ((int32_t)timeout == TICKS_UNLIMITED) {
+		return sys_event_logger_get_wait(logger, event_id,
+						 dropped_event_count, buffer,
+						 buffer_size);
 	}
-	return 0;
+
+	while ((ret = event_logger_get(logger, event_id, dropped_event_count,
+				       buffer, buffer_size)) == 0) {
+		if (ticks <= 0) {
+			break;
+		}
+		if ((COLLECTOR_WAKEUP_TIMEOUT != TICKS_UNLIMITED) &&
+		    (ticks > COLLECTOR_WAKEUP_TIMEOUT)) {
+			ticks = COLLECTOR_WAKEUP_TIMEOUT;
+		}
+		nano_fiber_sem_take(&(logger->sync_sema), ticks);
+		ticks = (int32_t)(deadline - sys_tick_get());
+	}
+
+	return ret;
 }
 #endif /* CONFIG_NANO_TIMEOUTS */
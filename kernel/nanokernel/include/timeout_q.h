@@ -24,6 +24,10 @@
 #define _kernel_nanokernel_include_timeout_q__h_
 
 #include <misc/dlist.h>
+#ifdef CONFIG_TIMEOUT_WHEEL
+#include <misc/util.h>
+#include <timeout_wheel.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -35,6 +39,16 @@ static inline void _do_nano_timeout_add(struct tcs *tcs,
 					struct _nano_queue *wait_q,
 					int32_t timeout);
 
+/* initialize a timeout that is not waited on by a fiber */
+static inline void _nano_timeout_init(struct _nano_timeout *t,
+				      _nano_timeout_func_t func)
+{
+	t->delta_ticks_from_prev = -1;
+	t->wait_q = NULL;
+	t->tcs = NULL;
+	t->func = func;
+}
+
 #if defined(CONFIG_NANO_TIMEOUTS)
 /* initialize the nano timeouts part of TCS when enabled in the kernel */
 
@@ -59,6 +73,9 @@ static inline void _nano_timeout_tcs_init(struct tcs *tcs)
 	 */
 	tcs->nano_timeout.tcs = NULL;
 
+	/* fibers are readied on expiry, nothing else is done */
+	tcs->nano_timeout.func = NULL;
+
 	/*
 	 * These are initialized when enqueing on the timeout queue:
 	 *
@@ -105,6 +122,103 @@ static inline void _nano_timeout_add(struct tcs *tcs,
 #define _nano_timeout_object_dequeue(tcs, t) do { } while (0)
 #endif /* CONFIG_NANO_TIMEOUTS */
 
+#ifdef CONFIG_TIMEOUT_WHEEL
+
+extern struct _timeout_wheel _nano_timeout_wheel;
+
+/*
+ * Handle one expired timeout, already removed from the timing wheel.
+ * If a fiber is waiting on an object, this also removes it from the wait
+ * queue it is on, and sets the return value to 0/NULL.
+ */
+
+static inline void _nano_timeout_handle_one_timeout(
+	struct _timeout_wheel_node *node)
+{
+	struct _nano_timeout *t = CONTAINER_OF(node, struct _nano_timeout, node);
+	struct tcs *tcs = t->tcs;
+
+	if (tcs != NULL) {
+		_nano_timeout_object_dequeue(tcs, t);
+		_nano_fiber_ready(tcs);
+	}
+	t->delta_ticks_from_prev = -1;
+
+	if (t->func != NULL) {
+		t->func(t);
+	}
+}
+
+/* announce elapsed ticks and handle all expired timeouts one by one */
+static inline void _nano_timeout_handle_timeouts(int32_t ticks)
+{
+	_timeout_wheel_announce(&_nano_timeout_wheel, ticks,
+				_nano_timeout_handle_one_timeout);
+}
+
+/**
+ *
+ * @brief abort a timeout
+ *
+ * @param t Timeout to abort
+ *
+ * @return 0 in success and -1 if the timer has expired
+ */
+static inline int _do_nano_timeout_abort(struct _nano_timeout *t)
+{
+	if (-1 == t->delta_ticks_from_prev) {
+		return -1;
+	}
+
+	_timeout_wheel_remove(&t->node);
+	t->delta_ticks_from_prev = -1;
+
+	return 0;
+}
+
+static inline int _nano_timer_timeout_abort(struct _nano_timeout *t)
+{
+	return _do_nano_timeout_abort(t);
+}
+
+/**
+ *
+ * @brief Put timeout on the timing wheel, record waiting fiber and wait queue
+ *
+ * @param tcs Fiber waiting on a timeout
+ * @param t Timeout structure to be added to the timing wheel
+ * @wait_q nanokernel object wait queue
+ * @timeout Timeout in ticks
+ *
+ * @return N/A
+ */
+static inline void _do_nano_timeout_add(struct tcs *tcs,
+					struct _nano_timeout *t,
+					struct _nano_queue *wait_q,
+					int32_t timeout)
+{
+	t->tcs = tcs;
+	t->delta_ticks_from_prev = 0;
+	t->wait_q = wait_q;
+	_timeout_wheel_add(&_nano_timeout_wheel, &t->node, timeout);
+}
+
+static inline void _nano_timer_timeout_add(struct _nano_timeout *t,
+				     struct _nano_queue *wait_q,
+				     int32_t timeout)
+{
+	_do_nano_timeout_add(NULL, t, wait_q, timeout);
+}
+
+/* find the closest deadline in the timing wheel */
+static inline uint32_t _nano_get_earliest_timeouts_deadline(void)
+{
+	return min(_timeout_wheel_deadline(&_nano_timeout_wheel),
+		   (uint32_t)_nanokernel.task_timeout);
+}
+
+#else
+
 /*
  * Handle one expired timeout.
  * This removes the fiber from the timeout queue head, and also removes it
@@ -124,6 +238,10 @@ static inline struct _nano_timeout *_nano_timeout_handle_one_timeout(
 	}
 	t->delta_ticks_from_prev = -1;
 
+	if (t->func != NULL) {
+		t->func(t);
+	}
+
 	return (struct _nano_timeout *)sys_dlist_peek_head(timeout_q);
 }
 
@@ -242,6 +360,8 @@ static inline uint32_t _nano_get_earliest_timeouts_deadline(void)
 			 : (uint32_t)_nanokernel.task_timeout;
 }
 
+#endif /* CONFIG_TIMEOUT_WHEEL */
+
 #ifdef __cplusplus
 }
 #endif
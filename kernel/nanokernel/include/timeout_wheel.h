@@ -0,0 +1,101 @@
+/** @file
+ * @brief hierarchical timing wheel for kernel timeouts and timers
+ *
+ * A timing wheel keeps timeouts in slots indexed by their absolute expiry
+ * tick, so that adding and aborting a timeout are constant-time operations,
+ * independent of the number of timeouts already queued.
+ *
+ * The wheel has CONFIG_TIMEOUT_WHEEL_LEVELS levels of 32 slots each: level 0
+ * slots span one tick, level 1 slots span 32 ticks, and so on. Timeouts
+ * further away than the range of the wheel are parked in the last slot of
+ * the top level, and requeued each time the top level wraps around.
+ * Timeouts are moved down one level ("cascaded") when the lower level wraps
+ * around, which makes expiry amortized constant-time per timeout.
+ */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _kernel_nanokernel_include_timeout_wheel__h_
+#define _kernel_nanokernel_include_timeout_wheel__h_
+
+#include <nanokernel.h>
+#include <misc/dlist.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define _TIMEOUT_WHEEL_SLOT_BITS 5
+#define _TIMEOUT_WHEEL_SLOTS (1 << _TIMEOUT_WHEEL_SLOT_BITS)
+#define _TIMEOUT_WHEEL_SLOT_MASK (_TIMEOUT_WHEEL_SLOTS - 1)
+#define _TIMEOUT_WHEEL_LEVELS CONFIG_TIMEOUT_WHEEL_LEVELS
+
+struct _timeout_wheel {
+	/* number of ticks announced so far */
+	uint32_t now;
+	/* non-empty slots; may have stale bits set for emptied slots */
+	uint32_t bitmap[_TIMEOUT_WHEEL_LEVELS];
+	sys_dlist_t slots[_TIMEOUT_WHEEL_LEVELS][_TIMEOUT_WHEEL_SLOTS];
+};
+
+/* called for each expired timeout, after it has been removed from the wheel */
+typedef void (*_timeout_wheel_expire_t)(struct _timeout_wheel_node *node);
+
+extern void _timeout_wheel_init(struct _timeout_wheel *wheel);
+extern void _timeout_wheel_add(struct _timeout_wheel *wheel,
+			       struct _timeout_wheel_node *node,
+			       int32_t ticks);
+extern void _timeout_wheel_announce(struct _timeout_wheel *wheel,
+				    int32_t ticks,
+				    _timeout_wheel_expire_t expire);
+extern uint32_t _timeout_wheel_deadline(struct _timeout_wheel *wheel);
+
+/**
+ *
+ * @brief Remove a timeout from the wheel
+ *
+ * The timeout must be queued on the wheel.
+ *
+ * @param node Timeout to remove
+ *
+ * @return N/A
+ */
+static inline void _timeout_wheel_remove(struct _timeout_wheel_node *node)
+{
+	sys_dlist_remove(&node->node);
+}
+
+/**
+ *
+ * @brief Get the number of ticks until a queued timeout expires
+ *
+ * @param wheel Timing wheel the timeout is queued on
+ * @param node Queued timeout
+ *
+ * @return number of ticks remaining
+ */
+static inline int32_t _timeout_wheel_remaining(struct _timeout_wheel *wheel,
+					       struct _timeout_wheel_node *node)
+{
+	return (int32_t)(node->expiry - wheel->now);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _kernel_nanokernel_include_timeout_wheel__h_ */
@@ -36,7 +36,43 @@ static inline void _nano_wait_q_reset(struct _nano_queue *wait_q)
 static inline void _nano_wait_q_init(struct _nano_queue *wait_q)
 {
 	_nano_wait_q_reset(wait_q);
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+	wait_q->prio_order = 0;
+#endif
+}
+
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+/* order a wait queue by fiber priority: call only while it is empty */
+static inline void _nano_wait_q_prio_set(struct _nano_queue *wait_q)
+{
+	wait_q->prio_order = 1;
+}
+
+/*
+ * In a priority-ordered wait queue, the fibers of the same priority form a
+ * run. The first and the last fiber of a run point to each other through
+ * wait_prio_peer, a fiber alone at its priority points to itself.
+ */
+
+/* take a fiber out of its run, before it is removed from the wait queue */
+static inline void _nano_wait_q_prio_unlink(struct _nano_queue *wait_q,
+					    struct tcs *tcs)
+{
+	struct tcs *peer = tcs->wait_prio_peer;
+	int first, last;
+
+	first = (tcs == wait_q->head) || (tcs->wait_prev->prio != tcs->prio);
+	last = (tcs == wait_q->tail) || (tcs->link->prio != tcs->prio);
+
+	if (first && !last) {
+		tcs->link->wait_prio_peer = peer;
+		peer->wait_prio_peer = tcs->link;
+	} else if (last && !first) {
+		tcs->wait_prev->wait_prio_peer = peer;
+		peer->wait_prio_peer = tcs->wait_prev;
+	}
 }
+#endif
 
 /*
  * Remove first fiber from a wait queue and put it on the ready queue, knowing
@@ -47,6 +83,12 @@ struct tcs *_nano_wait_q_remove_no_check(struct _nano_queue *wait_q)
 {
 	struct tcs *tcs = wait_q->head;
 
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+	if (wait_q->prio_order) {
+		_nano_wait_q_prio_unlink(wait_q, tcs);
+	}
+#endif
+
 	if (wait_q->tail == wait_q->head) {
 		_nano_wait_q_reset(wait_q);
 	} else {
@@ -67,17 +109,82 @@ static inline struct tcs *_nano_wait_q_remove(struct _nano_queue *wait_q)
 	return wait_q->head ? _nano_wait_q_remove_no_check(wait_q) : NULL;
 }
 
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+/*
+ * Insert a fiber in a priority-ordered wait queue, after the fibers of higher
+ * or equal priority. The queue is searched backwards from the tail one run at
+ * a time, so the search is bounded by the number of lower priorities waiting,
+ * not by the number of waiters.
+ */
+static inline void _nano_wait_q_insert_prio(struct _nano_queue *wait_q,
+					    struct tcs *tcs)
+{
+	struct tcs *prev = wait_q->head ? wait_q->tail : NULL;
+	struct tcs *first;
+
+	while (prev && prev->prio > tcs->prio) {
+		first = prev->wait_prio_peer;
+		prev = (first == wait_q->head) ? NULL : first->wait_prev;
+	}
+
+	if (prev && prev->prio == tcs->prio) {
+		/* the fiber becomes the last of the run of prev */
+		first = prev->wait_prio_peer;
+		first->wait_prio_peer = tcs;
+		tcs->wait_prio_peer = first;
+	} else {
+		tcs->wait_prio_peer = tcs;
+	}
+
+	if (!prev) {
+		/* new head */
+		if (wait_q->head) {
+			tcs->link = wait_q->head;
+			((struct tcs *)wait_q->head)->wait_prev = tcs;
+		} else {
+			wait_q->tail = tcs;
+		}
+		wait_q->head = tcs;
+	} else {
+		tcs->wait_prev = prev;
+		if (prev == wait_q->tail) {
+			wait_q->tail = tcs;
+		} else {
+			tcs->link = prev->link;
+			prev->link->wait_prev = tcs;
+		}
+		prev->link = tcs;
+	}
+}
+#endif
+
 /* put current fiber on specified wait queue */
 static inline void _nano_wait_q_put(struct _nano_queue *wait_q)
 {
-	((struct tcs *)wait_q->tail)->link = _nanokernel.current;
-	wait_q->tail = _nanokernel.current;
+	struct tcs *tcs = _nanokernel.current;
+
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+	if (wait_q->prio_order) {
+		_nano_wait_q_insert_prio(wait_q, tcs);
+		return;
+	}
+#endif
+
+	tcs->wait_prev = wait_q->tail;
+	((struct tcs *)wait_q->tail)->link = tcs;
+	wait_q->tail = tcs;
 }
 
 #if defined(CONFIG_NANO_TIMEOUTS)
 static inline void _nano_timeout_remove_tcs_from_wait_q(
 	struct tcs *tcs, struct _nano_queue *wait_q)
 {
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+	if (wait_q->prio_order) {
+		_nano_wait_q_prio_unlink(wait_q, tcs);
+	}
+#endif
+
 	if (wait_q->head == tcs) {
 		if (wait_q->tail == wait_q->head) {
 			_nano_wait_q_reset(wait_q);
@@ -85,14 +192,13 @@ static inline void _nano_timeout_remove_tcs_from_wait_q(
 			wait_q->head = tcs->link;
 		}
 	} else {
-		struct tcs *prev = wait_q->head;
+		struct tcs *prev = tcs->wait_prev;
 
-		while (prev->link != tcs) {
-			prev = prev->link;
-		}
 		prev->link = tcs->link;
 		if (wait_q->tail == tcs) {
 			wait_q->tail = prev;
+		} else {
+			tcs->link->wait_prev = prev;
 		}
 	}
 
@@ -128,6 +234,32 @@ static inline void _nano_timeout_remove_tcs_from_wait_q(
 	#define _NANO_TIMEOUT_SET_TASK_TIMEOUT(ticks) do { } while ((0))
 #endif
 
+#ifdef CONFIG_NANO_POLL
+extern int _nano_poll_signal(struct nano_poll_event *event);
+
+/*
+ * Wake up the fiber polling an object that just became ready, if any.
+ * Evaluates to 1 if a fiber was made ready, 0 otherwise.
+ */
+	#define _NANO_POLL_SIGNAL(obj) \
+		((obj)->poll_event ? _nano_poll_signal((obj)->poll_event) : 0)
+	#define _NANO_POLL_INIT(obj) ((obj)->poll_event = NULL)
+
+#ifdef CONFIG_NANO_TIMERS
+extern void _nano_poll_timer_expired(struct _nano_timeout *t);
+
+/* the timer expiry callback records the expiry for nano_poll() */
+	#define _NANO_POLL_TIMER_FUNC _nano_poll_timer_expired
+	#define _NANO_POLL_TIMER_EXPIRED_SET(timer, value) \
+		((timer)->expired = (value))
+#endif
+#else
+	#define _NANO_POLL_SIGNAL(obj) 0
+	#define _NANO_POLL_INIT(obj) do { } while ((0))
+	#define _NANO_POLL_TIMER_FUNC NULL
+	#define _NANO_POLL_TIMER_EXPIRED_SET(timer, value) do { } while ((0))
+#endif
+
 #ifdef __cplusplus
 }
 #endif
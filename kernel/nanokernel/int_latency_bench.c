@@ -19,13 +19,30 @@
 #include "toolchain.h"
 #include "sections.h"
 #include <stdint.h>	    /* uint32_t */
+#include <string.h>	    /* memset */
 #include <limits.h>	    /* ULONG_MAX */
 #include <misc/printk.h> /* printk */
 #include <sys_clock.h>
 #include <drivers/system_timer.h>
+#include <nanokernel.h>
+#include <misc/util.h>
 
 #define NB_CACHE_WARMING_DRY_RUN 7
 
+/*
+ * The histogram of the durations interrupts were locked has one bucket per
+ * power of two: bucket N counts the durations in [2^(N-1), 2^N) cycles,
+ * bucket 0 the zero durations.
+ */
+#define INT_LOCKED_HISTOGRAM_BUCKETS 33
+
+/* a code path locking interrupts, identified by the caller of irq_lock() */
+struct int_locked_site {
+	void *caller;
+	uint32_t max;
+	uint32_t count;
+};
+
 /*
  * Timestamp corresponding to when interrupt were turned off.
  * A value of zero indicated interrupt are not currently locked.
@@ -36,6 +53,18 @@ static uint32_t int_locked_timestamp;
 static uint32_t int_locked_latency_min = ULONG_MAX;
 static uint32_t int_locked_latency_max;
 
+/* caller of the outermost irq_lock() while interrupts are locked */
+static void *int_locked_caller;
+
+/* distribution of the time spent with interrupts locked */
+static uint32_t int_locked_histogram[INT_LOCKED_HISTOGRAM_BUCKETS];
+static uint64_t int_locked_total;
+static uint32_t int_locked_count;
+
+/* code paths which locked interrupts for the longest time */
+static struct int_locked_site
+	int_locked_sites[CONFIG_INT_LATENCY_BENCHMARK_SITES];
+
 /* overhead added to intLock/intUnlock by this latency benchmark */
 static uint32_t initial_start_delay;
 static uint32_t nesting_delay;
@@ -50,6 +79,69 @@ static uint32_t int_latency_bench_ready;
 /* min amount of time it takes from HW interrupt generation to 'C' handler */
 uint32_t _hw_irq_to_c_handler_latency = ULONG_MAX;
 
+/**
+ *
+ * @brief Reset the interrupt latency statistics
+ *
+ * @return N/A
+ *
+ */
+static void int_latency_reset(void)
+{
+	int_locked_latency_min = ULONG_MAX;
+	int_locked_latency_max = 0;
+
+	memset(int_locked_histogram, 0, sizeof(int_locked_histogram));
+	int_locked_total = 0;
+	int_locked_count = 0;
+
+	memset(int_locked_sites, 0, sizeof(int_locked_sites));
+}
+
+/**
+ *
+ * @brief Account for a period of time spent with interrupts locked
+ *
+ * The period is added to the histogram, and its caller to the code paths
+ * which locked interrupts for the longest time, if it is one of them.
+ *
+ * @return N/A
+ *
+ */
+static void int_latency_record(uint32_t delta, void *caller)
+{
+	struct int_locked_site *site;
+	struct int_locked_site *shortest = &int_locked_sites[0];
+	int i;
+
+	int_locked_histogram[find_msb_set(delta)]++;
+	int_locked_total += delta;
+	int_locked_count++;
+
+	for (i = 0; i < ARRAY_SIZE(int_locked_sites); i++) {
+		site = &int_locked_sites[i];
+
+		if (site->caller == caller) {
+			site->count++;
+			if (delta > site->max) {
+				site->max = delta;
+			}
+			return;
+		}
+
+		if (site->max < shortest->max) {
+			shortest = site;
+		}
+	}
+
+	/* evict the code path with the shortest maximum, or an unused slot */
+	if (delta > shortest->max) {
+		shortest->caller = caller;
+		shortest->max = delta;
+		shortest->count = 1;
+	}
+}
+
 /**
  *
  * @brief Start tracking time spent with interrupts locked
@@ -65,6 +157,8 @@ void _int_latency_start(void)
 	/* when interrupts are not already locked, take time stamp */
 	if (!int_locked_timestamp && int_latency_bench_ready) {
 		int_locked_timestamp = sys_cycle_get_32();
+		/* irq_lock() is inlined: this is the code locking interrupts */
+		int_locked_caller = __builtin_return_address(0);
 		int_lock_unlock_nest = 0;
 	}
 	int_lock_unlock_nest++;
@@ -116,6 +210,8 @@ void _int_latency_stop(void)
 		if (delta < int_locked_latency_min)
 			int_locked_latency_min = delta;
 
+		int_latency_record(delta, int_locked_caller);
+
 		/* interrupts are now enabled, get ready for next interrupt lock
 		 */
 		int_locked_timestamp = 0;
@@ -166,13 +262,66 @@ void int_latency_init(void)
 		stop_delay = sys_cycle_get_32() - stop_delay - timeToReadTime;
 
 		/* re-initialize globals to default values */
-		int_locked_latency_min = ULONG_MAX;
-		int_locked_latency_max = 0;
+		int_latency_reset();
 
 		cacheWarming--;
 	}
 }
 
+/**
+ *
+ * @brief Dumps the histogram of the time spent with interrupts locked
+ *
+ * @return N/A
+ *
+ */
+static void int_latency_histogram_show(void)
+{
+	uint32_t average = (uint32_t)(int_locked_total / int_locked_count);
+	int i;
+
+	printk(" Interrupts locked %d times, average %d tcs = %d nsec\n",
+	       int_locked_count, average, SYS_CLOCK_HW_CYCLES_TO_NS(average));
+
+	for (i = 0; i < INT_LOCKED_HISTOGRAM_BUCKETS; i++) {
+		if (int_locked_histogram[i] == 0) {
+			continue;
+		}
+
+		printk("  %10u - %10u tcs: %d\n",
+		       i ? 1u << (i - 1) : 0, (uint32_t)((1ULL << i) - 1),
+		       int_locked_histogram[i]);
+	}
+}
+
+/**
+ *
+ * @brief Dumps the code paths which locked interrupts for the longest time
+ *
+ * The callers of irq_lock() are printed as addresses, which can be resolved
+ * with addr2line on the host.
+ *
+ * @return N/A
+ *
+ */
+static void int_latency_sites_show(void)
+{
+	int i;
+
+	printk(" Longest interrupt locking callers:\n");
+
+	for (i = 0; i < ARRAY_SIZE(int_locked_sites); i++) {
+		if (int_locked_sites[i].count == 0) {
+			continue;
+		}
+
+		printk("  %p: max %d tcs = %d nsec, %d times\n",
+		       int_locked_sites[i].caller, int_locked_sites[i].max,
+		       SYS_CLOCK_HW_CYCLES_TO_NS(int_locked_sites[i].max),
+		       int_locked_sites[i].count);
+	}
+}
+
 /**
  *
  * @brief Dumps interrupt latency values
@@ -222,6 +371,9 @@ void int_latency_show(void)
 		       SYS_CLOCK_HW_CYCLES_TO_NS(nesting_delay),
 		       stop_delay,
 		       SYS_CLOCK_HW_CYCLES_TO_NS(stop_delay));
+
+		int_latency_histogram_show();
+		int_latency_sites_show();
 	} else {
 		printk("interrupts were not locked and unlocked yet\n");
 	}
@@ -230,6 +382,5 @@ void int_latency_show(void)
 	 * with interrupt disabled hide smaller paths with interrupt
 	 * disabled.
 	 */
-	int_locked_latency_min = ULONG_MAX;
-	int_locked_latency_max = 0;
+	int_latency_reset();
 }
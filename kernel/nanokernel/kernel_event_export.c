@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief Kernel event export
+ *
+ * A fiber collects the kernel event messages and streams them in binary
+ * form, see the stream format in kernel_event_logger.h.
+ */
+
+#include <nanokernel.h>
+#include <misc/kernel_event_logger.h>
+#include <misc/util.h>
+#include <init.h>
+#include <string.h>
+#include <stddef.h>
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_EXPORT_UART_PIPE
+#include <console/uart_pipe.h>
+#endif
+
+struct export_record {
+	uint16_t event_id;
+	uint8_t dropped;
+	uint8_t size32;
+	/* event messages are at most UINT8_MAX words long */
+	uint32_t data[UINT8_MAX];
+};
+
+static char __stack export_stack[CONFIG_KERNEL_EVENT_LOGGER_EXPORT_STACK_SIZE];
+
+static struct export_record record;
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_EXPORT_UART_PIPE
+
+/* data received on the pipe UART is ignored */
+static uint8_t recv_buf[1];
+
+static uint8_t *export_recv(uint8_t *buf, size_t *off)
+{
+	*off = 0;
+	return buf;
+}
+
+static void export_start(void)
+{
+	uart_pipe_register(recv_buf, sizeof(recv_buf), export_recv);
+}
+
+static void export_write(const uint8_t *data, int len)
+{
+	uart_pipe_send(data, len);
+}
+
+#else /* CONFIG_KERNEL_EVENT_LOGGER_EXPORT_RAM */
+
+uint8_t sys_k_event_export_ram[CONFIG_KERNEL_EVENT_LOGGER_EXPORT_RAM_SIZE];
+uint32_t sys_k_event_export_ram_used;
+
+static inline void export_start(void)
+{
+}
+
+static void export_write(const uint8_t *data, int len)
+{
+	/* records are never truncated: drop the ones that do not fit */
+	if ((uint32_t)len >
+	    sizeof(sys_k_event_export_ram) - sys_k_event_export_ram_used) {
+		return;
+	}
+
+	memcpy(&sys_k_event_export_ram[sys_k_event_export_ram_used], data, len);
+	sys_k_event_export_ram_used += len;
+}
+
+#endif /* CONFIG_KERNEL_EVENT_LOGGER_EXPORT_UART_PIPE */
+
+static void export_record_write(void)
+{
+	export_write((const uint8_t *)&record,
+		     offsetof(struct export_record, data) +
+		     record.size32 * sizeof(uint32_t));
+}
+
+static void export_fiber_main(int arg1, int arg2)
+{
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+
+	/* the export fiber does not log its own context switches */
+	sys_k_event_logger_register_as_collector();
+
+	export_start();
+
+	record.event_id = KERNEL_EVENT_LOGGER_EXPORT_HEADER_EVENT_ID;
+	record.dropped = 0;
+	record.size32 = 4;
+	record.data[0] = KERNEL_EVENT_LOGGER_EXPORT_MAGIC;
+	record.data[1] = KERNEL_EVENT_LOGGER_EXPORT_VERSION;
+	record.data[2] = sys_clock_ticks_per_sec;
+	record.data[3] = sys_clock_hw_cycles_per_tick;
+	export_record_write();
+
+	while (1) {
+		record.size32 = ARRAY_SIZE(record.data);
+
+		if (sys_k_event_logger_get_wait(&record.event_id,
+						&record.dropped, record.data,
+						&record.size32) < 0) {
+			continue;
+		}
+
+		export_record_write();
+	}
+}
+
+static int kernel_event_export_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	fiber_start(export_stack, sizeof(export_stack), export_fiber_main,
+		    0, 0, CONFIG_KERNEL_EVENT_LOGGER_EXPORT_PRIORITY, 0);
+
+	return 0;
+}
+
+SYS_INIT(kernel_event_export_init, APPLICATION,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ * @brief Per-thread CPU time accounting
+ *
+ * Each context switch charges the outgoing thread for the hardware clock
+ * cycles elapsed since the previous one.
+ */
+
+#include <nano_private.h>
+
+/* cycle count when the current thread was switched in */
+static uint32_t switch_in_cycles;
+
+/**
+ *
+ * @brief Charge the current thread for the time it ran
+ *
+ * Called by _Swap() with interrupts locked, before the current thread is
+ * switched out. The 32-bit cycle count difference is exact as long as the
+ * thread ran for less than a wrap of the hardware clock.
+ *
+ * @return N/A
+ */
+void _sys_thread_cpu_accounting_switch(void)
+{
+	uint32_t now = sys_cycle_get_32();
+
+	_nanokernel.current->cpu_cycles += now - switch_in_cycles;
+	switch_in_cycles = now;
+}
+
+static uint64_t thread_cpu_cycles(struct tcs *thread)
+{
+	uint64_t cycles = thread->cpu_cycles;
+
+	/* add the time the current thread has been running since switched in */
+	if (thread == _nanokernel.current) {
+		cycles += sys_cycle_get_32() - switch_in_cycles;
+	}
+
+	return cycles;
+}
+
+uint64_t sys_thread_cpu_cycles_get(nano_thread_id_t thread)
+{
+	unsigned int key = irq_lock();
+	uint64_t cycles = thread_cpu_cycles(thread);
+
+	irq_unlock(key);
+
+	return cycles;
+}
+
+#ifdef CONFIG_THREAD_MONITOR
+int sys_thread_cpu_usage_get(struct sys_thread_cpu_usage *usage, int max)
+{
+	unsigned int key = irq_lock();
+	struct tcs *thread;
+	int count = 0;
+
+	for (thread = _nanokernel.threads; thread != NULL;
+	     thread = thread->next_thread) {
+		if (count < max) {
+			usage[count].thread = thread;
+			usage[count].cycles = thread_cpu_cycles(thread);
+		}
+		count++;
+	}
+
+	irq_unlock(key);
+
+	return count;
+}
+#endif /* CONFIG_THREAD_MONITOR */
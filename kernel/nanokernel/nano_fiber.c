@@ -28,6 +28,124 @@
 #include <toolchain.h>
 #include <sections.h>
 
+#ifdef CONFIG_NANO_FIBER_PRIO_QUEUE
+
+#define FIBER_PRIO_LEVELS CONFIG_NUM_FIBER_PRIORITIES
+#define FIBER_PRIO_WORDS ((FIBER_PRIO_LEVELS + 31) / 32)
+
+/*
+ * The list of runnable fibers is still a single linked list in priority
+ * order, since the architecture-specific _Swap() code takes the next fiber
+ * from its head. The list is indexed by remembering the last fiber of each
+ * priority level, along with a bitmap of the levels that are non-empty.
+ *
+ * Fibers are only ever removed from the head of the list, so the levels
+ * emptied by _Swap() are exactly those of higher priority than the fiber
+ * now at the head of the list: they are discarded lazily on insertion.
+ */
+
+static struct tcs *_fiber_prio_tail[FIBER_PRIO_LEVELS];
+static uint32_t _fiber_prio_bitmap[FIBER_PRIO_WORDS];
+
+static inline int _fiber_prio_level(struct tcs *tcs)
+{
+	/* all fibers of priority N-1 or lower share the last level */
+
+	return ((unsigned int)tcs->prio < (FIBER_PRIO_LEVELS - 1)) ?
+		tcs->prio : (FIBER_PRIO_LEVELS - 1);
+}
+
+static inline void _fiber_prio_sync(void)
+{
+	int level = FIBER_PRIO_LEVELS;
+	int word;
+
+	if (_nanokernel.fiber) {
+		level = _fiber_prio_level(_nanokernel.fiber);
+	}
+
+	for (word = 0; word < (level >> 5); word++) {
+		_fiber_prio_bitmap[word] = 0;
+	}
+
+	if (level & 0x1f) {
+		_fiber_prio_bitmap[level >> 5] &= ~((1U << (level & 0x1f)) - 1);
+	}
+}
+
+/*
+ * Return the lowest priority non-empty level that is of higher priority
+ * than 'level', or -1 if there is none.
+ */
+static inline int _fiber_prio_level_above(int level)
+{
+	int word = level >> 5;
+	uint32_t bits = _fiber_prio_bitmap[word] & ((1U << (level & 0x1f)) - 1);
+
+	while (!bits) {
+		if (--word < 0) {
+			return -1;
+		}
+		bits = _fiber_prio_bitmap[word];
+	}
+
+	return (word << 5) + find_msb_set(bits) - 1;
+}
+
+/**
+ *
+ * @brief Add a fiber to the list of runnable fibers
+ *
+ * The list of runnable fibers is maintained via a single linked list
+ * in priority order. Numerically lower priorities represent higher priority
+ * fibers. The insertion point is located in constant time by means of the
+ * per-priority index, except among fibers sharing the last priority level.
+ *
+ * Interrupts must already be locked to ensure list cannot change
+ * while this routine is executing!
+ *
+ * @return N/A
+ */
+void _nano_fiber_ready(struct tcs *tcs)
+{
+	struct tcs *pQ = (struct tcs *)&_nanokernel.fiber;
+	int level = _fiber_prio_level(tcs);
+	int above;
+
+	_fiber_prio_sync();
+
+	if ((level < (FIBER_PRIO_LEVELS - 1)) &&
+	    (_fiber_prio_bitmap[level >> 5] & (1U << (level & 0x1f)))) {
+		pQ = _fiber_prio_tail[level];
+	} else {
+		above = _fiber_prio_level_above(level);
+		if (above >= 0) {
+			pQ = _fiber_prio_tail[above];
+		}
+	}
+
+	/*
+	 * Skip fibers of equal priority; this only iterates over fibers
+	 * sharing the last priority level.
+	 */
+
+	while (pQ->link && (tcs->prio >= pQ->link->prio)) {
+		pQ = pQ->link;
+	}
+
+	/* Insert fiber, following any equal priority fibers */
+
+	tcs->link = pQ->link;
+	pQ->link = tcs;
+
+	if (!tcs->link || (_fiber_prio_level(tcs->link) != level)) {
+		_fiber_prio_tail[level] = tcs;
+	}
+	_fiber_prio_bitmap[level >> 5] |= (1U << (level & 0x1f));
+}
+
+#else
+
 /**
  *
  * @brief Add a fiber to the list of runnable fibers
@@ -60,6 +178,7 @@ void _nano_fiber_ready(struct tcs *tcs)
 	pQ->link = tcs;
 }
 
+#endif /* CONFIG_NANO_FIBER_PRIO_QUEUE */
 
 /* currently the fiber and task implementations are identical */
 
@@ -66,10 +66,18 @@ void nano_fifo_init(struct nano_fifo *fifo)
 	 */
 
 	fifo->stat = 0;
+	_NANO_POLL_INIT(fifo);
 
 	SYS_TRACING_OBJ_INIT(nano_fifo, fifo);
 }
 
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+void nano_fifo_wait_prio_set(struct nano_fifo *fifo)
+{
+	_nano_wait_q_prio_set(&fifo->wait_q);
+}
+#endif
+
 FUNC_ALIAS(_fifo_put_non_preemptible, nano_isr_fifo_put, void);
 FUNC_ALIAS(_fifo_put_non_preemptible, nano_fiber_fifo_put, void);
 
@@ -122,6 +130,7 @@ void _fifo_put_non_preemptible(struct nano_fifo *fifo, void *data)
 		fiberRtnValueSet(tcs, (unsigned int)data);
 	} else {
 		enqueue_data(fifo, data);
+		(void)_NANO_POLL_SIGNAL(fifo);
 	}
 
 	irq_unlock(imask);
@@ -144,6 +153,10 @@ void nano_task_fifo_put(struct nano_fifo *fifo, void *data)
 	}
 
 	enqueue_data(fifo, data);
+	if (_NANO_POLL_SIGNAL(fifo)) {
+		_Swap(imask);
+		return;
+	}
 
 	irq_unlock(imask);
 }
@@ -82,7 +82,15 @@ char __noinit __stack main_task_stack[CONFIG_MAIN_STACK_SIZE];
 
 char __noinit _interrupt_stack[CONFIG_ISR_STACK_SIZE];
 
-#if defined(CONFIG_NANO_TIMEOUTS) || defined(CONFIG_NANO_TIMERS)
+#if (defined(CONFIG_NANO_TIMEOUTS) || defined(CONFIG_NANO_TIMERS)) && \
+	defined(CONFIG_TIMEOUT_WHEEL)
+	#include <timeout_wheel.h>
+	extern struct _timeout_wheel _nano_timeout_wheel;
+	#define initialize_nano_timeouts() do { \
+		_timeout_wheel_init(&_nano_timeout_wheel); \
+		_nanokernel.task_timeout = TICKS_UNLIMITED; \
+	} while ((0))
+#elif defined(CONFIG_NANO_TIMEOUTS) || defined(CONFIG_NANO_TIMERS)
 	#include <misc/dlist.h>
 	#define initialize_nano_timeouts() do { \
 		sys_dlist_init(&_nanokernel.timeout_q); \
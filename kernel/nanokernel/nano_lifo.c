@@ -48,10 +48,18 @@
 void nano_lifo_init(struct nano_lifo *lifo)
 {
 	lifo->list = (void *) 0;
+	_NANO_POLL_INIT(lifo);
 	_nano_wait_q_init(&lifo->wait_q);
 	SYS_TRACING_OBJ_INIT(nano_lifo, lifo);
 }
 
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+void nano_lifo_wait_prio_set(struct nano_lifo *lifo)
+{
+	_nano_wait_q_prio_set(&lifo->wait_q);
+}
+#endif
+
 FUNC_ALIAS(_lifo_put_non_preemptible, nano_isr_lifo_put, void);
 FUNC_ALIAS(_lifo_put_non_preemptible, nano_fiber_lifo_put, void);
 
@@ -75,6 +83,7 @@ void _lifo_put_non_preemptible(struct nano_lifo *lifo, void *data)
 	} else {
 		*(void **) data = lifo->list;
 		lifo->list = data;
+		(void)_NANO_POLL_SIGNAL(lifo);
 	}
 
 	irq_unlock(imask);
@@ -96,6 +105,10 @@ void nano_task_lifo_put(struct nano_lifo *lifo, void *data)
 
 	*(void **) data = lifo->list;
 	lifo->list = data;
+	if (_NANO_POLL_SIGNAL(lifo)) {
+		_Swap(imask);
+		return;
+	}
 
 	irq_unlock(imask);
 }
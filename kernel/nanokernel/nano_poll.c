@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ *
+ * Nanokernel multi-object wait: a fiber registers itself on each polled
+ * object, and the first object that becomes ready, or the poll timeout, makes
+ * it ready again.
+ */
+
+#include <nano_private.h>
+#include <wait_q.h>
+#include <errno.h>
+#include <misc/__assert.h>
+#include <misc/nano_poll.h>
+
+/* a fiber waiting in nano_fiber_poll() */
+struct _nano_poller {
+	/* reset by whichever wakes up the fiber first */
+	struct tcs *tcs;
+#ifdef CONFIG_NANO_TIMEOUTS
+	struct _nano_timeout timeout;
+#endif
+};
+
+static int event_is_ready(struct nano_poll_event *event)
+{
+	switch (event->type) {
+	case NANO_POLL_TYPE_SEM:
+		return ((struct nano_sem *)event->obj)->nsig > 0;
+	case NANO_POLL_TYPE_FIFO:
+		return ((struct nano_fifo *)event->obj)->stat > 0;
+	case NANO_POLL_TYPE_LIFO:
+		return ((struct nano_lifo *)event->obj)->list != NULL;
+#ifdef CONFIG_NANO_TIMERS
+	case NANO_POLL_TYPE_TIMER:
+		return ((struct nano_timer *)event->obj)->expired;
+#endif
+	default:
+		return 0;
+	}
+}
+
+static struct nano_poll_event **event_slot(struct nano_poll_event *event)
+{
+	switch (event->type) {
+	case NANO_POLL_TYPE_SEM:
+		return &((struct nano_sem *)event->obj)->poll_event;
+	case NANO_POLL_TYPE_FIFO:
+		return &((struct nano_fifo *)event->obj)->poll_event;
+	case NANO_POLL_TYPE_LIFO:
+		return &((struct nano_lifo *)event->obj)->poll_event;
+#ifdef CONFIG_NANO_TIMERS
+	case NANO_POLL_TYPE_TIMER:
+		return &((struct nano_timer *)event->obj)->poll_event;
+#endif
+	default:
+		return NULL;
+	}
+}
+
+/* return the index of the first ready event, -EAGAIN if none is ready */
+static int ready_event_find(struct nano_poll_event *events, int num_events)
+{
+	int i;
+
+	for (i = 0; i < num_events; i++) {
+		if (event_is_ready(&events[i])) {
+			return i;
+		}
+	}
+
+	return -EAGAIN;
+}
+
+int _nano_poll_signal(struct nano_poll_event *event)
+{
+	struct _nano_poller *poller = event->poller;
+	struct tcs *tcs = poller->tcs;
+
+	if (!tcs) {
+		/* already woken up by another object or by the timeout */
+		return 0;
+	}
+
+	poller->tcs = NULL;
+	_nano_fiber_ready(tcs);
+
+	return 1;
+}
+
+#ifdef CONFIG_NANO_TIMERS
+/*
+ * Called from the tick handler when a timer expires, polled or not: the
+ * user data of the timer may be NULL, so it cannot tell the expiry.
+ */
+void _nano_poll_timer_expired(struct _nano_timeout *t)
+{
+	struct nano_timer *timer = CONTAINER_OF(t, struct nano_timer,
+						timeout_data);
+
+	timer->expired = 1;
+
+	if (timer->poll_event) {
+		_nano_poll_signal(timer->poll_event);
+	}
+}
+#endif
+
+#ifdef CONFIG_NANO_TIMEOUTS
+/* called from the tick handler when the poll timeout expires */
+static void poll_timeout(struct _nano_timeout *t)
+{
+	struct _nano_poller *poller = CONTAINER_OF(t, struct _nano_poller,
+						   timeout);
+
+	if (poller->tcs) {
+		_nano_fiber_ready(poller->tcs);
+		poller->tcs = NULL;
+	}
+}
+#endif
+
+static void events_unregister(struct nano_poll_event *events, int num_events)
+{
+	int i;
+
+	for (i = 0; i < num_events; i++) {
+		*event_slot(&events[i]) = NULL;
+		events[i].poller = NULL;
+	}
+}
+
+static int events_register(struct nano_poll_event *events, int num_events,
+			   struct _nano_poller *poller)
+{
+	int i;
+
+	for (i = 0; i < num_events; i++) {
+		struct nano_poll_event **slot = event_slot(&events[i]);
+
+		__ASSERT(slot, "invalid poll event type %d\n", events[i].type);
+
+		if (*slot) {
+			events_unregister(events, i);
+			return -EADDRINUSE;
+		}
+
+		*slot = &events[i];
+		events[i].poller = poller;
+	}
+
+	return 0;
+}
+
+FUNC_ALIAS(_poll, nano_isr_poll, int);
+FUNC_ALIAS(_poll, nano_fiber_poll, int);
+
+int _poll(struct nano_poll_event *events, int num_events,
+	  int32_t timeout_in_ticks)
+{
+	struct _nano_poller poller;
+	unsigned int key = irq_lock();
+	int rc;
+
+	rc = ready_event_find(events, num_events);
+	if (rc >= 0 || timeout_in_ticks == TICKS_NONE) {
+		irq_unlock(key);
+		return rc;
+	}
+
+	/*
+	 * Another thread may take the object before this fiber runs: wait
+	 * again if there is no timeout to report.
+	 */
+	do {
+		rc = events_register(events, num_events, &poller);
+		if (rc) {
+			irq_unlock(key);
+			return rc;
+		}
+
+		poller.tcs = _nanokernel.current;
+#ifdef CONFIG_NANO_TIMEOUTS
+		_nano_timeout_init(&poller.timeout, poll_timeout);
+		if (timeout_in_ticks != TICKS_UNLIMITED) {
+			_do_nano_timeout_add(NULL, &poller.timeout, NULL,
+					     timeout_in_ticks);
+		}
+#endif
+
+		_Swap(key);
+
+		key = irq_lock();
+#ifdef CONFIG_NANO_TIMEOUTS
+		_do_nano_timeout_abort(&poller.timeout);
+#endif
+		events_unregister(events, num_events);
+
+		rc = ready_event_find(events, num_events);
+	} while (rc < 0 && timeout_in_ticks == TICKS_UNLIMITED);
+
+	irq_unlock(key);
+
+	return rc;
+}
+
+/*
+ * INTERNAL
+ * Since a task cannot pend on a nanokernel object, it checks the objects
+ * each time it is woken up from idle.
+ */
+int nano_task_poll(struct nano_poll_event *events, int num_events,
+		   int32_t timeout_in_ticks)
+{
+	int64_t cur_ticks;
+	int64_t limit = 0x7fffffffffffffffll;
+	unsigned int key;
+	int rc;
+
+	key = irq_lock();
+	cur_ticks = _NANO_TIMEOUT_TICK_GET();
+	if (timeout_in_ticks != TICKS_UNLIMITED) {
+		limit = cur_ticks + timeout_in_ticks;
+	}
+
+	do {
+		rc = ready_event_find(events, num_events);
+		if (rc >= 0) {
+			break;
+		}
+
+		if (timeout_in_ticks != TICKS_NONE) {
+			_NANO_TIMEOUT_SET_TASK_TIMEOUT(timeout_in_ticks);
+
+			/* see explanation in
+			 * nano_stack.c:nano_task_stack_pop()
+			 */
+			nano_cpu_atomic_idle(key);
+
+			key = irq_lock();
+			cur_ticks = _NANO_TIMEOUT_TICK_GET();
+		}
+	} while (cur_ticks < limit);
+
+	irq_unlock(key);
+	return rc;
+}
+
+int nano_poll(struct nano_poll_event *events, int num_events,
+	      int32_t timeout_in_ticks)
+{
+	static int (*func[3])(struct nano_poll_event *, int, int32_t) = {
+		nano_isr_poll,
+		nano_fiber_poll,
+		nano_task_poll
+	};
+
+	return func[sys_execution_context_type_get()](events, num_events,
+						      timeout_in_ticks);
+}
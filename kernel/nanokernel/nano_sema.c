@@ -55,10 +55,18 @@
 void nano_sem_init(struct nano_sem *sem)
 {
 	sem->nsig = 0;
+	_NANO_POLL_INIT(sem);
 	_nano_wait_q_init(&sem->wait_q);
 	SYS_TRACING_OBJ_INIT(nano_sem, sem);
 }
 
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+void nano_sem_wait_prio_set(struct nano_sem *sem)
+{
+	_nano_wait_q_prio_set(&sem->wait_q);
+}
+#endif
+
 FUNC_ALIAS(_sem_give_non_preemptible, nano_isr_sem_give, void);
 FUNC_ALIAS(_sem_give_non_preemptible, nano_fiber_sem_give, void);
 
@@ -84,6 +92,7 @@ void _sem_give_non_preemptible(struct nano_sem *sem)
 	tcs = _nano_wait_q_remove(&sem->wait_q);
 	if (!tcs) {
 		sem->nsig++;
+		(void)_NANO_POLL_SIGNAL(sem);
 	} else {
 		_nano_timeout_abort(tcs);
 		set_sem_available(tcs);
@@ -107,6 +116,10 @@ void nano_task_sem_give(struct nano_sem *sem)
 	}
 
 	sem->nsig++;
+	if (_NANO_POLL_SIGNAL(sem)) {
+		_Swap(imask);
+		return;
+	}
 
 	irq_unlock(imask);
 }
@@ -153,6 +153,15 @@ uint32_t sys_tick_delta_32(int64_t *reftime)
 #if defined(CONFIG_NANO_TIMEOUTS) || defined(CONFIG_NANO_TIMERS)
 #include <wait_q.h>
 
+#ifdef CONFIG_TIMEOUT_WHEEL
+struct _timeout_wheel _nano_timeout_wheel;
+
+static inline void handle_expired_nano_timeouts(int32_t ticks)
+{
+	_nanokernel.task_timeout = TICKS_UNLIMITED;
+	_nano_timeout_handle_timeouts(ticks);
+}
+#else
 static inline void handle_expired_nano_timeouts(int32_t ticks)
 {
 	struct _nano_timeout *head =
@@ -164,17 +173,60 @@ static inline void handle_expired_nano_timeouts(int32_t ticks)
 		_nano_timeout_handle_timeouts();
 	}
 }
+#endif /* CONFIG_TIMEOUT_WHEEL */
 #else
 	#define handle_expired_nano_timeouts(ticks) do { } while ((0))
 #endif
 
+#ifdef CONFIG_NANO_TIMESLICING
+static int32_t slice_ticks = CONFIG_NANO_TIMESLICE_SIZE;
+static int slice_prio = CONFIG_NANO_TIMESLICE_PRIORITY;
+
+void sys_fiber_time_slice_set(int32_t ticks, int prio)
+{
+	slice_ticks = ticks;
+	slice_prio = prio;
+}
+
+/*
+ * Charge the elapsed ticks to the interrupted fiber. Once its time slice has
+ * expired, put it back in the runnable fiber list behind the fibers of equal
+ * priority, and flag it so that the interrupt exit code swaps it out. The
+ * flag stays set until the fiber is actually switched out: a tick announced
+ * in between must not queue the fiber a second time.
+ */
+static inline void update_time_slice(int32_t ticks)
+{
+	struct tcs *fiber = _nanokernel.current;
+
+	if (!slice_ticks || ((fiber->flags & TASK) == TASK) ||
+	    (fiber->prio < slice_prio) || (fiber->flags & SLICE_EXPIRED)) {
+		return;
+	}
+
+	fiber->slice_ticks += ticks;
+	if (fiber->slice_ticks < slice_ticks) {
+		return;
+	}
+
+	if (_nanokernel.fiber && (fiber->prio >= _nanokernel.fiber->prio)) {
+		fiber->slice_ticks = 0;
+		fiber->flags |= SLICE_EXPIRED;
+		_nano_fiber_ready(fiber);
+	}
+}
+#else
+	#define update_time_slice(ticks) do { } while ((0))
+#endif /* CONFIG_NANO_TIMESLICING */
+
 /**
  *
  * @brief Announce a tick to the nanokernel
  *
  * This function is only to be called by the system clock timer driver when a
  * tick is to be announced to the nanokernel. It takes care of dequeuing the
- * timers that have expired and wake up the fibers pending on them.
+ * timers that have expired and wake up the fibers pending on them, and of
+ * the time slicing of the fibers.
  *
  * @return N/A
  */
@@ -185,6 +237,7 @@ void _nano_sys_clock_tick_announce(int32_t ticks)
 	key = irq_lock();
 	_sys_clock_tick_count += ticks;
 	handle_expired_nano_timeouts(ticks);
+	update_time_slice(ticks);
 	irq_unlock(key);
 }
 
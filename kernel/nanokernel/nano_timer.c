@@ -31,11 +31,17 @@ void nano_timer_init(struct nano_timer *timer, void *data)
 	/* initialize to no fiber waiting for the timer expire */
 	timer->timeout_data.tcs = NULL;
 
+	/* initialize to no expiry callback, other than the polling one */
+	timer->timeout_data.func = _NANO_POLL_TIMER_FUNC;
+
 	/* nano_timer_test() returns NULL on timer that was not started */
 	timer->user_data = NULL;
+	_NANO_POLL_TIMER_EXPIRED_SET(timer, 0);
 
 	timer->user_data_backup = data;
 
+	_NANO_POLL_INIT(timer);
+
 	SYS_TRACING_OBJ_INIT(nano_timer, timer);
 }
 
@@ -66,6 +72,7 @@ void _timer_start(struct nano_timer *timer, int ticks)
 	 * the pointer to user data
 	 */
 	timer->user_data = timer->user_data_backup;
+	_NANO_POLL_TIMER_EXPIRED_SET(timer, 0);
 	_nano_timer_timeout_add(&timer->timeout_data,
 				NULL, ticks);
 	irq_unlock(key);
@@ -95,6 +102,7 @@ void _timer_stop_non_preemptible(struct nano_timer *timer)
 	 * return NULL until timer gets restarted
 	 */
 	timer->user_data = NULL;
+	_NANO_POLL_TIMER_EXPIRED_SET(timer, 0);
 	irq_unlock(key);
 }
 
@@ -105,6 +113,7 @@ void nano_task_timer_stop(struct nano_timer *timer)
 	int key = irq_lock();
 
 	timer->user_data = NULL;
+	_NANO_POLL_TIMER_EXPIRED_SET(timer, 0);
 
 	/*
 	 * Verify first if fiber is not waiting on an object,
@@ -156,6 +165,7 @@ static int _nano_timer_expire_wait(struct nano_timer *timer,
 	if (t->delta_ticks_from_prev == -1) {
 		*user_data_ptr = timer->user_data;
 		timer->user_data = NULL;
+		_NANO_POLL_TIMER_EXPIRED_SET(timer, 0);
 	/* if the thread should not wait, return immediately */
 	} else if (timeout_in_ticks == TICKS_NONE) {
 		*user_data_ptr = NULL;
@@ -190,6 +200,7 @@ void *nano_fiber_timer_test(struct nano_timer *timer, int32_t timeout_in_ticks)
 		key = irq_lock();
 		user_data = timer->user_data;
 		timer->user_data = NULL;
+		_NANO_POLL_TIMER_EXPIRED_SET(timer, 0);
 	}
 	irq_unlock(key);
 	return user_data;
@@ -211,6 +222,7 @@ void *nano_task_timer_test(struct nano_timer *timer, int32_t timeout_in_ticks)
 		}
 		user_data = timer->user_data;
 		timer->user_data = NULL;
+		_NANO_POLL_TIMER_EXPIRED_SET(timer, 0);
 	}
 	irq_unlock(key);
 	return user_data;
@@ -232,12 +244,18 @@ int32_t nano_timer_ticks_remain(struct nano_timer *timer)
 	int key = irq_lock();
 	int32_t remaining_ticks;
 	struct _nano_timeout *t = &timer->timeout_data;
+#ifndef CONFIG_TIMEOUT_WHEEL
 	sys_dlist_t *timeout_q = &_nanokernel.timeout_q;
 	struct _nano_timeout *iterator;
+#endif
 
 	if (t->delta_ticks_from_prev == -1) {
 		remaining_ticks = 0;
 	} else {
+#ifdef CONFIG_TIMEOUT_WHEEL
+		remaining_ticks = _timeout_wheel_remaining(&_nano_timeout_wheel,
+							   &t->node);
+#else
 		/*
 		 * As nanokernel timeouts are stored in a linked list with
 		 * delta_ticks_from_prev, to get the actual number of ticks
@@ -253,6 +271,7 @@ int32_t nano_timer_ticks_remain(struct nano_timer *timer)
 				timeout_q, &iterator->node);
 			remaining_ticks += iterator->delta_ticks_from_prev;
 		}
+#endif
 	}
 
 	irq_unlock(key);
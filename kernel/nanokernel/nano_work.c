@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file
+ *
+ * Nanokernel work queues: fibers running work items submitted from any
+ * context, optionally after a delay.
+ */
+
+#include <nano_private.h>
+#include <wait_q.h>
+#include <init.h>
+#include <errno.h>
+#include <misc/nano_work.h>
+
+static void workqueue_fiber_main(int arg1, int arg2)
+{
+	struct nano_workqueue *wq = (struct nano_workqueue *)arg1;
+
+	ARG_UNUSED(arg2);
+
+	while (1) {
+		struct nano_work *work;
+
+		work = nano_fiber_fifo_get(&wq->fifo, TICKS_UNLIMITED);
+
+		/*
+		 * The work item can be queued again from now on; clear the
+		 * pending state last, so that a submission made before the
+		 * handler runs is not lost.
+		 */
+		atomic_clear_bit(work->flags, NANO_WORK_STATE_QUEUED);
+
+		if (atomic_test_and_clear_bit(work->flags,
+					      NANO_WORK_STATE_PENDING)) {
+			work->handler(work);
+		}
+
+		/* let other fibers of the same priority run between items */
+		fiber_yield();
+	}
+}
+
+void nano_workqueue_start(struct nano_workqueue *wq, char *stack,
+			  unsigned stack_size, unsigned prio)
+{
+	nano_fifo_init(&wq->fifo);
+
+	fiber_start(stack, stack_size, workqueue_fiber_main,
+		    (int)wq, 0, prio, 0);
+}
+
+int nano_work_cancel(struct nano_work *work)
+{
+	/* a cancelled work item still in the fifo is skipped by the fiber */
+	if (!atomic_test_and_clear_bit(work->flags, NANO_WORK_STATE_PENDING)) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+#if defined(CONFIG_NANO_TIMEOUTS)
+
+/* called from the tick handler when the delay of a work item expires */
+static void work_timeout(struct _nano_timeout *t)
+{
+	struct nano_delayed_work *w;
+
+	w = CONTAINER_OF(t, struct nano_delayed_work, timeout);
+
+	nano_work_submit_to_queue(w->wq, &w->work);
+}
+
+void nano_delayed_work_init(struct nano_delayed_work *work,
+			    work_handler_t handler)
+{
+	nano_work_init(&work->work, handler);
+	_nano_timeout_init(&work->timeout, work_timeout);
+	work->wq = NULL;
+}
+
+int nano_delayed_work_submit_to_queue(struct nano_workqueue *wq,
+				      struct nano_delayed_work *work,
+				      int ticks)
+{
+	unsigned int key = irq_lock();
+	int err = 0;
+
+	if ((work->wq != NULL) && (work->wq != wq) &&
+	    ((work->timeout.delta_ticks_from_prev != -1) ||
+	     atomic_test_bit(work->work.flags, NANO_WORK_STATE_QUEUED))) {
+		err = -EADDRINUSE;
+		goto done;
+	}
+
+	/* reschedule the work item if its delay has not expired yet */
+	_do_nano_timeout_abort(&work->timeout);
+
+	work->wq = wq;
+
+	if (ticks <= 0) {
+		nano_work_submit_to_queue(wq, &work->work);
+	} else {
+		_do_nano_timeout_add(NULL, &work->timeout, NULL, ticks);
+	}
+
+done:
+	irq_unlock(key);
+	return err;
+}
+
+int nano_delayed_work_cancel(struct nano_delayed_work *work)
+{
+	unsigned int key = irq_lock();
+	int cancelled;
+
+	cancelled = (_do_nano_timeout_abort(&work->timeout) == 0);
+
+	if (atomic_test_and_clear_bit(work->work.flags,
+				      NANO_WORK_STATE_PENDING)) {
+		cancelled = 1;
+	}
+
+	irq_unlock(key);
+
+	return cancelled ? 0 : -EINVAL;
+}
+
+#endif /* CONFIG_NANO_TIMEOUTS */
+
+#if defined(CONFIG_SYSTEM_WORKQUEUE)
+
+static char __stack sys_workqueue_stack[CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE];
+
+struct nano_workqueue sys_workqueue;
+
+static int sys_workqueue_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	nano_workqueue_start(&sys_workqueue, sys_workqueue_stack,
+			     sizeof(sys_workqueue_stack),
+			     CONFIG_SYSTEM_WORKQUEUE_PRIORITY);
+
+	return 0;
+}
+
+SYS_INIT(sys_workqueue_init, NANOKERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+#endif /* CONFIG_SYSTEM_WORKQUEUE */
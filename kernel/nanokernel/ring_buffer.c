@@ -30,48 +30,118 @@ struct ring_element {
 	uint32_t  value  :8;  /**< Room for small integral values */
 };
 
+/*
+ * Index loads and stores ordering the accesses to the entries around them:
+ * the atomic routines are compiler barriers. The producer releases the tail
+ * index once an entry is written, and the consumer acquires it before reading
+ * the entry; the other way around for the head index.
+ */
+#ifdef CONFIG_RING_BUFFER_LOCK_FREE
+#define INDEX_ACQUIRE(index) ((uint32_t)atomic_get((atomic_t *)&(index)))
+#define INDEX_RELEASE(index, val) atomic_set((atomic_t *)&(index), (val))
+#else
+#define INDEX_ACQUIRE(index) (index)
+#define INDEX_RELEASE(index, val) ((index) = (val))
+#endif
+
+static inline uint32_t index_add(struct ring_buf *buf, uint32_t index,
+				 uint32_t count)
+{
+	if (likely(buf->mask)) {
+		return (index + count) & buf->mask;
+	}
+
+	return (index + count) % buf->size;
+}
+
+static void entry_write(struct ring_buf *buf, uint32_t index, uint16_t type,
+			uint8_t value, uint32_t *data, uint8_t size32)
+{
+	struct ring_element *header = (struct ring_element *)&buf->buf[index];
+	uint32_t i;
+
+	header->type = type;
+	header->length = size32;
+	header->value = value;
+
+	for (i = 0; i < size32; ++i) {
+		buf->buf[index_add(buf, index, i + 1)] = data[i];
+	}
+}
+
 int sys_ring_buf_put(struct ring_buf *buf, uint16_t type, uint8_t value,
 		     uint32_t *data, uint8_t size32)
 {
-	uint32_t i, space, index, rc;
+	uint32_t space;
 
 	space = sys_ring_buf_space_get(buf);
-	if (space >= (size32 + 1)) {
-		struct ring_element *header =
-				(struct ring_element *)&buf->buf[buf->tail];
-		header->type = type;
-		header->length = size32;
-		header->value = value;
-
-		if (likely(buf->mask)) {
-			for (i = 0; i < size32; ++i) {
-				index = (i + buf->tail + 1) & buf->mask;
-				buf->buf[index] = data[i];
-			}
-			buf->tail = (buf->tail + size32 + 1) & buf->mask;
+	if (space < (size32 + 1)) {
+		buf->dropped_put_count++;
+		return -EMSGSIZE;
+	}
+
+	entry_write(buf, buf->tail, type, value, data, size32);
+	INDEX_RELEASE(buf->tail, index_add(buf, buf->tail, size32 + 1));
+
+	return 0;
+}
+
+#ifdef CONFIG_RING_BUFFER_LOCK_FREE
+int sys_ring_buf_put_lock_free(struct ring_buf *buf, uint16_t type,
+			       uint8_t value, uint32_t *data, uint8_t size32)
+{
+	uint32_t head, tail, start, space;
+	int rc = 0;
+
+	atomic_inc(&buf->nesting);
+
+	/* reserve room for the entry, racing with the producers preempting us */
+	do {
+		head = INDEX_ACQUIRE(buf->head);
+		start = (uint32_t)atomic_get(&buf->reserve);
+
+		if (start < head) {
+			space = head - start - 1;
 		} else {
-			for (i = 0; i < size32; ++i) {
-				index = (i + buf->tail + 1) % buf->size;
-				buf->buf[index] = data[i];
-			}
-			buf->tail = (buf->tail + size32 + 1) % buf->size;
+			space = (buf->size - start) + head - 1;
 		}
-		rc = 0;
-	} else {
-		buf->dropped_put_count++;
-		rc = -EMSGSIZE;
+
+		if (space < (size32 + 1)) {
+			atomic_inc((atomic_t *)&buf->dropped_put_count);
+			rc = -EMSGSIZE;
+			break;
+		}
+	} while (!atomic_cas(&buf->reserve, start,
+			     index_add(buf, start, size32 + 1)));
+
+	if (rc == 0) {
+		entry_write(buf, start, type, value, data, size32);
+	}
+
+	/*
+	 * The outermost producer publishes every entry reserved so far, since
+	 * the producers it was preempted by have all completed. If a producer
+	 * preempts it once the nesting count drops to zero and publishes
+	 * first, the tail index has moved and the compare-and-set fails,
+	 * which keeps the tail index from going backwards.
+	 */
+	tail = INDEX_ACQUIRE(buf->tail);
+	if (atomic_dec(&buf->nesting) == 1) {
+		atomic_cas((atomic_t *)&buf->tail, tail,
+			   atomic_get(&buf->reserve));
 	}
 
 	return rc;
 }
+#endif /* CONFIG_RING_BUFFER_LOCK_FREE */
 
 int sys_ring_buf_get(struct ring_buf *buf, uint16_t *type, uint8_t *value,
 		     uint32_t *data, uint8_t *size32)
 {
 	struct ring_element *header;
-	uint32_t i, index;
+	uint32_t i;
 
-	if (sys_ring_buf_is_empty(buf)) {
+	if (buf->head == INDEX_ACQUIRE(buf->tail)) {
 		return -EAGAIN;
 	}
 
@@ -86,20 +156,11 @@ int sys_ring_buf_get(struct ring_buf *buf, uint16_t *type, uint8_t *value,
 	*type = header->type;
 	*value = header->value;
 
-	if (likely(buf->mask)) {
-		for (i = 0; i < header->length; ++i) {
-			index = (i + buf->head + 1) & buf->mask;
-			data[i] = buf->buf[index];
-		}
-		buf->head = (buf->head + header->length + 1) & buf->mask;
-	} else {
-		for (i = 0; i < header->length; ++i) {
-			index = (i + buf->head + 1) % buf->size;
-			data[i] = buf->buf[index];
-		}
-		buf->head = (buf->head + header->length + 1) % buf->size;
+	for (i = 0; i < header->length; ++i) {
+		data[i] = buf->buf[index_add(buf, buf->head, i + 1)];
 	}
+	INDEX_RELEASE(buf->head,
+		      index_add(buf, buf->head, header->length + 1));
 
 	return 0;
 }
-
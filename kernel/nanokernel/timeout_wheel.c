@@ -0,0 +1,264 @@
+/* timeout_wheel.c - hierarchical timing wheel for timeouts and timers */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nanokernel.h>
+#include <arch/cpu.h>
+#include <misc/dlist.h>
+#include <misc/util.h>
+#include <timeout_wheel.h>
+
+#define SLOT_BITS _TIMEOUT_WHEEL_SLOT_BITS
+#define SLOTS _TIMEOUT_WHEEL_SLOTS
+#define SLOT_MASK _TIMEOUT_WHEEL_SLOT_MASK
+#define LEVELS _TIMEOUT_WHEEL_LEVELS
+
+/* number of ticks covered by the wheel */
+#define WHEEL_RANGE ((uint32_t)1 << (SLOT_BITS * LEVELS))
+
+static inline uint32_t _slot_index(uint32_t tick, int level)
+{
+	return (tick >> (level * SLOT_BITS)) & SLOT_MASK;
+}
+
+static inline uint32_t _rotate_right(uint32_t bits, uint32_t n)
+{
+	return n ? ((bits >> n) | (bits << (32 - n))) : bits;
+}
+
+/*
+ * Queue a timeout in the slot matching its expiry, relative to the next
+ * tick to be announced.
+ */
+static void _wheel_enqueue(struct _timeout_wheel *wheel,
+			   struct _timeout_wheel_node *node)
+{
+	uint32_t base = wheel->now + 1;
+	uint32_t expiry = node->expiry;
+	uint32_t delta = expiry - base;
+	uint32_t index;
+	int level;
+
+	if (delta >= WHEEL_RANGE) {
+		/* park in the last slot of the top level */
+		expiry = base + WHEEL_RANGE - 1;
+		delta = WHEEL_RANGE - 1;
+	}
+
+	level = delta ? (find_msb_set(delta) - 1) / SLOT_BITS : 0;
+	index = _slot_index(expiry, level);
+
+	sys_dlist_append(&wheel->slots[level][index], &node->node);
+	wheel->bitmap[level] |= (1U << index);
+}
+
+/* move all the timeouts of a slot to an initially empty list */
+static void _wheel_slot_take(struct _timeout_wheel *wheel, int level,
+			     uint32_t index, sys_dlist_t *list)
+{
+	sys_dlist_t *slot = &wheel->slots[level][index];
+
+	wheel->bitmap[level] &= ~(1U << index);
+
+	if (sys_dlist_is_empty(slot)) {
+		sys_dlist_init(list);
+		return;
+	}
+
+	list->head = slot->head;
+	list->tail = slot->tail;
+	list->head->prev = list;
+	list->tail->next = list;
+	sys_dlist_init(slot);
+}
+
+/*
+ * Move the timeouts of the upper level slots reached by 'base' down the
+ * wheel, starting from level 1 and going up as long as the lower level wraps
+ * around.
+ */
+static void _wheel_cascade(struct _timeout_wheel *wheel, uint32_t base)
+{
+	sys_dlist_t list;
+	sys_dnode_t *node;
+	uint32_t index;
+	int level;
+
+	for (level = 1; level < LEVELS; level++) {
+		index = _slot_index(base, level);
+
+		_wheel_slot_take(wheel, level, index, &list);
+		while ((node = sys_dlist_get(&list)) != NULL) {
+			_wheel_enqueue(wheel, (struct _timeout_wheel_node *)node);
+		}
+
+		if (index != 0) {
+			break;
+		}
+	}
+}
+
+/**
+ *
+ * @brief Initialize a timing wheel
+ *
+ * @param wheel Timing wheel to initialize
+ *
+ * @return N/A
+ */
+void _timeout_wheel_init(struct _timeout_wheel *wheel)
+{
+	int level;
+	int index;
+
+	wheel->now = 0;
+
+	for (level = 0; level < LEVELS; level++) {
+		wheel->bitmap[level] = 0;
+		for (index = 0; index < SLOTS; index++) {
+			sys_dlist_init(&wheel->slots[level][index]);
+		}
+	}
+}
+
+/**
+ *
+ * @brief Add a timeout to the wheel
+ *
+ * @param wheel Timing wheel
+ * @param node Timeout to add, not already queued
+ * @param ticks Number of ticks until the timeout expires; a value lower
+ *        than 1 expires the timeout on the next tick
+ *
+ * @return N/A
+ */
+void _timeout_wheel_add(struct _timeout_wheel *wheel,
+			struct _timeout_wheel_node *node,
+			int32_t ticks)
+{
+	if (ticks < 1) {
+		ticks = 1;
+	}
+
+	node->expiry = wheel->now + ticks;
+	_wheel_enqueue(wheel, node);
+}
+
+/**
+ *
+ * @brief Announce elapsed ticks to the wheel
+ *
+ * Expires all the timeouts that are due, in tick order. Runs of empty
+ * level 0 slots are skipped, so announcing many ticks at once (tickless
+ * idle) costs one iteration per 32 ticks, plus one per expired slot.
+ *
+ * The expiry handler may add timeouts to the wheel.
+ *
+ * @param wheel Timing wheel
+ * @param ticks Number of elapsed ticks
+ * @param expire Handler called for each expired timeout
+ *
+ * @return N/A
+ */
+void _timeout_wheel_announce(struct _timeout_wheel *wheel,
+			     int32_t ticks,
+			     _timeout_wheel_expire_t expire)
+{
+	uint32_t target = wheel->now + ticks;
+	uint32_t base, index, pending, remaining, skip;
+	sys_dlist_t list;
+	sys_dnode_t *node;
+
+	while (wheel->now != target) {
+		base = wheel->now + 1;
+		index = base & SLOT_MASK;
+		remaining = target - wheel->now;
+
+		if (index == 0) {
+			_wheel_cascade(wheel, base);
+		}
+
+		pending = wheel->bitmap[0] >> index;
+		if (!pending) {
+			/* nothing to expire until the next cascade */
+			skip = SLOTS - index;
+			wheel->now += min(skip, remaining);
+			continue;
+		}
+
+		skip = find_lsb_set(pending);
+		if (skip > remaining) {
+			wheel->now = target;
+			break;
+		}
+
+		wheel->now += skip;
+		_wheel_slot_take(wheel, 0, index + skip - 1, &list);
+		while ((node = sys_dlist_get(&list)) != NULL) {
+			expire((struct _timeout_wheel_node *)node);
+		}
+	}
+}
+
+/**
+ *
+ * @brief Get the number of ticks until the first timeout may expire
+ *
+ * For timeouts in the upper levels of the wheel, the tick at which they are
+ * next cascaded down the wheel is used instead of their expiry. The result
+ * is thus a lower bound, which is good enough for programming the system
+ * timer in tickless idle: waking up early only announces the elapsed ticks.
+ *
+ * @param wheel Timing wheel
+ *
+ * @return number of ticks, or (uint32_t)TICKS_UNLIMITED if the wheel is empty
+ */
+uint32_t _timeout_wheel_deadline(struct _timeout_wheel *wheel)
+{
+	uint32_t deadline = (uint32_t)TICKS_UNLIMITED;
+	uint32_t base = wheel->now + 1;
+	uint32_t start, first, pending, index, offset;
+	int shift;
+	int level;
+
+	for (level = 0; level < LEVELS; level++) {
+		/* first slot of the level reached at or after 'base' */
+		shift = level * SLOT_BITS;
+		start = (base >> shift) +
+			((base & ((1U << shift) - 1)) ? 1 : 0);
+		first = start & SLOT_MASK;
+		pending = _rotate_right(wheel->bitmap[level], first);
+
+		/* locate the first non-empty slot, discarding stale bits */
+		while (pending) {
+			offset = find_lsb_set(pending) - 1;
+			index = (first + offset) & SLOT_MASK;
+			if (!sys_dlist_is_empty(&wheel->slots[level][index])) {
+				break;
+			}
+			wheel->bitmap[level] &= ~(1U << index);
+			pending &= ~(1U << offset);
+		}
+
+		if (pending) {
+			deadline = min(deadline,
+				       ((start + offset) << shift) - wheel->now);
+		}
+	}
+
+	return deadline;
+}
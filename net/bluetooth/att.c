@@ -1773,6 +1773,9 @@ int bt_att_send(struct bt_conn *conn, struct net_buf *buf, bt_att_func_t func,
 			return -EBUSY;
 		}
 
+		/* Keep a clone of the request for a retry, the lower layers
+		 * only add headers in front of the data they send.
+		 */
 		att->req.buf = net_buf_clone(buf);
 #if defined(CONFIG_BLUETOOTH_SMP)
 		att->req.retrying = false;
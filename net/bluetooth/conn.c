@@ -44,11 +44,18 @@
 #define BT_DBG(fmt, ...)
 #endif
 
-/* Pool for outgoing ACL fragments */
+/* Pool for the headers of outgoing ACL fragments */
 static struct nano_fifo frag_buf;
-static NET_BUF_POOL(frag_pool, 1, BT_L2CAP_BUF_SIZE(23), &frag_buf, NULL,
+static NET_BUF_POOL(frag_pool, 1, CONFIG_BLUETOOTH_HCI_SEND_RESERVE +
+		    sizeof(struct bt_hci_acl_hdr), &frag_buf, NULL,
 		    BT_BUF_USER_DATA_MIN);
 
+/* Pool for the data of outgoing ACL fragments, which refers to the data of
+ * the fragmented buffer instead of copying it.
+ */
+static struct nano_fifo frag_data;
+static NET_BUF_POOL(frag_data_pool, 1, 0, &frag_data, NULL, 0);
+
 /* Pool for dummy buffers to wake up the tx fibers */
 static struct nano_fifo dummy;
 static NET_BUF_POOL(dummy_pool, CONFIG_BLUETOOTH_MAX_CONN, 0, &dummy, NULL, 0);
@@ -430,7 +437,7 @@ static bool send_frag(struct bt_conn *conn, struct net_buf *buf, uint8_t flags,
 
 	hdr = net_buf_push(buf, sizeof(*hdr));
 	hdr->handle = sys_cpu_to_le16(bt_acl_handle_pack(conn->handle, flags));
-	hdr->len = sys_cpu_to_le16(buf->len - sizeof(*hdr));
+	hdr->len = sys_cpu_to_le16(net_buf_frags_len(buf) - sizeof(*hdr));
 
 	bt_buf_set_type(buf, BT_BUF_ACL_OUT);
 
@@ -465,8 +472,7 @@ static inline uint16_t conn_mtu(struct bt_conn *conn)
 
 static struct net_buf *create_frag(struct bt_conn *conn, struct net_buf *buf)
 {
-	struct net_buf *frag;
-	uint16_t frag_len;
+	struct net_buf *frag, *data;
 
 	frag = bt_conn_create_pdu(&frag_buf, 0);
 
@@ -475,10 +481,17 @@ static struct net_buf *create_frag(struct bt_conn *conn, struct net_buf *buf)
 		return NULL;
 	}
 
-	frag_len = min(conn_mtu(conn), net_buf_tailroom(frag));
+	data = net_buf_clone_get(&frag_data, buf);
+	if (!data) {
+		net_buf_unref(frag);
+		return NULL;
+	}
+
+	data->len = min(conn_mtu(conn), buf->len);
+	net_buf_pull(buf, data->len);
 
-	memcpy(net_buf_add(frag, frag_len), buf->data, frag_len);
-	net_buf_pull(buf, frag_len);
+	/* The fragment holds the ACL header, its data follows as a fragment */
+	net_buf_frag_add(frag, data);
 
 	return frag;
 }
@@ -486,6 +499,7 @@ static struct net_buf *create_frag(struct bt_conn *conn, struct net_buf *buf)
 static bool send_buf(struct bt_conn *conn, struct net_buf *buf)
 {
 	struct net_buf *frag;
+	uint8_t flags;
 
 	BT_DBG("conn %p buf %p len %u", conn, buf, buf->len);
 
@@ -494,32 +508,28 @@ static bool send_buf(struct bt_conn *conn, struct net_buf *buf)
 		return send_frag(conn, buf, BT_ACL_START_NO_FLUSH, false);
 	}
 
-	/* Create & enqueue first fragment */
-	frag = create_frag(conn, buf);
-	if (!frag) {
-		return false;
-	}
-
-	if (!send_frag(conn, frag, BT_ACL_START_NO_FLUSH, true)) {
-		return false;
-	}
-
 	/*
-	 * Send the fragments. For the last one simply use the original
-	 * buffer (which works since we've used net_buf_pull on it.
+	 * Send the fragments. They refer to the data of the buffer, which
+	 * is not modified: a clone of it, such as an ATT request kept for a
+	 * retry, may still use it.
 	 */
-	while (buf->len > conn_mtu(conn)) {
+	flags = BT_ACL_START_NO_FLUSH;
+	do {
 		frag = create_frag(conn, buf);
 		if (!frag) {
 			return false;
 		}
 
-		if (!send_frag(conn, frag, BT_ACL_CONT, true)) {
+		if (!send_frag(conn, frag, flags, true)) {
 			return false;
 		}
-	}
 
-	return send_frag(conn, buf, BT_ACL_CONT, false);
+		flags = BT_ACL_CONT;
+	} while (buf->len);
+
+	net_buf_unref(buf);
+
+	return true;
 }
 
 static void conn_tx_fiber(int arg1, int arg2)
@@ -1556,6 +1566,7 @@ int bt_conn_init(void)
 	int err;
 
 	net_buf_pool_init(frag_pool);
+	net_buf_pool_init(frag_data_pool);
 	net_buf_pool_init(dummy_pool);
 
 	bt_att_init();
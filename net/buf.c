@@ -43,45 +43,76 @@
 #define NET_BUF_ASSERT(cond)
 #endif /* CONFIG_NET_BUF_DEBUG */
 
-struct net_buf *net_buf_get(struct nano_fifo *fifo, size_t reserve_head)
+struct net_buf *net_buf_get_timeout(struct nano_fifo *fifo,
+				    size_t reserve_head, int32_t timeout)
 {
 	struct net_buf *buf;
 
-	NET_BUF_DBG("fifo %p reserve %u\n", fifo, reserve_head);
+	NET_BUF_DBG("fifo %p reserve %u timeout %d\n", fifo, reserve_head,
+		    timeout);
 
 	buf = nano_fifo_get(fifo, TICKS_NONE);
 	if (!buf) {
-		if (sys_execution_context_type_get() == NANO_CTX_ISR) {
+		if (timeout == TICKS_NONE ||
+		    sys_execution_context_type_get() == NANO_CTX_ISR) {
 			NET_BUF_ERR("Failed to get free buffer\n");
 			return NULL;
 		}
 
 		NET_BUF_WARN("Low on buffers. Waiting (fifo %p)\n", fifo);
-		buf = nano_fifo_get(fifo, TICKS_UNLIMITED);
+		buf = nano_fifo_get(fifo, timeout);
+		if (!buf) {
+			NET_BUF_ERR("Failed to get free buffer\n");
+			return NULL;
+		}
 	}
 
-	buf->ref  = 1;
-	buf->data = buf->__buf + reserve_head;
-	buf->len  = 0;
+	buf->ref    = 1;
+	buf->data   = buf->__buf + reserve_head;
+	buf->len    = 0;
+	buf->frags  = NULL;
+	buf->shared = NULL;
 
 	NET_BUF_DBG("buf %p fifo %p reserve %u\n", buf, fifo, reserve_head);
 
 	return buf;
 }
 
+struct net_buf *net_buf_get(struct nano_fifo *fifo, size_t reserve_head)
+{
+	return net_buf_get_timeout(fifo, reserve_head, TICKS_UNLIMITED);
+}
+
 void net_buf_unref(struct net_buf *buf)
 {
-	NET_BUF_DBG("buf %p ref %u fifo %p\n", buf, buf->ref, buf->free);
-	NET_BUF_ASSERT(buf->ref > 0);
+	while (buf) {
+		struct net_buf *frags = buf->frags;
 
-	if (--buf->ref) {
-		return;
-	}
+		NET_BUF_DBG("buf %p ref %u fifo %p frags %p\n", buf, buf->ref,
+			    buf->free, buf->frags);
+		NET_BUF_ASSERT(buf->ref > 0);
+
+		if (--buf->ref) {
+			return;
+		}
 
-	if (buf->destroy) {
-		buf->destroy(buf);
-	} else {
-		nano_fifo_put(buf->free, buf);
+		buf->frags = NULL;
+
+		if (buf->shared) {
+			/* The storage owner has no shared storage itself, so
+			 * this does not recurse further.
+			 */
+			net_buf_unref(buf->shared);
+			buf->shared = NULL;
+		}
+
+		if (buf->destroy) {
+			buf->destroy(buf);
+		} else {
+			nano_fifo_put(buf->free, buf);
+		}
+
+		buf = frags;
 	}
 }
 
@@ -93,26 +124,123 @@ struct net_buf *net_buf_ref(struct net_buf *buf)
 }
 
 struct net_buf *net_buf_clone(struct net_buf *buf)
+{
+	return net_buf_clone_get(buf->free, buf);
+}
+
+struct net_buf *net_buf_clone_get(struct nano_fifo *fifo, struct net_buf *buf)
 {
 	struct net_buf *clone;
 
-	clone = net_buf_get(buf->free, net_buf_headroom(buf));
+	clone = net_buf_get(fifo, 0);
 	if (!clone) {
 		return NULL;
 	}
 
-	/* TODO: Add reference to the original buffer instead of copying it. */
-	memcpy(net_buf_add(clone, buf->len), buf->data, buf->len);
+	/* A clone of a clone refers to the storage of the original too */
+	clone->shared = net_buf_ref(buf->shared ? buf->shared : buf);
+	clone->data = buf->data;
+	clone->len = buf->len;
+
+	NET_BUF_DBG("buf %p clone %p storage %p\n", buf, clone, clone->shared);
 
 	return clone;
 }
 
+void net_buf_unshare(struct net_buf *buf)
+{
+	struct net_buf *shared = buf->shared;
+	size_t headroom;
+
+	if (!shared) {
+		return;
+	}
+
+	NET_BUF_DBG("buf %p storage %p len %u\n", buf, shared, buf->len);
+
+	/* Keep the same headroom, the clone comes from the same pool */
+	headroom = buf->data - shared->__buf;
+	NET_BUF_ASSERT(headroom + buf->len <= buf->size);
+
+	memcpy(buf->__buf + headroom, buf->data, buf->len);
+	buf->data = buf->__buf + headroom;
+	buf->shared = NULL;
+
+	net_buf_unref(shared);
+}
+
+struct net_buf *net_buf_frag_last(struct net_buf *buf)
+{
+	while (buf->frags) {
+		buf = buf->frags;
+	}
+
+	return buf;
+}
+
+void net_buf_frag_insert(struct net_buf *parent, struct net_buf *frag)
+{
+	NET_BUF_DBG("parent %p frag %p\n", parent, frag);
+
+	if (parent->frags) {
+		net_buf_frag_last(frag)->frags = parent->frags;
+	}
+
+	parent->frags = frag;
+}
+
+struct net_buf *net_buf_frag_add(struct net_buf *head, struct net_buf *frag)
+{
+	if (!head) {
+		return frag;
+	}
+
+	net_buf_frag_insert(net_buf_frag_last(head), frag);
+
+	return head;
+}
+
+struct net_buf *net_buf_frag_del(struct net_buf *parent, struct net_buf *frag)
+{
+	struct net_buf *next_frag;
+
+	NET_BUF_DBG("parent %p frag %p\n", parent, frag);
+
+	if (parent) {
+		NET_BUF_ASSERT(parent->frags == frag);
+		parent->frags = frag->frags;
+	}
+
+	next_frag = frag->frags;
+	frag->frags = NULL;
+
+	net_buf_unref(frag);
+
+	return next_frag;
+}
+
+size_t net_buf_frags_len(struct net_buf *buf)
+{
+	size_t bytes = 0;
+
+	while (buf) {
+		bytes += buf->len;
+		buf = buf->frags;
+	}
+
+	return bytes;
+}
+
 void *net_buf_add(struct net_buf *buf, size_t len)
 {
-	uint8_t *tail = net_buf_tail(buf);
+	uint8_t *tail;
 
 	NET_BUF_DBG("buf %p len %u\n", buf, len);
 
+	net_buf_unshare(buf);
+
+	tail = net_buf_tail(buf);
+
 	NET_BUF_ASSERT(net_buf_tailroom(buf) >= len);
 
 	buf->len += len;
@@ -143,6 +271,8 @@ void *net_buf_push(struct net_buf *buf, size_t len)
 {
 	NET_BUF_DBG("buf %p len %u\n", buf, len);
 
+	net_buf_unshare(buf);
+
 	NET_BUF_ASSERT(net_buf_headroom(buf) >= len);
 
 	buf->data -= len;
@@ -190,10 +320,18 @@ uint16_t net_buf_pull_le16(struct net_buf *buf)
 
 size_t net_buf_headroom(struct net_buf *buf)
 {
+	if (buf->shared) {
+		return buf->data - buf->shared->__buf;
+	}
+
 	return buf->data - buf->__buf;
 }
 
 size_t net_buf_tailroom(struct net_buf *buf)
 {
+	if (buf->shared) {
+		return buf->shared->size - net_buf_headroom(buf) - buf->len;
+	}
+
 	return buf->size - net_buf_headroom(buf) - buf->len;
 }
@@ -45,7 +45,7 @@ typedef unsigned int uip_stats_t;
 /* The actual MTU size is defined in uipopt.h */
 #define UIP_CONF_BUFFER_SIZE UIP_LINK_MTU
 
-/* No TCP yet */
+/* No uIP TCP, CONFIG_NETWORKING_WITH_TCP enables net_tcp.c instead */
 #define UIP_CONF_TCP 0
 
 /* We do not want to be a router */
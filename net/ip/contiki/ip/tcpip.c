@@ -404,7 +404,7 @@ eventhandler(process_event_t ev, process_data_t data, struct net_buf *buf)
         for(cptr = &uip_udp_conns[0];
             cptr < &uip_udp_conns[UIP_UDP_CONNS]; ++cptr) {
           if(cptr->appstate.p == p) {
-            cptr->lport = 0;
+            uip_udp_remove(cptr);
           }
         }
       }
@@ -0,0 +1,150 @@
+/** @file
+ * @brief Internet checksum computation
+ *
+ * One's complement sum shared by the IPv4 and IPv6 versions of uIP.
+ */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+
+#include "contiki/ip/uip.h"
+
+#if ! UIP_ARCH_CHKSUM
+
+/* The data is summed in native byte order, a 16-bit word of the buffer
+ * may alias any other type.
+ */
+typedef uint16_t __attribute__((__may_alias__)) chksum_word_t;
+
+union chksum_pad {
+  uint8_t b[2];
+  uint16_t w;
+};
+
+#if defined(CONFIG_X86)
+/* Sum blocks of 32 bytes as 32-bit words, the carry of each addition
+ * is added by the next one. lea and dec do not change the carry flag.
+ */
+static inline uint32_t
+chksum_blocks(uint32_t acc, const uint8_t *data, uint16_t blocks)
+{
+  uint32_t count = blocks;
+
+  __asm__ ("clc\n\t"
+           "1:\n\t"
+           "adcl (%[data]), %[acc]\n\t"
+           "adcl 4(%[data]), %[acc]\n\t"
+           "adcl 8(%[data]), %[acc]\n\t"
+           "adcl 12(%[data]), %[acc]\n\t"
+           "adcl 16(%[data]), %[acc]\n\t"
+           "adcl 20(%[data]), %[acc]\n\t"
+           "adcl 24(%[data]), %[acc]\n\t"
+           "adcl 28(%[data]), %[acc]\n\t"
+           "lea 32(%[data]), %[data]\n\t"
+           "decl %[count]\n\t"
+           "jnz 1b\n\t"
+           "adcl $0, %[acc]"
+           : [acc] "+r" (acc), [data] "+r" (data), [count] "+r" (count)
+           :
+           : "cc", "memory");
+
+  /* Make room for the 16-bit words still to be added */
+  return (acc & 0xffff) + (acc >> 16);
+}
+#endif /* CONFIG_X86 */
+
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_add(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  const chksum_word_t *word;
+  union chksum_pad pad;
+  uint32_t acc = 0;
+  uint8_t odd;
+
+  if(len == 0) {
+    return sum;
+  }
+
+  /* Words read from an odd address hold the bytes of the buffer in
+   * the other order, the sum is swapped back once done.
+   */
+  odd = (uintptr_t)data & 1;
+  if(odd) {
+    pad.b[0] = 0;
+    pad.b[1] = *data++;
+    acc = pad.w;
+    len--;
+  }
+
+#if defined(CONFIG_X86)
+  if(((uintptr_t)data & 2) && len >= 2) {
+    acc += *(const chksum_word_t *)data;
+    data += 2;
+    len -= 2;
+  }
+
+  if(len >= 32) {
+    acc = chksum_blocks(acc, data, len / 32);
+    data += len & ~31;
+    len &= 31;
+  }
+#endif /* CONFIG_X86 */
+
+  /* At most 32767 words of 0xffff are added, the 32-bit accumulator
+   * cannot overflow.
+   */
+  word = (const chksum_word_t *)data;
+  while(len >= 16) {
+    acc += word[0];
+    acc += word[1];
+    acc += word[2];
+    acc += word[3];
+    acc += word[4];
+    acc += word[5];
+    acc += word[6];
+    acc += word[7];
+    word += 8;
+    len -= 16;
+  }
+
+  while(len >= 2) {
+    acc += *word++;
+    len -= 2;
+  }
+
+  if(len) {
+    pad.b[0] = *(const uint8_t *)word;
+    pad.b[1] = 0;
+    acc += pad.w;
+  }
+
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+
+  if(odd) {
+    acc = ((acc & 0xff) << 8) | (acc >> 8);
+  }
+
+  /* Return sum in host byte order. */
+  acc = uip_ntohs((uint16_t)acc) + (uint32_t)sum;
+  acc = (acc & 0xffff) + (acc >> 16);
+
+  return (uint16_t)acc;
+}
+#endif /* UIP_ARCH_CHKSUM */
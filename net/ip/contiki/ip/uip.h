@@ -821,19 +821,28 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
  *
  * \hideinitializer
  */
+#if NETSTACK_CONF_WITH_IPV6
+#define uip_udp_remove(conn) uip_udp_bind(conn, 0)
+#else
 #define uip_udp_remove(conn) (conn)->lport = 0
+#endif
 
 /**
  * Bind a UDP connection to a local port.
  *
+ * The local port of a connection is used to demultiplex incoming
+ * datagrams and must only be changed with this function.
+ *
  * \param conn A pointer to the uip_udp_conn structure for the
  * connection.
  *
  * \param port The local port number, in network byte order.
- *
- * \hideinitializer
  */
+#if NETSTACK_CONF_WITH_IPV6
+void uip_udp_bind(struct uip_udp_conn *conn, uint16_t port);
+#else
 #define uip_udp_bind(conn, port) (conn)->lport = port
+#endif
 
 /**
  * Send a UDP datagram of length len on the current connection.
@@ -1384,6 +1393,9 @@ struct uip_udp_conn {
 
   /* buffer holding the data to this connection */
   struct net_buf *buf;
+
+  /* next connection bound to a local port of the same hash bucket */
+  struct uip_udp_conn *hash_next;
 };
 
 /**
@@ -1459,7 +1471,7 @@ struct uip_stats {
     uip_stats_t chkerr;   /**< Number of ICMP packets with a bad
 			     checksum. */
   } icmp;                 /**< ICMP statistics. */
-#if UIP_TCP
+#if UIP_TCP || defined(CONFIG_NETWORKING_WITH_TCP)
   struct {
     uip_stats_t recv;     /**< Number of recived TCP segments. */
     uip_stats_t sent;     /**< Number of sent TCP segments. */
@@ -2176,6 +2188,66 @@ CCIF extern uip_lladdr_t uip_lladdr;
  */
 uint16_t uip_chksum(uint16_t *data, uint16_t len);
 
+/**
+ * Add the 16-bit words of a buffer to a one's complement sum.
+ *
+ * The buffer may start at any address, an odd last byte is padded
+ * with zero.
+ *
+ * \param sum The sum so far, in host byte order.
+ *
+ * \param data A pointer to the buffer.
+ *
+ * \param len The length of the buffer.
+ *
+ * \return The new sum, in host byte order.
+ */
+uint16_t uip_chksum_add(uint16_t sum, const uint8_t *data, uint16_t len);
+
+/**
+ * Update an Internet checksum for a changed 16-bit field.
+ *
+ * Computes the checksum of the rewritten header from the old
+ * checksum, without summing the whole packet again. See RFC1624,
+ * equation 3.
+ *
+ * All the values have the byte order of the packet, network byte
+ * order when read from the header.
+ *
+ * \param chksum The checksum field before the change.
+ *
+ * \param from The old value of the field.
+ *
+ * \param to The new value of the field.
+ *
+ * \return The new value of the checksum field.
+ */
+static inline uint16_t
+uip_chksum_update16(uint16_t chksum, uint16_t from, uint16_t to)
+{
+  uint32_t sum;
+
+  sum = (uint16_t)~chksum + (uint32_t)(uint16_t)~from + to;
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = (sum & 0xffff) + (sum >> 16);
+
+  return (uint16_t)~sum;
+}
+
+/**
+ * Update an Internet checksum for a changed 32-bit field.
+ *
+ * Same as uip_chksum_update16(), for a field made of two 16-bit
+ * words, like an IPv4 address or a TCP sequence number.
+ */
+static inline uint16_t
+uip_chksum_update32(uint16_t chksum, uint32_t from, uint32_t to)
+{
+  chksum = uip_chksum_update16(chksum, from >> 16, to >> 16);
+
+  return uip_chksum_update16(chksum, from & 0xffff, to & 0xffff);
+}
+
 /**
  * Calculate the IP header checksum of the packet header in uip_buf.
  *
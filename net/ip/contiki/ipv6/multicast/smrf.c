@@ -172,6 +172,10 @@ in(struct net_buf *buf)
 
       netbuf = net_buf_clone(buf);
       if (netbuf) {
+        /* The forwarded copy is modified, and so may be the original
+         * on its way up the stack, so they cannot share the data.
+         */
+        net_buf_unshare(netbuf);
         memcpy(net_buf_user_data(netbuf), net_buf_user_data(buf),
                buf->user_data_size);
         ctimer_set(netbuf, &mcast_periodic, fwd_delay, mcast_fwd, NULL);
@@ -61,6 +61,21 @@ MEMB(neighborroutememb, struct uip_ds6_route_neighbor_route, UIP_DS6_ROUTE_NB);
 LIST(routelist);
 MEMB(routememb, uip_ds6_route_t, UIP_DS6_ROUTE_NB);
 
+/* The routes are also indexed by prefix in a path compressed binary
+   trie for the longest prefix match. A node either holds a route, or
+   is a branching node with two children. There are thus at most
+   twice as many nodes as routes. */
+struct route_node {
+  struct route_node *parent;
+  struct route_node *child[2];
+  uip_ds6_route_t *route;
+  uip_ipaddr_t prefix;
+  uint8_t length;
+};
+
+MEMB(routenodememb, struct route_node, 2 * UIP_DS6_ROUTE_NB);
+static struct route_node *route_root;
+
 /* Default routes are held on the defaultrouterlist and their
    structures are allocated from the defaultroutermemb memory block.*/
 LIST(defaultrouterlist);
@@ -78,6 +93,171 @@ static int num_routes = 0;
 #include "contiki/ip/uip-debug.h"
 
 static void rm_routelist_callback(nbr_table_item_t *ptr);
+
+/*---------------------------------------------------------------------------*/
+static uint8_t
+prefix_bit(const uip_ipaddr_t *addr, uint8_t n)
+{
+  return (addr->u8[n >> 3] >> (7 - (n & 7))) & 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the first bit where the two addresses differ, or len if the
+   first len bits are equal. The bits before from are known to be
+   equal. */
+static uint8_t
+prefix_diff(const uip_ipaddr_t *a, const uip_ipaddr_t *b,
+            uint8_t from, uint8_t len)
+{
+  uint8_t i;
+  uint8_t bit;
+  uint8_t x;
+
+  for(i = from >> 3; (i << 3) < len; i++) {
+    x = a->u8[i] ^ b->u8[i];
+    if(x != 0) {
+      for(bit = i << 3; !(x & 0x80); bit++) {
+        x <<= 1;
+      }
+      return bit < len ? bit : len;
+    }
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static struct route_node *
+route_node_alloc(struct route_node *parent, const uip_ipaddr_t *prefix,
+                 uint8_t length, uip_ds6_route_t *route)
+{
+  struct route_node *node;
+
+  node = memb_alloc(&routenodememb);
+  if(node != NULL) {
+    node->parent = parent;
+    node->child[0] = node->child[1] = NULL;
+    node->route = route;
+    uip_ipaddr_copy(&node->prefix, prefix);
+    node->length = length;
+  }
+  return node;
+}
+/*---------------------------------------------------------------------------*/
+static struct route_node **
+route_node_link(struct route_node *node)
+{
+  if(node->parent == NULL) {
+    return &route_root;
+  }
+  return &node->parent->child[node->parent->child[1] == node];
+}
+/*---------------------------------------------------------------------------*/
+static int
+route_trie_add(uip_ds6_route_t *r)
+{
+  struct route_node **link = &route_root;
+  struct route_node *parent = NULL;
+  struct route_node *node;
+  struct route_node *branch;
+  struct route_node *leaf;
+  uint8_t diff;
+  uint8_t from = 0;
+
+  while((node = *link) != NULL) {
+    diff = prefix_diff(&r->ipaddr, &node->prefix, from,
+                       r->length < node->length ? r->length : node->length);
+
+    if(diff == node->length) {
+      if(node->length == r->length) {
+        /* A route for the same prefix replaces the previous one */
+        node->route = r;
+        return 1;
+      }
+      parent = node;
+      from = node->length;
+      link = &node->child[prefix_bit(&r->ipaddr, node->length)];
+      continue;
+    }
+
+    if(diff == r->length) {
+      /* The new prefix covers the one of the node */
+      leaf = route_node_alloc(parent, &r->ipaddr, r->length, r);
+      if(leaf == NULL) {
+        return 0;
+      }
+      leaf->child[prefix_bit(&node->prefix, r->length)] = node;
+      node->parent = leaf;
+      *link = leaf;
+      return 1;
+    }
+
+    /* The prefixes differ before their end, branch where they do */
+    branch = route_node_alloc(parent, &r->ipaddr, diff, NULL);
+    leaf = route_node_alloc(branch, &r->ipaddr, r->length, r);
+    if(branch == NULL || leaf == NULL) {
+      if(branch != NULL) {
+        memb_free(&routenodememb, branch);
+      }
+      return 0;
+    }
+    branch->child[prefix_bit(&r->ipaddr, diff)] = leaf;
+    branch->child[prefix_bit(&node->prefix, diff)] = node;
+    node->parent = branch;
+    *link = branch;
+    return 1;
+  }
+
+  *link = route_node_alloc(parent, &r->ipaddr, r->length, r);
+  return *link != NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+route_trie_rm(uip_ds6_route_t *route)
+{
+  struct route_node *node = route_root;
+  struct route_node *child;
+  uip_ds6_route_t *r;
+  uint8_t from = 0;
+
+  /* Find the node of the exact prefix of the route */
+  while(node != NULL && node->length < route->length &&
+        prefix_diff(&route->ipaddr, &node->prefix, from, node->length) ==
+        node->length) {
+    from = node->length;
+    node = node->child[prefix_bit(&route->ipaddr, node->length)];
+  }
+
+  if(node == NULL || node->route != route) {
+    return;
+  }
+
+  /* Another route of the routing table may have the same prefix */
+  node->route = NULL;
+  for(r = list_head(routelist); r != NULL; r = list_item_next(r)) {
+    if(r != route && r->length == route->length &&
+       uip_ipaddr_prefixcmp(&r->ipaddr, &route->ipaddr, route->length)) {
+      node->route = r;
+      return;
+    }
+  }
+
+  /* Remove the nodes that no longer hold a route or branch */
+  while(node != NULL && node->route == NULL) {
+    if(node->child[0] != NULL && node->child[1] != NULL) {
+      break;
+    }
+
+    child = node->child[0] != NULL ? node->child[0] : node->child[1];
+    *route_node_link(node) = child;
+    if(child != NULL) {
+      child->parent = node->parent;
+      memb_free(&routenodememb, node);
+      break;
+    }
+
+    child = node->parent;
+    memb_free(&routenodememb, node);
+    node = child;
+  }
+}
 /*---------------------------------------------------------------------------*/
 #if DEBUG != DEBUG_NONE
 static void
@@ -149,6 +329,8 @@ uip_ds6_route_init(void)
 {
   memb_init(&routememb);
   list_init(routelist);
+  memb_init(&routenodememb);
+  route_root = NULL;
   nbr_table_register(nbr_routes,
                      (nbr_table_callback *)rm_routelist_callback);
 
@@ -206,29 +388,31 @@ uip_ds6_route_num_routes(void)
 uip_ds6_route_t *
 uip_ds6_route_lookup(uip_ipaddr_t *addr)
 {
-  uip_ds6_route_t *r;
+  struct route_node *node;
   uip_ds6_route_t *found_route;
-  uint8_t longestmatch;
+  uint8_t from;
 
   PRINTF("uip-ds6-route: Looking up route for ");
   PRINT6ADDR(addr);
   PRINTF("\n");
 
-
+  /* Walk down the trie as long as the address matches the prefix of
+     the nodes, each bit of the address is only compared once. The
+     last route seen has the longest matching prefix. */
   found_route = NULL;
-  longestmatch = 0;
-  for(r = uip_ds6_route_head();
-      r != NULL;
-      r = uip_ds6_route_next(r)) {
-    if(r->length >= longestmatch &&
-       uip_ipaddr_prefixcmp(addr, &r->ipaddr, r->length)) {
-      longestmatch = r->length;
-      found_route = r;
-      /* check if total match - e.g. all 128 bits do match */
-      if(longestmatch == 128) {
-	break;
-      }
+  from = 0;
+  for(node = route_root;
+      node != NULL &&
+      prefix_diff(addr, &node->prefix, from, node->length) == node->length;
+      node = node->child[prefix_bit(addr, node->length)]) {
+    if(node->route != NULL) {
+      found_route = node->route;
     }
+    /* check if total match - e.g. all 128 bits do match */
+    if(node->length == 128) {
+      break;
+    }
+    from = node->length;
   }
 
   if(found_route != NULL) {
@@ -373,6 +557,14 @@ uip_ds6_route_add(uip_ipaddr_t *ipaddr, uint8_t length,
   uip_ipaddr_copy(&(r->ipaddr), ipaddr);
   r->length = length;
 
+  if(!route_trie_add(r)) {
+    /* This should not happen, as there are two trie nodes for each
+       route table entry. */
+    PRINTF("uip_ds6_route_add: could not allocate route trie node\n");
+    uip_ds6_route_rm(r);
+    return NULL;
+  }
+
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   memset(&r->state, 0, sizeof(UIP_DS6_ROUTE_STATE_TYPE));
 #endif
@@ -408,8 +600,9 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
     PRINT6ADDR(&route->ipaddr);
     PRINTF("\n");
 
-    /* Remove the route from the route list */
+    /* Remove the route from the route list and the trie */
     list_remove(routelist, route);
+    route_trie_rm(route);
 
     /* Find the corresponding neighbor_route and remove it. */
     for(neighbor_route = list_head(route->neighbor_routes->route_list);
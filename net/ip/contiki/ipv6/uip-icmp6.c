@@ -122,6 +122,8 @@ echo_request_input(struct net_buf *buf)
 #if UIP_CONF_IPV6_RPL
   uint8_t temp_ext_len;
 #endif /* UIP_CONF_IPV6_RPL */
+  uint16_t request_hdr;
+  uint8_t same_chksum;
   /*
    * we send an echo reply. It is trivial if there was no extension
    * headers in the request otherwise we need to remove the extension
@@ -136,6 +138,12 @@ echo_request_input(struct net_buf *buf)
   /* IP header */
   UIP_IP_BUF(buf)->ttl = uip_ds6_if.cur_hop_limit;
 
+  /* Swapping the addresses leaves the pseudo header sum unchanged, as
+   * long as no extension header has to be removed
+   */
+  same_chksum = !uip_is_addr_mcast(&UIP_IP_BUF(buf)->destipaddr) &&
+                uip_ext_len(buf) == 0;
+
   if(uip_is_addr_mcast(&UIP_IP_BUF(buf)->destipaddr)){
     uip_ipaddr_copy(&UIP_IP_BUF(buf)->destipaddr, &UIP_IP_BUF(buf)->srcipaddr);
     uip_ds6_select_src(&UIP_IP_BUF(buf)->srcipaddr, &UIP_IP_BUF(buf)->destipaddr);
@@ -191,10 +199,19 @@ echo_request_input(struct net_buf *buf)
    */
 
   /* Note: now UIP_ICMP_BUF points to the beginning of the echo reply */
+  request_hdr = UIP_HTONS((UIP_ICMP_BUF(buf)->type << 8) |
+                          UIP_ICMP_BUF(buf)->icode);
   UIP_ICMP_BUF(buf)->type = ICMP6_ECHO_REPLY;
   UIP_ICMP_BUF(buf)->icode = 0;
-  UIP_ICMP_BUF(buf)->icmpchksum = 0;
-  UIP_ICMP_BUF(buf)->icmpchksum = ~uip_icmp6chksum(buf);
+  if(same_chksum) {
+    /* Only the type and code changed, the payload is not summed again */
+    UIP_ICMP_BUF(buf)->icmpchksum =
+      uip_chksum_update16(UIP_ICMP_BUF(buf)->icmpchksum, request_hdr,
+                          UIP_HTONS(ICMP6_ECHO_REPLY << 8));
+  } else {
+    UIP_ICMP_BUF(buf)->icmpchksum = 0;
+    UIP_ICMP_BUF(buf)->icmpchksum = ~uip_icmp6chksum(buf);
+  }
 
   PRINTF("Sending Echo Reply to ");
   PRINT6ADDR(&UIP_IP_BUF(buf)->destipaddr);
@@ -79,6 +79,7 @@
 #include "contiki/ipv6/uip-nd6.h"
 #include "contiki/ipv6/uip-ds6.h"
 #include "contiki/ipv6/multicast/uip-mcast6.h"
+#include "net_tcp.h"
 
 #include <string.h>
 
@@ -281,6 +282,16 @@ static uint16_t tmp16;
 struct uip_udp_conn *uip_udp_conn;
 #endif
 struct uip_udp_conn uip_udp_conns[UIP_UDP_CONNS];
+
+#ifndef UIP_UDP_CONN_HASH_SIZE
+#define UIP_UDP_CONN_HASH_SIZE 16
+#endif
+
+/* The bound connections, hashed by local port for the demultiplexing */
+static struct uip_udp_conn *udp_conn_hash[UIP_UDP_CONN_HASH_SIZE];
+
+#define UDP_CONN_HASH(port) \
+  (&udp_conn_hash[uip_ntohs(port) % UIP_UDP_CONN_HASH_SIZE])
 #endif /* UIP_UDP */
 /** @} */
 
@@ -331,41 +342,10 @@ uip_add32(uint8_t *op32, uint16_t op16)
 
 #if ! UIP_ARCH_CHKSUM
 /*---------------------------------------------------------------------------*/
-static uint16_t
-chksum(uint16_t sum, const uint8_t *data, uint16_t len)
-{
-  uint16_t t;
-  const uint8_t *dataptr;
-  const uint8_t *last_byte;
-
-  dataptr = data;
-  last_byte = data + len - 1;
-  
-  while(dataptr < last_byte) {   /* At least two more bytes */
-    t = (dataptr[0] << 8) + dataptr[1];
-    sum += t;
-    if(sum < t) {
-      sum++;      /* carry */
-    }
-    dataptr += 2;
-  }
-  
-  if(dataptr == last_byte) {
-    t = (dataptr[0] << 8) + 0;
-    sum += t;
-    if(sum < t) {
-      sum++;      /* carry */
-    }
-  }
-
-  /* Return sum in host byte order. */
-  return sum;
-}
-/*---------------------------------------------------------------------------*/
 uint16_t
 uip_chksum(uint16_t *data, uint16_t len)
 {
-  return uip_htons(chksum(0, (uint8_t *)data, len));
+  return uip_htons(uip_chksum_add(0, (uint8_t *)data, len));
 }
 /*---------------------------------------------------------------------------*/
 #ifndef UIP_ARCH_IPCHKSUM
@@ -374,7 +354,7 @@ uip_ipchksum(struct net_buf *buf)
 {
   uint16_t sum;
 
-  sum = chksum(0, &uip_buf(buf)[UIP_LLH_LEN], UIP_IPH_LEN);
+  sum = uip_chksum_add(0, &uip_buf(buf)[UIP_LLH_LEN], UIP_IPH_LEN);
   PRINTF("uip_ipchksum: sum 0x%04x\n", sum);
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
@@ -404,11 +384,11 @@ upper_layer_chksum(struct net_buf *buf, uint8_t proto)
   /* IP protocol and length fields. This addition cannot carry. */
   sum = upper_layer_len + proto;
   /* Sum IP source and destination addresses. */
-  sum = chksum(sum, (uint8_t *)&UIP_IP_BUF(buf)->srcipaddr, 2 * sizeof(uip_ipaddr_t));
+  sum = uip_chksum_add(sum, (uint8_t *)&UIP_IP_BUF(buf)->srcipaddr, 2 * sizeof(uip_ipaddr_t));
 
   /* Sum TCP header and data. */
-  sum = chksum(sum, &uip_buf(buf)[UIP_IPH_LEN + UIP_LLH_LEN + uip_ext_len(buf)],
-               upper_layer_len);
+  sum = uip_chksum_add(sum, &uip_buf(buf)[UIP_IPH_LEN + UIP_LLH_LEN + uip_ext_len(buf)],
+                       upper_layer_len);
     
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
@@ -420,13 +400,13 @@ uip_icmp6chksum(struct net_buf *buf)
   
 }
 /*---------------------------------------------------------------------------*/
-#if UIP_TCP
+#if UIP_TCP || defined(CONFIG_NETWORKING_WITH_TCP)
 uint16_t
-uip_tcpchksum(void)
+uip_tcpchksum(struct net_buf *buf)
 {
-  return upper_layer_chksum(UIP_PROTO_TCP);
+  return upper_layer_chksum(buf, UIP_PROTO_TCP);
 }
-#endif /* UIP_TCP */
+#endif /* UIP_TCP || CONFIG_NETWORKING_WITH_TCP */
 /*---------------------------------------------------------------------------*/
 #if UIP_UDP && UIP_UDP_CHECKSUMS
 uint16_t
@@ -463,6 +443,7 @@ uip_init(void)
 
 #if UIP_UDP
   memset(&uip_udp_conns, 0, sizeof(uip_udp_conns));
+  memset(&udp_conn_hash, 0, sizeof(udp_conn_hash));
 #endif /* UIP_UDP */
 
 #if UIP_CONF_IPV6_MULTICAST
@@ -570,6 +551,43 @@ remove_ext_hdr(struct net_buf *buf)
 }
 /*---------------------------------------------------------------------------*/
 #if UIP_UDP
+void
+uip_udp_bind(struct uip_udp_conn *conn, uint16_t port)
+{
+  struct uip_udp_conn **prev;
+
+  if(conn->lport != 0) {
+    for(prev = UDP_CONN_HASH(conn->lport); *prev; prev = &(*prev)->hash_next) {
+      if(*prev == conn) {
+        *prev = conn->hash_next;
+        break;
+      }
+    }
+  }
+
+  conn->lport = port;
+  conn->hash_next = NULL;
+
+  if(port != 0) {
+    prev = UDP_CONN_HASH(port);
+    conn->hash_next = *prev;
+    *prev = conn;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+udp_port_used(uint16_t port)
+{
+  struct uip_udp_conn *c;
+
+  for(c = *UDP_CONN_HASH(port); c; c = c->hash_next) {
+    if(c->lport == port) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
 struct uip_udp_conn *
 uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
 {
@@ -577,18 +595,13 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
   uint8_t c;
 
   /* Find an unused local port. */
- again:
-  ++lastport;
+  do {
+    ++lastport;
 
-  if(lastport >= 32000) {
-    lastport = 4096;
-  }
-  
-  for(c = 0; c < UIP_UDP_CONNS; ++c) {
-    if(uip_udp_conns[c].lport == uip_htons(lastport)) {
-      goto again;
+    if(lastport >= 32000) {
+      lastport = 4096;
     }
-  }
+  } while(udp_port_used(uip_htons(lastport)));
 
   conn = 0;
   for(c = 0; c < UIP_UDP_CONNS; ++c) {
@@ -602,7 +615,7 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
     return 0;
   }
   
-  conn->lport = UIP_HTONS(lastport);
+  uip_udp_bind(conn, UIP_HTONS(lastport));
   conn->rport = rport;
   if(ripaddr == NULL) {
     memset(&conn->ripaddr, 0, sizeof(uip_ipaddr_t));
@@ -965,7 +978,7 @@ uip_process(struct net_buf *buf, uint8_t flag)
   register struct uip_conn *uip_connr = uip_conn;
 #endif /* UIP_TCP */
 #if UIP_UDP
-  int i;
+  struct uip_udp_conn *udp_conn;
   if(flag == UIP_UDP_SEND_CONN) {
     goto udp_send;
   }
@@ -1312,6 +1325,10 @@ uip_process(struct net_buf *buf, uint8_t flag)
       case UIP_PROTO_TCP:
         /* TCP, for both IPv4 and IPv6 */
         goto tcp_input;
+#elif defined(CONFIG_NETWORKING_WITH_TCP)
+      case UIP_PROTO_TCP:
+        /* TCP connections are handled by net_tcp.c */
+        goto net_tcp_input_hook;
 #endif /* UIP_TCP */
 #if UIP_UDP
       case UIP_PROTO_UDP:
@@ -1533,35 +1550,27 @@ uip_process(struct net_buf *buf, uint8_t flag)
     goto drop;
   }
 
-  /* Demultiplex this UDP packet between the UDP "connections". */
-  for(i = 0; i < UIP_UDP_CONNS; i++) {
-    /* If the local UDP port is non-zero, the connection is considered
-       to be used. If so, the local port number is checked against the
-       destination port number in the received packet. If the two port
-       numbers match, the remote port number is checked if the
-       connection is bound to a remote port. Finally, if the
-       connection is bound to a remote IP address, the source IP
-       address of the packet is checked. */
-#if 0
-    PRINTF("%d: %p lport %d <- %d rport %d <- %d addr ",
-	   i, &uip_udp_conns[i],
-	   uip_ntohs(uip_udp_conns[i].lport), uip_ntohs(UIP_UDP_BUF(buf)->destport),
-	   uip_ntohs(uip_udp_conns[i].rport), uip_ntohs(UIP_UDP_BUF(buf)->srcport));
-    PRINT6ADDR(&uip_udp_conns[i].ripaddr);
-    PRINTF(" <- ");
-    PRINT6ADDR(&UIP_IP_BUF(buf)->srcipaddr);
-    PRINTF("\n");
-#endif /* 0 */
-    if(uip_udp_conns[i].lport != 0 &&
-       UIP_UDP_BUF(buf)->destport == uip_udp_conns[i].lport &&
-       (uip_udp_conns[i].rport == 0 ||
-        UIP_UDP_BUF(buf)->srcport == uip_udp_conns[i].rport) &&
-       (uip_is_addr_unspecified(&uip_udp_conns[i].ripaddr) ||
-        uip_ipaddr_cmp(&UIP_IP_BUF(buf)->srcipaddr, &uip_udp_conns[i].ripaddr))) {
-      uip_set_udp_conn(buf) = &uip_udp_conns[i];
-      goto udp_found;
+  /* Demultiplex this UDP packet between the UDP "connections" bound to
+     its destination port. If the connection is bound to a remote port,
+     the remote port number is checked. Finally, if the connection is
+     bound to a remote IP address, the source IP address of the packet
+     is checked. Of several matching connections the first one of the
+     connection table is used, as with a scan of the whole table. */
+  uip_set_udp_conn(buf) = NULL;
+  for(udp_conn = *UDP_CONN_HASH(UIP_UDP_BUF(buf)->destport); udp_conn;
+      udp_conn = udp_conn->hash_next) {
+    if(UIP_UDP_BUF(buf)->destport == udp_conn->lport &&
+       (udp_conn->rport == 0 ||
+        UIP_UDP_BUF(buf)->srcport == udp_conn->rport) &&
+       (uip_is_addr_unspecified(&udp_conn->ripaddr) ||
+        uip_ipaddr_cmp(&UIP_IP_BUF(buf)->srcipaddr, &udp_conn->ripaddr)) &&
+       (uip_udp_conn(buf) == NULL || udp_conn < uip_udp_conn(buf))) {
+      uip_set_udp_conn(buf) = udp_conn;
     }
   }
+  if(uip_udp_conn(buf) != NULL) {
+    goto udp_found;
+  }
   uip_set_udp_conn(buf) = NULL;
   PRINTF("udp: no matching connection found\n");
   UIP_STAT(++uip_stat.udp.drop);
@@ -1637,6 +1646,28 @@ uip_process(struct net_buf *buf, uint8_t flag)
   goto ip_send_nolen;
 #endif /* UIP_UDP */
 
+#if !UIP_TCP && defined(CONFIG_NETWORKING_WITH_TCP)
+ net_tcp_input_hook:
+  remove_ext_hdr(buf);
+
+  if(uip_len(buf) < UIP_IPTCPH_LEN || uip_tcpchksum(buf) != 0xffff) {
+    UIP_STAT(++uip_stat.tcp.drop);
+    UIP_STAT(++uip_stat.tcp.chkerr);
+    PRINTF("tcp: bad checksum or length\n");
+    goto drop;
+  }
+  UIP_STAT(++uip_stat.tcp.recv);
+
+  /* As for UDP, a buffer queued to the application must not be
+   * released by the rx fiber, so uip_len(buf) is left as it is.
+   * Any reply is sent by net_tcp.c in a buffer of its own.
+   */
+  if(net_tcp_input(buf)) {
+    return 0;
+  }
+  goto drop;
+#endif /* !UIP_TCP && CONFIG_NETWORKING_WITH_TCP */
+
 #if UIP_TCP
   /* TCP input processing. */
  tcp_input:
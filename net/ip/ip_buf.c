@@ -168,11 +168,13 @@ static inline const char *type2str(enum ip_buf_type type)
 #ifdef DEBUG_IP_BUFS
 static struct net_buf *ip_buf_get_reserve_debug(enum ip_buf_type type,
 						uint16_t reserve_head,
+						int32_t timeout,
 						const char *caller,
 						int line)
 #else
 static struct net_buf *ip_buf_get_reserve(enum ip_buf_type type,
-					  uint16_t reserve_head)
+					  uint16_t reserve_head,
+					  int32_t timeout)
 #endif
 {
 	struct net_buf *buf = NULL;
@@ -189,11 +191,11 @@ static struct net_buf *ip_buf_get_reserve(enum ip_buf_type type,
 	 */
 	switch (type) {
 	case IP_BUF_RX:
-		buf = net_buf_get(&free_rx_bufs, 0);
+		buf = net_buf_get_timeout(&free_rx_bufs, 0, timeout);
 		dec_free_rx_bufs(buf);
 		break;
 	case IP_BUF_TX:
-		buf = net_buf_get(&free_tx_bufs, 0);
+		buf = net_buf_get_timeout(&free_tx_bufs, 0, timeout);
 		dec_free_tx_bufs(buf);
 		break;
 	}
@@ -235,9 +237,9 @@ struct net_buf *ip_buf_get_reserve_rx(uint16_t reserve_head)
 {
 #ifdef DEBUG_IP_BUFS
 	return ip_buf_get_reserve_debug(IP_BUF_RX, reserve_head,
-					caller, line);
+					TICKS_UNLIMITED, caller, line);
 #else
-	return ip_buf_get_reserve(IP_BUF_RX, reserve_head);
+	return ip_buf_get_reserve(IP_BUF_RX, reserve_head, TICKS_UNLIMITED);
 #endif
 }
 
@@ -249,9 +251,25 @@ struct net_buf *ip_buf_get_reserve_tx(uint16_t reserve_head)
 {
 #ifdef DEBUG_IP_BUFS
 	return ip_buf_get_reserve_debug(IP_BUF_TX, reserve_head,
-					caller, line);
+					TICKS_UNLIMITED, caller, line);
 #else
-	return ip_buf_get_reserve(IP_BUF_TX, reserve_head);
+	return ip_buf_get_reserve(IP_BUF_TX, reserve_head, TICKS_UNLIMITED);
+#endif
+}
+
+#ifdef DEBUG_IP_BUFS
+struct net_buf *ip_buf_get_reserve_tx_nowait_debug(uint16_t reserve_head,
+						   const char *caller,
+						   int line)
+#else
+struct net_buf *ip_buf_get_reserve_tx_nowait(uint16_t reserve_head)
+#endif
+{
+#ifdef DEBUG_IP_BUFS
+	return ip_buf_get_reserve_debug(IP_BUF_TX, reserve_head,
+					TICKS_NONE, caller, line);
+#else
+	return ip_buf_get_reserve(IP_BUF_TX, reserve_head, TICKS_NONE);
 #endif
 }
 
@@ -286,9 +304,10 @@ static struct net_buf *ip_buf_get(enum ip_buf_type type,
 	}
 
 #ifdef DEBUG_IP_BUFS
-	buf = ip_buf_get_reserve_debug(type, reserve, caller, line);
+	buf = ip_buf_get_reserve_debug(type, reserve, TICKS_UNLIMITED,
+				       caller, line);
 #else
-	buf = ip_buf_get_reserve(type, reserve);
+	buf = ip_buf_get_reserve(type, reserve, TICKS_UNLIMITED);
 #endif
 	if (!buf) {
 		return buf;
@@ -24,6 +24,8 @@
 #include <string.h>
 #include <errno.h>
 #include <stdbool.h>
+#include <misc/util.h>
+#include <misc/__assert.h>
 
 #include <net/net_ip.h>
 #include <net/net_socket.h>
@@ -34,29 +36,63 @@
 #include "contiki/os/lib/random.h"
 #include "contiki/ipv6/uip-ds6.h"
 
+#include "net_tcp.h"
+
 struct net_context {
 	/* Connection tuple identifies the connection */
 	struct net_tuple tuple;
 
+	/* Next context in the same bind hash bucket */
+	struct net_context *hash_next;
+
 	/* Application receives data via this fifo */
 	struct nano_fifo rx_queue;
 
 	/* Application connection data */
 	union {
 		struct simple_udp_connection udp;
+#ifdef CONFIG_NETWORKING_WITH_TCP
+		struct net_tcp *tcp;
+#endif
 	};
 
 	bool receiver_registered;
+
+	/* The context owns its local port, it is in the bind hash */
+	bool bound;
+
+	/* Bind hash bucket of the context, valid while it is bound */
+	uint8_t hash_index;
 };
 
-/* Override this in makefile if needed */
+/* Override these in makefile if needed */
 #ifndef NET_MAX_CONTEXT
 #define NET_MAX_CONTEXT 5
 #endif
 
+/* Number of bind hash buckets, a power of two */
+#ifndef NET_CONTEXT_HASH_SIZE
+#define NET_CONTEXT_HASH_SIZE 16
+#endif
+
+/* Ephemeral ports are allocated from the dynamic port range */
+#ifndef NET_EPHEMERAL_PORTS
+#define NET_EPHEMERAL_PORTS 256
+#endif
+#define NET_EPHEMERAL_PORT_BASE 49152
+#define EPHEMERAL_WORDS ((NET_EPHEMERAL_PORTS + 31) / 32)
+
 static struct net_context contexts[NET_MAX_CONTEXT];
 static struct nano_sem contexts_lock;
 
+/* Contexts hashed by protocol, local port and local address */
+static struct net_context *context_hash[NET_CONTEXT_HASH_SIZE];
+
+/* Ephemeral ports in use, one bit per port */
+static uint32_t ephemeral_ports[EPHEMERAL_WORDS];
+
+void net_context_release(struct net_context *context);
+
 static void context_sem_give(struct nano_sem *chan)
 {
 	switch (sys_execution_context_type_get()) {
@@ -73,17 +109,50 @@ static void context_sem_give(struct nano_sem *chan)
 	}
 }
 
+static inline bool context_addr_cmp(const struct net_addr *addr1,
+				     const struct net_addr *addr2)
+{
+	if (addr1->family != addr2->family) {
+		return false;
+	}
+
+#ifdef CONFIG_NETWORKING_WITH_IPV6
+	return !memcmp(&addr1->in6_addr, &addr2->in6_addr,
+		       sizeof(addr1->in6_addr));
+#else
+	return addr1->in_addr.s_addr[0] == addr2->in_addr.s_addr[0];
+#endif
+}
+
+static inline uint8_t context_hash_index(enum ip_protocol ip_proto,
+					 uint16_t local_port,
+					 const struct net_addr *addr)
+{
+	uint32_t hash = local_port ^ (ip_proto << 8);
+
+#ifdef CONFIG_NETWORKING_WITH_IPV6
+	hash ^= addr->in6_addr.s6_addr[15];
+#else
+	hash ^= addr->in_addr.s4_addr[3];
+#endif
+	hash ^= hash >> 8;
+
+	return hash & (NET_CONTEXT_HASH_SIZE - 1);
+}
+
 static int context_port_used(enum ip_protocol ip_proto, uint16_t local_port,
 			     const struct net_addr *local_addr)
 
 {
-	int i;
+	struct net_context *context;
 
-	for (i = 0; i < NET_MAX_CONTEXT; i++) {
-		if (contexts[i].tuple.ip_proto == ip_proto &&
-		    contexts[i].tuple.local_port == local_port &&
-		    !memcmp(&contexts[i].tuple.local_addr, local_addr,
-			   sizeof(struct net_addr))) {
+	context = context_hash[context_hash_index(ip_proto, local_port,
+						  local_addr)];
+
+	for (; context; context = context->hash_next) {
+		if (context->tuple.ip_proto == ip_proto &&
+		    context->tuple.local_port == local_port &&
+		    context_addr_cmp(context->tuple.local_addr, local_addr)) {
 			return -EEXIST;
 		}
 	}
@@ -91,6 +160,108 @@ static int context_port_used(enum ip_protocol ip_proto, uint16_t local_port,
 	return 0;
 }
 
+static inline bool ephemeral_port(uint16_t port, int *word, uint32_t *bit)
+{
+	int index = port - NET_EPHEMERAL_PORT_BASE;
+
+	if (port < NET_EPHEMERAL_PORT_BASE || index >= NET_EPHEMERAL_PORTS) {
+		return false;
+	}
+
+	*word = index / 32;
+	*bit = BIT(index % 32);
+
+	return true;
+}
+
+/* Take a free ephemeral port, the search starts from a random word so
+ * that the ports are not predictable.
+ */
+static uint16_t ephemeral_port_get(enum ip_protocol ip_proto,
+				   const struct net_addr *local_addr)
+{
+	int start = random_rand() % EPHEMERAL_WORDS;
+	uint32_t free;
+	uint16_t port;
+	int i, w, bit;
+
+	for (i = 0; i < EPHEMERAL_WORDS; i++) {
+		w = (start + i) % EPHEMERAL_WORDS;
+		free = ~ephemeral_ports[w];
+
+		while (free) {
+			bit = find_lsb_set(free) - 1;
+			free &= ~BIT(bit);
+
+			port = NET_EPHEMERAL_PORT_BASE + w * 32 + bit;
+			if (port - NET_EPHEMERAL_PORT_BASE >=
+			    NET_EPHEMERAL_PORTS) {
+				break;
+			}
+
+			/* The port may have been bound explicitly by a
+			 * context of another protocol or address.
+			 */
+			if (!context_port_used(ip_proto, port, local_addr)) {
+				return port;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static void context_bind(struct net_context *context)
+{
+	struct net_tuple *tuple = &context->tuple;
+	struct net_context **bucket;
+	uint32_t bit;
+	int word;
+
+	context->hash_index = context_hash_index(tuple->ip_proto,
+						 tuple->local_port,
+						 tuple->local_addr);
+	bucket = &context_hash[context->hash_index];
+	context->hash_next = *bucket;
+	*bucket = context;
+	context->bound = true;
+
+	if (ephemeral_port(tuple->local_port, &word, &bit)) {
+		ephemeral_ports[word] |= bit;
+	}
+}
+
+static void context_unbind(struct net_context *context)
+{
+	struct net_tuple *tuple = &context->tuple;
+	struct net_context **bucket;
+	uint32_t bit;
+	int word;
+
+	if (!context->bound) {
+		return;
+	}
+
+	/* The bucket is the one the context was bound in, even if the
+	 * tuple changed since.
+	 */
+	bucket = &context_hash[context->hash_index];
+	while (*bucket && *bucket != context) {
+		bucket = &(*bucket)->hash_next;
+	}
+
+	__ASSERT(*bucket, "Context %p not in its bind bucket\n", context);
+	if (*bucket) {
+		*bucket = context->hash_next;
+	}
+	context->hash_next = NULL;
+	context->bound = false;
+
+	if (ephemeral_port(tuple->local_port, &word, &bit)) {
+		ephemeral_ports[word] &= ~bit;
+	}
+}
+
 struct net_context *net_context_get(enum ip_protocol ip_proto,
 					const struct net_addr *remote_addr,
 					uint16_t remote_port,
@@ -134,13 +305,15 @@ struct net_context *net_context_get(enum ip_protocol ip_proto,
 
 	if (local_port) {
 		if (context_port_used(ip_proto, local_port, local_addr) < 0) {
+			context_sem_give(&contexts_lock);
 			return NULL;
 		}
 	} else {
-		do {
-			local_port = random_rand() | 0x8000;
-		} while (context_port_used(ip_proto, local_port,
-					   local_addr) == -EEXIST);
+		local_port = ephemeral_port_get(ip_proto, local_addr);
+		if (!local_port) {
+			context_sem_give(&contexts_lock);
+			return NULL;
+		}
 	}
 
 	for (i = 0; i < NET_MAX_CONTEXT; i++) {
@@ -151,6 +324,7 @@ struct net_context *net_context_get(enum ip_protocol ip_proto,
 			contexts[i].tuple.local_addr = (struct net_addr *)local_addr;
 			contexts[i].tuple.local_port = local_port;
 			context = &contexts[i];
+			context_bind(context);
 			break;
 		}
 	}
@@ -167,13 +341,93 @@ struct net_context *net_context_get(enum ip_protocol ip_proto,
 	}
 #endif
 
+#ifdef CONFIG_NETWORKING_WITH_TCP
+	if (context && ip_proto == IPPROTO_TCP) {
+		context->tcp = net_tcp_get(context);
+		if (!context->tcp) {
+			net_context_release(context);
+			return NULL;
+		}
+	}
+#endif
+
 	return context;
 }
 
+#ifdef CONFIG_NETWORKING_WITH_TCP
+/* Called in the RX fiber when a listening context gets a connection */
+struct net_context *net_context_get_accepted(const struct net_tuple *tuple,
+					     struct net_tcp *tcp)
+{
+	struct net_context *context = NULL;
+	int i;
+
+	/* Do not block the RX fiber, the peer will send its SYN again */
+	if (!nano_sem_take(&contexts_lock, TICKS_NONE)) {
+		return NULL;
+	}
+
+	for (i = 0; i < NET_MAX_CONTEXT; i++) {
+		if (!contexts[i].tuple.ip_proto) {
+			contexts[i].tuple = *tuple;
+			contexts[i].tcp = tcp;
+			context = &contexts[i];
+			break;
+		}
+	}
+
+	context_sem_give(&contexts_lock);
+
+	return context;
+}
+
+struct net_tcp *net_context_get_tcp(struct net_context *context)
+{
+	if (!context || context->tuple.ip_proto != IPPROTO_TCP) {
+		return NULL;
+	}
+
+	return context->tcp;
+}
+
+struct net_context *net_context_accept(struct net_context *context,
+				       int32_t timeout)
+{
+	struct net_tcp *tcp = net_context_get_tcp(context);
+
+	if (!tcp) {
+		return NULL;
+	}
+
+	return net_tcp_accept(tcp, timeout);
+}
+#endif /* CONFIG_NETWORKING_WITH_TCP */
+
 void net_context_put(struct net_context *context)
+{
+#ifdef CONFIG_NETWORKING_WITH_TCP
+	if (context->tuple.ip_proto == IPPROTO_TCP) {
+		/* The context is released once the connection is closed */
+		net_tcp_put(context->tcp);
+		return;
+	}
+#endif
+
+	net_context_release(context);
+}
+
+void net_context_release(struct net_context *context)
 {
 	nano_sem_take(&contexts_lock, TICKS_UNLIMITED);
 
+	context_unbind(context);
+
+	/* Stop the uIP connection from delivering data to the context */
+	if (context->tuple.ip_proto == IPPROTO_UDP &&
+	    context->receiver_registered && context->udp.udp_conn) {
+		uip_udp_remove(context->udp.udp_conn);
+	}
+
 	memset(&context->tuple, 0, sizeof(context->tuple));
 	memset(&context->udp, 0, sizeof(context->udp));
 	context->receiver_registered = false;
@@ -215,6 +469,8 @@ void net_context_init(void)
 	nano_sem_init(&contexts_lock);
 
 	memset(contexts, 0, sizeof(contexts));
+	memset(context_hash, 0, sizeof(context_hash));
+	memset(ephemeral_ports, 0, sizeof(ephemeral_ports));
 
 	for (i = 0; i < NET_MAX_CONTEXT; i++) {
 		nano_fifo_init(&contexts[i].rx_queue);
@@ -53,6 +53,8 @@
 #include "contiki/ip/simple-udp.h"
 #include "contiki/os/dev/slip.h"
 
+#include "net_tcp.h"
+
 #ifdef CONFIG_15_4_BEACON_SUPPORT
 #include "contiki/mac/handler-802154.h"
 #endif
@@ -65,6 +67,7 @@ struct simple_udp_connection *
 	net_context_get_udp_connection(struct net_context *context);
 int net_context_get_receiver_registered(struct net_context *context);
 void net_context_set_receiver_registered(struct net_context *context);
+struct net_tcp *net_context_get_tcp(struct net_context *context);
 
 /* Stacks for the tx & rx fibers.
  * FIXME: stack size needs fine-tuning
@@ -98,10 +101,35 @@ static struct net_dev {
 /* Called by application to send a packet */
 int net_send(struct net_buf *buf)
 {
+#ifdef CONFIG_NETWORKING_WITH_TCP
+	struct net_tcp *tcp;
+	int ret;
+#endif
+
 	if (ip_buf_len(buf) == 0) {
 		return -ENODATA;
 	}
 
+#ifdef CONFIG_NETWORKING_WITH_TCP
+	tcp = net_context_get_tcp(ip_buf_context(buf));
+	if (tcp) {
+		if (ip_buf_appdatalen(buf) == 0) {
+			ip_buf_appdatalen(buf) = buf->len -
+						 ip_buf_reserve(buf);
+		}
+
+		/* Wait until the connection takes more data, a buffer
+		 * without data only runs the connection.
+		 */
+		if (ip_buf_appdatalen(buf)) {
+			ret = net_tcp_send_wait(tcp);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+	}
+#endif
+
 	nano_fifo_put(&netdev.tx_queue, buf);
 
 	return 0;
@@ -169,6 +197,17 @@ static void stats(void)
 		NET_DBG("UDP chkerr     %d\n",
 			STAT(icmp.chkerr));
 
+#ifdef CONFIG_NETWORKING_WITH_TCP
+		NET_DBG("TCP recv       %d\tsent\t%d\tdrop\t%d\n",
+			STAT(tcp.recv),
+			STAT(tcp.sent),
+			STAT(tcp.drop));
+		NET_DBG("TCP chkerr     %d\trexmit\t%d\trst\t%d\n",
+			STAT(tcp.chkerr),
+			STAT(tcp.rexmit),
+			STAT(tcp.rst));
+#endif
+
 #if NET_COAP_CONF_STATS
 		NET_DBG("CoAP recv      %d\terr\t%d\tsent\t%d\tre-sent\t%d\n",
 			NET_COAP_STAT(recv),
@@ -335,8 +374,15 @@ int net_reply(struct net_context *context, struct net_buf *buf)
 		ret = udp_prepare_and_send(context, buf);
 		break;
 	case IPPROTO_TCP:
+#ifdef CONFIG_NETWORKING_WITH_TCP
+		/* The reply goes to the peer of the connection */
+		ip_buf_context(buf) = context;
+		ret = net_send(buf);
+		break;
+#else
 		NET_DBG("TCP not yet supported\n");
 		return -EINVAL;
+#endif
 	case IPPROTO_ICMPV6:
 		NET_DBG("ICMPv6 not yet supported\n");
 		return -EINVAL;
@@ -414,6 +460,9 @@ struct net_buf *net_receive(struct net_context *context, int32_t timeout)
 	struct net_tuple *tuple;
 	int ret = 0;
 	uint16_t reserve = 0;
+#ifdef CONFIG_NETWORKING_WITH_TCP
+	struct net_tcp *tcp = NULL;
+#endif
 
 	tuple = net_context_get_tuple(context);
 	if (!tuple) {
@@ -446,8 +495,21 @@ struct net_buf *net_receive(struct net_context *context, int32_t timeout)
 		reserve = UIP_IPUDPH_LEN + UIP_LLH_LEN;
 		break;
 	case IPPROTO_TCP:
+#ifdef CONFIG_NETWORKING_WITH_TCP
+		tcp = net_context_get_tcp(context);
+		if (!tcp) {
+			ret = -EINVAL;
+			break;
+		}
+
+		/* Only the data already queued is left to be read */
+		if (net_tcp_eof(tcp)) {
+			timeout = TICKS_NONE;
+		}
+#else
 		NET_DBG("TCP not yet supported\n");
 		ret = -EINVAL;
+#endif
 		break;
 	case IPPROTO_ICMPV6:
 		NET_DBG("ICMPv6 not yet supported\n");
@@ -485,6 +547,12 @@ struct net_buf *net_receive(struct net_context *context, int32_t timeout)
 		ip_buf_appdata(buf) = &uip_buf(buf)[reserve];
 	}
 
+#ifdef CONFIG_NETWORKING_WITH_TCP
+	if (buf && tcp) {
+		buf = net_tcp_received(tcp, buf);
+	}
+#endif
+
 	return buf;
 }
 
@@ -573,8 +641,12 @@ static int check_and_send_packet(struct net_buf *buf)
 				      uip_appdatalen(buf));
 		break;
 	case IPPROTO_TCP:
+#ifdef CONFIG_NETWORKING_WITH_TCP
+		ret = net_tcp_send(buf);
+#else
 		NET_DBG("TCP not yet supported\n");
 		ret = -EINVAL;
+#endif
 		break;
 	case IPPROTO_ICMPV6:
 		NET_DBG("ICMPv6 not yet supported\n");
@@ -875,6 +947,10 @@ int net_init(void)
 	ip_buf_init();
 	l2_buf_init();
 
+#ifdef CONFIG_NETWORKING_WITH_TCP
+	net_tcp_init();
+#endif
+
 	init_tx_queue();
 	init_rx_queue();
 	init_timer_fiber();
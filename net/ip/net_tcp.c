@@ -0,0 +1,1471 @@
+/** @file
+ * @brief TCP connections of the network contexts
+ *
+ * The connections only run in the IP stack fibers: segments are received
+ * in the RX fiber, application data is taken in the TX fiber and the
+ * retransmissions are done in the timer fiber. These fibers have the same
+ * priority so the connection state needs no locking, the application only
+ * touches the atomic fields and the queues.
+ *
+ * Received data is not copied: the segment buffers are queued to the
+ * application as they are. Sent data is copied to a per connection send
+ * buffer and stays there until acknowledged, so that several segments can
+ * be in flight and be retransmitted from it.
+ */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef CONFIG_NETWORKING_WITH_LOGGING
+#define DEBUG 1
+#endif
+#include "contiki/ip/uip-debug.h"
+
+#include <nanokernel.h>
+#include <atomic.h>
+#include <string.h>
+#include <errno.h>
+#include <misc/util.h>
+
+#include <net/ip_buf.h>
+#include <net/net_core.h>
+#include <net/net_ip.h>
+#include <net/net_socket.h>
+
+#include "contiki/ip/tcpip.h"
+#include "contiki/ipv6/uip-ds6.h"
+#include "contiki/os/sys/ctimer.h"
+#include "contiki/os/lib/random.h"
+
+#include "net_tcp.h"
+
+/* Declare some private functions only to be used in this file so the
+ * prototypes are not found in .h file.
+ */
+struct nano_fifo *net_context_get_queue(struct net_context *context);
+struct net_context *net_context_get_accepted(const struct net_tuple *tuple,
+					     struct net_tcp *tcp);
+void net_context_release(struct net_context *context);
+
+#define TCP_FIN 0x01
+#define TCP_SYN 0x02
+#define TCP_RST 0x04
+#define TCP_PSH 0x08
+#define TCP_ACK 0x10
+
+#define TCP_OPT_END     0
+#define TCP_OPT_NOOP    1
+#define TCP_OPT_MSS     2
+#define TCP_OPT_MSS_LEN 4
+
+#define TCP_MAX_RETRIES 8
+#define TCP_RTO_INITIAL CLOCK_SECOND
+#define TCP_RTO_MIN     (CLOCK_SECOND / 5)
+#define TCP_RTO_MAX     (60 * CLOCK_SECOND)
+#define TCP_TIME_WAIT_TIMEOUT (2 * CLOCK_SECOND)
+
+#define TCP_SEND_SIZE   CONFIG_TCP_SEND_BUFFER_SIZE
+
+/* The receive window is advertised again once it grew by this much */
+#define TCP_WND_UPDATE  min(UIP_TCP_MSS, CONFIG_TCP_RECEIVE_WINDOW / 2)
+
+#define SEQ_LT(a, b)    ((int32_t)((a) - (b)) < 0)
+#define SEQ_LEQ(a, b)   ((int32_t)((a) - (b)) <= 0)
+#define SEQ_GT(a, b)    ((int32_t)((a) - (b)) > 0)
+#define SEQ_GEQ(a, b)   ((int32_t)((a) - (b)) >= 0)
+
+enum tcp_state {
+	TCP_STATE_CLOSED = 0,
+	TCP_STATE_LISTEN,
+	TCP_STATE_SYN_SENT,
+	TCP_STATE_SYN_RECEIVED,
+	TCP_STATE_ESTABLISHED,
+	TCP_STATE_FIN_WAIT_1,
+	TCP_STATE_FIN_WAIT_2,
+	TCP_STATE_CLOSING,
+	TCP_STATE_TIME_WAIT,
+	TCP_STATE_CLOSE_WAIT,
+	TCP_STATE_LAST_ACK,
+};
+
+enum {
+	/* Connection to be opened by the TX fiber */
+	TCP_FLAG_CONNECT,
+	/* Context released by the application */
+	TCP_FLAG_CLOSE,
+	/* All the data of the peer has been received */
+	TCP_FLAG_EOF,
+	/* An ACK is due to the peer */
+	TCP_FLAG_ACK_NOW,
+	/* The application reading data should have the window advertised */
+	TCP_FLAG_WND_UPDATE,
+};
+
+struct net_tcp {
+	/* Used by the accept fifo of the listener, must be first */
+	void *fifo_reserved;
+
+	struct net_context *context;
+	struct net_tcp *listener;
+	enum tcp_state state;
+	atomic_t flags;
+
+	/* Send sequence space */
+	uint32_t iss;
+	uint32_t snd_una;
+	uint32_t snd_nxt;
+	uint32_t snd_max;
+	uint16_t snd_wnd;
+	uint16_t mss;
+	uint32_t cwnd;
+	uint32_t ssthresh;
+	uint8_t dupacks;
+	uint8_t retries;
+
+	/* Receive sequence space */
+	uint32_t rcv_nxt;
+	uint32_t rcv_adv;
+	atomic_t rcv_queued;
+
+	/* Round trip time estimation, RFC 6298. The smoothed round trip
+	 * time is scaled by 8 and its variation by 4, all in ticks.
+	 */
+	uint32_t srtt;
+	uint32_t rttvar;
+	uint32_t rto;
+	uint32_t rtt_seq;
+	clock_time_t rtt_start;
+	bool rtt_timing;
+
+	/* Data not yet acknowledged, the first byte is at snd_una */
+	uint8_t send_buf[TCP_SEND_SIZE];
+	uint16_t send_head;
+	uint16_t send_len;
+
+	/* Application buffer waiting for room in the send buffer */
+	struct net_buf *send_pending;
+	struct nano_sem send_sem;
+
+	/* End of stream marker, reserved when the connection is created */
+	struct net_buf *eof_buf;
+
+	struct ctimer timer;
+
+	/* Connections established on a listening context */
+	struct nano_fifo accept_q;
+
+	/* Addresses of an accepted connection */
+	struct net_addr remote_addr;
+	struct net_addr local_addr;
+
+#ifdef CONFIG_NETWORKING_IPV6_NO_ND
+	uip_ds6_route_t *route;
+#endif
+};
+
+static struct net_tcp tcp_conns[CONFIG_TCP_CONNS];
+
+/* The end of stream markers carry no data. Each connection holds one, so
+ * that the receiver is woken up even if the peer closes the connection
+ * while the buffer pools are empty.
+ */
+static struct nano_fifo eof_bufs;
+static NET_BUF_POOL(eof_pool, CONFIG_TCP_CONNS, 0, &eof_bufs, NULL,
+		    sizeof(struct ip_buf));
+
+static inline uint32_t get_seq(const uint8_t *seq)
+{
+	return ((uint32_t)seq[0] << 24) | ((uint32_t)seq[1] << 16) |
+	       ((uint32_t)seq[2] << 8) | seq[3];
+}
+
+static inline void put_seq(uint8_t *seq, uint32_t val)
+{
+	seq[0] = val >> 24;
+	seq[1] = val >> 16;
+	seq[2] = val >> 8;
+	seq[3] = val;
+}
+
+static inline struct net_tuple *tcp_tuple(struct net_tcp *tcp)
+{
+	return net_context_get_tuple(tcp->context);
+}
+
+static struct net_tcp *tcp_alloc(struct net_context *context)
+{
+	struct net_tcp *tcp = NULL;
+	unsigned int key;
+	int i;
+
+	/* Connections are allocated by the application and the RX fiber */
+	key = irq_lock();
+	for (i = 0; i < CONFIG_TCP_CONNS; i++) {
+		if (!tcp_conns[i].context) {
+			tcp = &tcp_conns[i];
+			tcp->context = context;
+			break;
+		}
+	}
+	irq_unlock(key);
+
+	if (!tcp) {
+		return NULL;
+	}
+
+	memset((uint8_t *)tcp + offsetof(struct net_tcp, listener), 0,
+	       sizeof(*tcp) - offsetof(struct net_tcp, listener));
+
+	/* A marker not read yet may outlive its connection for a while */
+	tcp->eof_buf = net_buf_get_timeout(&eof_bufs, 0, TICKS_NONE);
+	if (!tcp->eof_buf) {
+		NET_DBG("No end of stream marker for context %p\n", context);
+		tcp->context = NULL;
+		return NULL;
+	}
+
+	tcp->mss = UIP_TCP_MSS;
+	tcp->cwnd = 3 * UIP_TCP_MSS;
+	tcp->ssthresh = 0xffff;
+	tcp->rto = TCP_RTO_INITIAL;
+
+	nano_fifo_init(&tcp->accept_q);
+	nano_sem_init(&tcp->send_sem);
+	nano_sem_give(&tcp->send_sem);
+
+	return tcp;
+}
+
+/* Give back a connection that was not used */
+static void tcp_free(struct net_tcp *tcp)
+{
+	if (tcp->eof_buf) {
+		net_buf_unref(tcp->eof_buf);
+		tcp->eof_buf = NULL;
+	}
+
+	tcp->context = NULL;
+}
+
+static inline uint16_t tcp_rcv_wnd(struct net_tcp *tcp)
+{
+	int32_t wnd;
+
+	wnd = CONFIG_TCP_RECEIVE_WINDOW - atomic_get(&tcp->rcv_queued);
+
+	return wnd > 0 ? min(wnd, 0xffff) : 0;
+}
+
+static void tcp_rtt_update(struct net_tcp *tcp, uint32_t rtt)
+{
+	int32_t delta;
+
+	if (!tcp->srtt) {
+		tcp->srtt = rtt << 3;
+		tcp->rttvar = rtt << 1;
+	} else {
+		delta = rtt - (tcp->srtt >> 3);
+		tcp->srtt += delta;
+		if (delta < 0) {
+			delta = -delta;
+		}
+		tcp->rttvar += delta - (tcp->rttvar >> 2);
+	}
+
+	tcp->rto = (tcp->srtt >> 3) + tcp->rttvar;
+	tcp->rto = max(tcp->rto, TCP_RTO_MIN);
+	tcp->rto = min(tcp->rto, TCP_RTO_MAX);
+}
+
+/* Set the IPv6 header and the checksum, and send the segment */
+static void tcp_transmit(struct net_buf *buf)
+{
+	struct uip_tcp_hdr *hdr = NET_BUF_TCP(buf);
+
+	uip_len(buf) = buf->len;
+	uip_ext_len(buf) = 0;
+
+	NET_BUF_IP(buf)->vtc = 0x60;
+	NET_BUF_IP(buf)->tcflow = 0;
+	NET_BUF_IP(buf)->flow = 0;
+	NET_BUF_IP(buf)->len[0] = (buf->len - UIP_IPH_LEN) >> 8;
+	NET_BUF_IP(buf)->len[1] = (buf->len - UIP_IPH_LEN) & 0xff;
+	NET_BUF_IP(buf)->proto = UIP_PROTO_TCP;
+	NET_BUF_IP(buf)->ttl = uip_ds6_if.cur_hop_limit;
+
+	hdr->urgp[0] = hdr->urgp[1] = 0;
+	hdr->tcpchksum = 0;
+	hdr->tcpchksum = ~(uip_tcpchksum(buf));
+
+	UIP_STAT(++uip_stat.tcp.sent);
+
+	if (!tcpip_ipv6_output(buf)) {
+		ip_buf_unref(buf);
+	}
+}
+
+/* Copy len bytes of the send buffer starting at seq to the segment */
+static void tcp_copy_data(struct net_tcp *tcp, struct net_buf *buf,
+			  uint32_t seq, uint16_t len)
+{
+	uint16_t off = (tcp->send_head + (seq - tcp->snd_una)) % TCP_SEND_SIZE;
+	uint16_t chunk = min(len, TCP_SEND_SIZE - off);
+
+	memcpy(net_buf_add(buf, chunk), &tcp->send_buf[off], chunk);
+	if (chunk < len) {
+		memcpy(net_buf_add(buf, len - chunk), tcp->send_buf,
+		       len - chunk);
+	}
+}
+
+/* Send a segment of the connection, the data is taken from the send
+ * buffer. Returns -ENOBUFS if there is no buffer to send it in.
+ */
+static int tcp_send(struct net_tcp *tcp, uint32_t seq, uint16_t len,
+		    uint8_t flags)
+{
+	struct net_tuple *tuple = tcp_tuple(tcp);
+	uint8_t hdr_len = UIP_TCPH_LEN;
+	struct uip_tcp_hdr *hdr;
+	struct net_buf *buf;
+	uint16_t wnd;
+
+	if (flags & TCP_SYN) {
+		hdr_len += TCP_OPT_MSS_LEN;
+	}
+
+	buf = ip_buf_get_reserve_tx_nowait(UIP_IPH_LEN + hdr_len);
+	if (!buf) {
+		/* Have the application retry when it reads data */
+		atomic_set_bit(&tcp->flags, TCP_FLAG_WND_UPDATE);
+		return -ENOBUFS;
+	}
+
+	ip_buf_context(buf) = tcp->context;
+	ip_buf_appdatalen(buf) = len;
+
+	if (len) {
+		tcp_copy_data(tcp, buf, seq, len);
+	}
+
+	hdr = NET_BUF_TCP(buf);
+	hdr->srcport = uip_htons(tuple->local_port);
+	hdr->destport = uip_htons(tuple->remote_port);
+	put_seq(hdr->seqno, seq);
+	put_seq(hdr->ackno, (flags & TCP_ACK) ? tcp->rcv_nxt : 0);
+	hdr->tcpoffset = (hdr_len / 4) << 4;
+	hdr->flags = flags;
+
+	wnd = tcp_rcv_wnd(tcp);
+	hdr->wnd[0] = wnd >> 8;
+	hdr->wnd[1] = wnd & 0xff;
+
+	if (flags & TCP_SYN) {
+		hdr->optdata[0] = TCP_OPT_MSS;
+		hdr->optdata[1] = TCP_OPT_MSS_LEN;
+		hdr->optdata[2] = UIP_TCP_MSS >> 8;
+		hdr->optdata[3] = UIP_TCP_MSS & 0xff;
+	}
+
+	uip_ipaddr_copy(&NET_BUF_IP(buf)->srcipaddr,
+			(uip_ipaddr_t *)&tuple->local_addr->in6_addr);
+	uip_ipaddr_copy(&NET_BUF_IP(buf)->destipaddr,
+			(uip_ipaddr_t *)&tuple->remote_addr->in6_addr);
+
+	tcp->rcv_adv = tcp->rcv_nxt + wnd;
+	if (wnd < TCP_WND_UPDATE) {
+		atomic_set_bit(&tcp->flags, TCP_FLAG_WND_UPDATE);
+	}
+	atomic_clear_bit(&tcp->flags, TCP_FLAG_ACK_NOW);
+
+	tcp_transmit(buf);
+
+	return 0;
+}
+
+/* Answer a segment that has no connection with a reset */
+static void tcp_send_reset(struct net_buf *in, uint16_t len)
+{
+	struct uip_tcp_hdr *in_hdr = NET_BUF_TCP(in);
+	struct uip_tcp_hdr *hdr;
+	struct net_buf *buf;
+
+	if (in_hdr->flags & TCP_RST) {
+		return;
+	}
+
+	buf = ip_buf_get_reserve_tx_nowait(UIP_IPTCPH_LEN);
+	if (!buf) {
+		return;
+	}
+
+	ip_buf_context(buf) = NULL;
+	ip_buf_appdatalen(buf) = 0;
+
+	hdr = NET_BUF_TCP(buf);
+	memset(hdr, 0, UIP_TCPH_LEN);
+	hdr->srcport = in_hdr->destport;
+	hdr->destport = in_hdr->srcport;
+	hdr->tcpoffset = (UIP_TCPH_LEN / 4) << 4;
+
+	if (in_hdr->flags & TCP_ACK) {
+		memcpy(hdr->seqno, in_hdr->ackno, sizeof(hdr->seqno));
+		hdr->flags = TCP_RST;
+	} else {
+		len += !!(in_hdr->flags & TCP_SYN) +
+		       !!(in_hdr->flags & TCP_FIN);
+		put_seq(hdr->ackno, get_seq(in_hdr->seqno) + len);
+		hdr->flags = TCP_RST | TCP_ACK;
+	}
+
+	uip_ipaddr_copy(&NET_BUF_IP(buf)->srcipaddr,
+			&NET_BUF_IP(in)->destipaddr);
+	uip_ipaddr_copy(&NET_BUF_IP(buf)->destipaddr,
+			&NET_BUF_IP(in)->srcipaddr);
+
+	tcp_transmit(buf);
+}
+
+static inline void tcp_timer_start(struct net_tcp *tcp, clock_time_t ticks);
+
+static void tcp_release(struct net_tcp *tcp)
+{
+	struct nano_fifo *queue = net_context_get_queue(tcp->context);
+	struct net_buf *buf;
+
+	NET_DBG("tcp %p context %p released\n", tcp, tcp->context);
+
+	ctimer_stop(&tcp->timer);
+	tcp->state = TCP_STATE_CLOSED;
+
+	if (tcp->send_pending) {
+		ip_buf_unref(tcp->send_pending);
+		tcp->send_pending = NULL;
+	}
+
+	while ((buf = nano_fifo_get(queue, TICKS_NONE))) {
+		ip_buf_unref(buf);
+	}
+
+#ifdef CONFIG_NETWORKING_IPV6_NO_ND
+	if (tcp->route) {
+		/* This will also remove the neighbor cache entry */
+		uip_ds6_route_rm(tcp->route);
+		tcp->route = NULL;
+	}
+#endif
+
+	net_context_release(tcp->context);
+	tcp_free(tcp);
+}
+
+/* Mark the end of the stream and wake up the receiver with the marker of
+ * the connection.
+ */
+static void tcp_eof(struct net_tcp *tcp)
+{
+	struct net_buf *buf = tcp->eof_buf;
+
+	atomic_set_bit(&tcp->flags, TCP_FLAG_EOF);
+
+	if (atomic_test_bit(&tcp->flags, TCP_FLAG_CLOSE) || !buf) {
+		return;
+	}
+
+	tcp->eof_buf = NULL;
+	ip_buf_type(buf) = IP_BUF_RX;
+	ip_buf_appdatalen(buf) = 0;
+	nano_fifo_put(net_context_get_queue(tcp->context), buf);
+}
+
+/* The connection is gone: release it if nobody owns it anymore, else
+ * report the end of the stream to the application.
+ */
+static void tcp_abort(struct net_tcp *tcp)
+{
+	enum tcp_state state = tcp->state;
+
+	NET_DBG("tcp %p aborted in state %d\n", tcp, state);
+
+	tcp->state = TCP_STATE_CLOSED;
+	ctimer_stop(&tcp->timer);
+
+	if (tcp->send_pending) {
+		ip_buf_unref(tcp->send_pending);
+		tcp->send_pending = NULL;
+		nano_sem_give(&tcp->send_sem);
+	}
+
+	if (state == TCP_STATE_SYN_RECEIVED ||
+	    atomic_test_bit(&tcp->flags, TCP_FLAG_CLOSE)) {
+		tcp_release(tcp);
+		return;
+	}
+
+	tcp_eof(tcp);
+}
+
+/* Copy the pending application data to the send buffer */
+static void tcp_fill(struct net_tcp *tcp)
+{
+	struct net_buf *buf = tcp->send_pending;
+	uint16_t len, tail, chunk;
+	uint8_t *data;
+
+	if (!buf) {
+		return;
+	}
+
+	len = min(TCP_SEND_SIZE - tcp->send_len, ip_buf_appdatalen(buf));
+	tail = (tcp->send_head + tcp->send_len) % TCP_SEND_SIZE;
+	chunk = min(len, TCP_SEND_SIZE - tail);
+	data = ip_buf_appdata(buf);
+
+	memcpy(&tcp->send_buf[tail], data, chunk);
+	memcpy(tcp->send_buf, data + chunk, len - chunk);
+	tcp->send_len += len;
+
+	ip_buf_appdata(buf) = data + len;
+	ip_buf_appdatalen(buf) -= len;
+
+	if (!ip_buf_appdatalen(buf)) {
+		ip_buf_unref(buf);
+		tcp->send_pending = NULL;
+		nano_sem_give(&tcp->send_sem);
+	}
+}
+
+/* True if the FIN is to be sent after the data of the send buffer */
+static inline bool tcp_fin_queued(struct net_tcp *tcp)
+{
+	return (tcp->state == TCP_STATE_FIN_WAIT_1 ||
+		tcp->state == TCP_STATE_CLOSING ||
+		tcp->state == TCP_STATE_LAST_ACK) && !tcp->send_pending;
+}
+
+/* Send what the windows allow and the ACK due, if any */
+static void tcp_output(struct net_tcp *tcp)
+{
+	uint32_t wnd, in_flight;
+	uint16_t len;
+	uint8_t flags;
+
+	switch (tcp->state) {
+	case TCP_STATE_ESTABLISHED:
+	case TCP_STATE_CLOSE_WAIT:
+	case TCP_STATE_FIN_WAIT_1:
+	case TCP_STATE_CLOSING:
+	case TCP_STATE_LAST_ACK:
+		break;
+	case TCP_STATE_FIN_WAIT_2:
+	case TCP_STATE_TIME_WAIT:
+		goto ack;
+	default:
+		return;
+	}
+
+	tcp_fill(tcp);
+
+	wnd = min(tcp->snd_wnd, tcp->cwnd);
+
+	while (1) {
+		in_flight = tcp->snd_nxt - tcp->snd_una;
+		if (in_flight > tcp->send_len) {
+			/* The FIN was sent */
+			break;
+		}
+
+		len = min(tcp->send_len - in_flight, tcp->mss);
+		if (in_flight + len > wnd) {
+			if (!in_flight && !tcp->snd_wnd) {
+				/* Zero window probe, retransmitted with
+				 * backoff until the window opens.
+				 */
+				len = 1;
+			} else if (wnd <= in_flight ||
+				   (in_flight && wnd - in_flight < tcp->mss)) {
+				/* Wait for room for a full segment */
+				break;
+			} else {
+				len = wnd - in_flight;
+			}
+		}
+
+		flags = TCP_ACK;
+		if (in_flight + len == tcp->send_len) {
+			if (tcp_fin_queued(tcp)) {
+				flags |= TCP_FIN;
+			} else if (len) {
+				flags |= TCP_PSH;
+			}
+		}
+
+		if (!len && !(flags & TCP_FIN)) {
+			break;
+		}
+
+		if (tcp_send(tcp, tcp->snd_nxt, len, flags) < 0) {
+			break;
+		}
+
+		if (!in_flight) {
+			tcp_timer_start(tcp, tcp->rto);
+		}
+
+		/* Karn's algorithm: only time segments sent once */
+		if (!tcp->rtt_timing && tcp->snd_nxt == tcp->snd_max) {
+			tcp->rtt_timing = true;
+			tcp->rtt_seq = tcp->snd_nxt;
+			tcp->rtt_start = clock_time();
+		}
+
+		tcp->snd_nxt += len + !!(flags & TCP_FIN);
+		if (SEQ_GT(tcp->snd_nxt, tcp->snd_max)) {
+			tcp->snd_max = tcp->snd_nxt;
+		}
+
+		if (flags & TCP_FIN) {
+			break;
+		}
+	}
+
+ack:
+	if (atomic_test_bit(&tcp->flags, TCP_FLAG_ACK_NOW) ||
+	    SEQ_GEQ(tcp->rcv_nxt + tcp_rcv_wnd(tcp),
+		    tcp->rcv_adv + TCP_WND_UPDATE)) {
+		tcp_send(tcp, tcp->snd_nxt, 0, TCP_ACK);
+	} else if (tcp->rcv_adv - tcp->rcv_nxt < TCP_WND_UPDATE) {
+		atomic_set_bit(&tcp->flags, TCP_FLAG_WND_UPDATE);
+	}
+}
+
+static void tcp_send_syn(struct net_tcp *tcp)
+{
+	uint8_t flags = TCP_SYN;
+
+	if (tcp->state == TCP_STATE_SYN_RECEIVED) {
+		flags |= TCP_ACK;
+	}
+
+	tcp_send(tcp, tcp->iss, 0, flags);
+	tcp->snd_nxt = tcp->snd_max = tcp->iss + 1;
+
+	tcp_timer_start(tcp, tcp->rto);
+}
+
+static void tcp_timer_expired(struct net_buf *buf, void *ptr)
+{
+	struct net_tcp *tcp = ptr;
+
+	switch (tcp->state) {
+	case TCP_STATE_TIME_WAIT:
+		tcp_release(tcp);
+		return;
+	case TCP_STATE_SYN_SENT:
+	case TCP_STATE_SYN_RECEIVED:
+	case TCP_STATE_ESTABLISHED:
+	case TCP_STATE_CLOSE_WAIT:
+	case TCP_STATE_FIN_WAIT_1:
+	case TCP_STATE_CLOSING:
+	case TCP_STATE_LAST_ACK:
+		break;
+	default:
+		return;
+	}
+
+	if (tcp->snd_max == tcp->snd_una) {
+		return;
+	}
+
+	if (++tcp->retries > TCP_MAX_RETRIES) {
+		NET_DBG("tcp %p retransmission timeout\n", tcp);
+		if (tcp->state != TCP_STATE_SYN_SENT) {
+			tcp_send(tcp, tcp->snd_nxt, 0, TCP_RST | TCP_ACK);
+		}
+		tcp_abort(tcp);
+		return;
+	}
+
+	UIP_STAT(++uip_stat.tcp.rexmit);
+
+	tcp->rto = min(tcp->rto * 2, TCP_RTO_MAX);
+	tcp->rtt_timing = false;
+
+	if (tcp->state == TCP_STATE_SYN_SENT ||
+	    tcp->state == TCP_STATE_SYN_RECEIVED) {
+		tcp_send_syn(tcp);
+		return;
+	}
+
+	/* Go back to the first unacknowledged segment, RFC 5681 */
+	tcp->ssthresh = max((tcp->snd_max - tcp->snd_una) / 2,
+			    2 * (uint32_t)tcp->mss);
+	tcp->cwnd = tcp->mss;
+	tcp->dupacks = 0;
+	tcp->snd_nxt = tcp->snd_una;
+
+	tcp_output(tcp);
+}
+
+static inline void tcp_timer_start(struct net_tcp *tcp, clock_time_t ticks)
+{
+	ctimer_set(NULL, &tcp->timer, ticks, tcp_timer_expired, tcp);
+}
+
+static uint32_t tcp_new_iss(void)
+{
+	return ((uint32_t)random_rand() << 16) | random_rand();
+}
+
+static void tcp_open(struct net_tcp *tcp)
+{
+	tcp->iss = tcp_new_iss();
+	tcp->snd_una = tcp->iss;
+	tcp->state = TCP_STATE_SYN_SENT;
+
+	tcp_send_syn(tcp);
+}
+
+static void tcp_parse_options(struct net_tcp *tcp, struct net_buf *buf,
+			      uint8_t hdr_len)
+{
+	uint8_t *opt = (uint8_t *)NET_BUF_TCP(buf) + UIP_TCPH_LEN;
+	uint8_t *end = (uint8_t *)NET_BUF_TCP(buf) + hdr_len;
+	uint16_t mss;
+
+	while (opt < end && *opt != TCP_OPT_END) {
+		if (*opt == TCP_OPT_NOOP) {
+			opt++;
+			continue;
+		}
+
+		if (end - opt < 2 || opt[1] < 2 || end - opt < opt[1]) {
+			break;
+		}
+
+		if (opt[0] == TCP_OPT_MSS && opt[1] == TCP_OPT_MSS_LEN) {
+			mss = (opt[2] << 8) | opt[3];
+			if (mss) {
+				tcp->mss = min(mss, UIP_TCP_MSS);
+				tcp->cwnd = 3 * tcp->mss;
+			}
+		}
+
+		opt += opt[1];
+	}
+}
+
+static inline uint16_t tcp_get_wnd(struct uip_tcp_hdr *hdr)
+{
+	return (hdr->wnd[0] << 8) | hdr->wnd[1];
+}
+
+static struct net_tcp *tcp_lookup(struct net_buf *buf)
+{
+	struct uip_tcp_hdr *hdr = NET_BUF_TCP(buf);
+	uint16_t local_port = uip_ntohs(hdr->destport);
+	uint16_t remote_port = uip_ntohs(hdr->srcport);
+	struct net_tcp *listener = NULL;
+	struct net_tuple *tuple;
+	int i;
+
+	for (i = 0; i < CONFIG_TCP_CONNS; i++) {
+		struct net_tcp *tcp = &tcp_conns[i];
+
+		if (!tcp->context || tcp->state == TCP_STATE_CLOSED) {
+			continue;
+		}
+
+		tuple = tcp_tuple(tcp);
+		if (tuple->local_port != local_port) {
+			continue;
+		}
+
+		if (tcp->state == TCP_STATE_LISTEN) {
+			listener = tcp;
+			continue;
+		}
+
+		if (tuple->remote_port == remote_port &&
+		    uip_ipaddr_cmp(&NET_BUF_IP(buf)->srcipaddr,
+			(uip_ipaddr_t *)&tuple->remote_addr->in6_addr) &&
+		    uip_ipaddr_cmp(&NET_BUF_IP(buf)->destipaddr,
+			(uip_ipaddr_t *)&tuple->local_addr->in6_addr)) {
+			return tcp;
+		}
+	}
+
+	return listener;
+}
+
+#ifdef CONFIG_NETWORKING_IPV6_NO_ND
+/* Without neighbor discovery the peer must be added to the neighbor
+ * cache and routed to before replying, as udp_prepare_and_send() does.
+ */
+static void tcp_add_peer(struct net_tcp *tcp, struct net_buf *buf)
+{
+	uip_ipaddr_t *addr = (uip_ipaddr_t *)&tcp->remote_addr.in6_addr;
+
+	if (!uip_ds6_nbr_lookup(addr) &&
+	    !uip_ds6_nbr_add(addr, (const uip_lladdr_t *)&ip_buf_ll_src(buf),
+			     0, NBR_REACHABLE)) {
+		NET_DBG("Cannot add peer to neighbor cache\n");
+	}
+
+	if (!uip_ds6_route_lookup(addr)) {
+		tcp->route = uip_ds6_route_add(addr, 128, addr);
+	}
+}
+#else
+#define tcp_add_peer(...)
+#endif
+
+/* SYN received on a listening context: open a new connection */
+static void tcp_listen_input(struct net_tcp *listener, struct net_buf *buf,
+			     uint8_t hdr_len)
+{
+	struct uip_tcp_hdr *hdr = NET_BUF_TCP(buf);
+	struct net_tuple tuple;
+	struct net_tcp *tcp;
+
+	if (hdr->flags & TCP_RST) {
+		return;
+	}
+
+	if (hdr->flags & TCP_ACK) {
+		tcp_send_reset(buf, 0);
+		return;
+	}
+
+	if (!(hdr->flags & TCP_SYN)) {
+		return;
+	}
+
+	/* The slot is held by the listener context until the connection
+	 * gets its own.
+	 */
+	tcp = tcp_alloc(listener->context);
+	if (!tcp) {
+		UIP_STAT(++uip_stat.tcp.syndrop);
+		NET_DBG("No free connection for port %d\n",
+			uip_ntohs(hdr->destport));
+		return;
+	}
+
+	tcp->remote_addr.family = AF_INET6;
+	uip_ipaddr_copy((uip_ipaddr_t *)&tcp->remote_addr.in6_addr,
+			&NET_BUF_IP(buf)->srcipaddr);
+	tcp->local_addr.family = AF_INET6;
+	uip_ipaddr_copy((uip_ipaddr_t *)&tcp->local_addr.in6_addr,
+			&NET_BUF_IP(buf)->destipaddr);
+
+	tuple.ip_proto = IPPROTO_TCP;
+	tuple.remote_addr = &tcp->remote_addr;
+	tuple.remote_port = uip_ntohs(hdr->srcport);
+	tuple.local_addr = &tcp->local_addr;
+	tuple.local_port = uip_ntohs(hdr->destport);
+
+	tcp->context = net_context_get_accepted(&tuple, tcp);
+	if (!tcp->context) {
+		UIP_STAT(++uip_stat.tcp.syndrop);
+		NET_DBG("No free context for port %d\n", tuple.local_port);
+		tcp_free(tcp);
+		return;
+	}
+
+	tcp->listener = listener;
+	tcp->rcv_nxt = get_seq(hdr->seqno) + 1;
+	tcp->snd_wnd = tcp_get_wnd(hdr);
+	tcp_parse_options(tcp, buf, hdr_len);
+
+	tcp->iss = tcp_new_iss();
+	tcp->snd_una = tcp->iss;
+	tcp->state = TCP_STATE_SYN_RECEIVED;
+
+	tcp_add_peer(tcp, buf);
+
+	tcp_send_syn(tcp);
+}
+
+/* Process the acknowledgment of a segment */
+static void tcp_ack_input(struct net_tcp *tcp, uint32_t ack, uint16_t wnd,
+			  uint16_t len)
+{
+	uint32_t acked, data_end = tcp->snd_una + tcp->send_len;
+	bool fin_acked = false;
+
+	if (SEQ_GT(ack, tcp->snd_max)) {
+		UIP_STAT(++uip_stat.tcp.ackerr);
+		atomic_set_bit(&tcp->flags, TCP_FLAG_ACK_NOW);
+		return;
+	}
+
+	if (SEQ_LT(ack, tcp->snd_una)) {
+		return;
+	}
+
+	if (ack == tcp->snd_una) {
+		if (!len && wnd == tcp->snd_wnd &&
+		    tcp->snd_max != tcp->snd_una) {
+			/* Fast retransmit and recovery, RFC 5681 */
+			if (++tcp->dupacks == 3) {
+				tcp->ssthresh =
+					max((tcp->snd_max - tcp->snd_una) / 2,
+					    2 * (uint32_t)tcp->mss);
+				tcp->cwnd = tcp->ssthresh + 3 * tcp->mss;
+				tcp->rtt_timing = false;
+				UIP_STAT(++uip_stat.tcp.rexmit);
+				tcp_send(tcp, tcp->snd_una,
+					 min(tcp->send_len, tcp->mss),
+					 TCP_ACK);
+			} else if (tcp->dupacks > 3) {
+				tcp->cwnd += tcp->mss;
+			}
+		}
+
+		if (!wnd) {
+			/* The peer is alive, keep probing its window */
+			tcp->retries = 0;
+		}
+		tcp->snd_wnd = wnd;
+		return;
+	}
+
+	acked = ack - tcp->snd_una;
+	if (acked > tcp->send_len) {
+		/* The FIN comes right after the data */
+		fin_acked = ack == data_end + 1;
+		acked = tcp->send_len;
+	}
+
+	tcp->send_head = (tcp->send_head + acked) % TCP_SEND_SIZE;
+	tcp->send_len -= acked;
+	tcp->snd_una = ack;
+	if (SEQ_LT(tcp->snd_nxt, tcp->snd_una)) {
+		tcp->snd_nxt = tcp->snd_una;
+	}
+	tcp->snd_wnd = wnd;
+	tcp->retries = 0;
+
+	if (tcp->dupacks >= 3) {
+		tcp->cwnd = tcp->ssthresh;
+	} else if (tcp->cwnd < tcp->ssthresh) {
+		tcp->cwnd += tcp->mss;
+	} else {
+		tcp->cwnd += max(tcp->mss * tcp->mss / tcp->cwnd, 1);
+	}
+	tcp->dupacks = 0;
+
+	if (tcp->rtt_timing && SEQ_GT(ack, tcp->rtt_seq)) {
+		tcp->rtt_timing = false;
+		tcp_rtt_update(tcp, clock_time() - tcp->rtt_start);
+	}
+
+	if (tcp->snd_una == tcp->snd_max) {
+		ctimer_stop(&tcp->timer);
+	} else {
+		tcp_timer_start(tcp, tcp->rto);
+	}
+
+	if (!fin_acked) {
+		return;
+	}
+
+	switch (tcp->state) {
+	case TCP_STATE_FIN_WAIT_1:
+		tcp->state = TCP_STATE_FIN_WAIT_2;
+		break;
+	case TCP_STATE_CLOSING:
+		tcp->state = TCP_STATE_TIME_WAIT;
+		tcp_timer_start(tcp, TCP_TIME_WAIT_TIMEOUT);
+		break;
+	case TCP_STATE_LAST_ACK:
+		tcp_release(tcp);
+		break;
+	default:
+		break;
+	}
+}
+
+/* Queue the data of an in order segment to the application */
+static int tcp_data_input(struct net_tcp *tcp, struct net_buf *buf,
+			  uint8_t *data, uint16_t len)
+{
+	if (atomic_test_bit(&tcp->flags, TCP_FLAG_CLOSE)) {
+		/* Nobody reads anymore, the data is discarded */
+		tcp->rcv_nxt += len;
+		return 0;
+	}
+
+	ip_buf_context(buf) = tcp->context;
+	ip_buf_appdata(buf) = data;
+	ip_buf_appdatalen(buf) = len;
+
+	atomic_add(&tcp->rcv_queued, len);
+	tcp->rcv_nxt += len;
+
+	NET_DBG("tcp %p received %d bytes\n", tcp, len);
+
+	nano_fifo_put(net_context_get_queue(tcp->context), buf);
+
+	return 1;
+}
+
+static int tcp_input(struct net_tcp *tcp, struct net_buf *buf,
+		     uint8_t hdr_len, uint16_t len)
+{
+	struct uip_tcp_hdr *hdr = NET_BUF_TCP(buf);
+	uint8_t *data = (uint8_t *)hdr + hdr_len;
+	uint32_t seq = get_seq(hdr->seqno);
+	uint32_t ack = get_seq(hdr->ackno);
+	uint16_t wnd = tcp_get_wnd(hdr);
+	uint8_t flags = hdr->flags;
+	bool fin = flags & TCP_FIN;
+	uint32_t trim;
+	int kept = 0;
+
+	if (tcp->state == TCP_STATE_SYN_SENT) {
+		if ((flags & TCP_ACK) && ack != tcp->iss + 1) {
+			tcp_send_reset(buf, len);
+			return 0;
+		}
+
+		if (flags & TCP_RST) {
+			if (flags & TCP_ACK) {
+				UIP_STAT(++uip_stat.tcp.rst);
+				tcp_abort(tcp);
+				return 0;
+			}
+			return 0;
+		}
+
+		/* Simultaneous open is not supported */
+		if (!(flags & TCP_SYN) || !(flags & TCP_ACK)) {
+			return 0;
+		}
+
+		tcp->rcv_nxt = seq + 1;
+		tcp_parse_options(tcp, buf, hdr_len);
+		tcp->snd_una = ack;
+		tcp->snd_wnd = wnd;
+		tcp->retries = 0;
+		if (tcp->rto == TCP_RTO_INITIAL) {
+			tcp_rtt_update(tcp, clock_time() -
+				       tcp->timer.etimer.timer.start);
+		}
+		ctimer_stop(&tcp->timer);
+
+		tcp->state = TCP_STATE_ESTABLISHED;
+		NET_DBG("tcp %p connected\n", tcp);
+
+		atomic_set_bit(&tcp->flags, TCP_FLAG_ACK_NOW);
+		tcp_output(tcp);
+		return 0;
+	}
+
+	if (flags & TCP_RST) {
+		if (SEQ_GEQ(seq, tcp->rcv_nxt) &&
+		    SEQ_LEQ(seq, tcp->rcv_nxt + tcp_rcv_wnd(tcp))) {
+			UIP_STAT(++uip_stat.tcp.rst);
+			tcp_abort(tcp);
+			return 0;
+		}
+		return 0;
+	}
+
+	if (flags & TCP_SYN) {
+		/* Our SYN-ACK or ACK was lost, the peer sends its SYN again */
+		if (tcp->state == TCP_STATE_SYN_RECEIVED) {
+			tcp_send_syn(tcp);
+		} else {
+			atomic_set_bit(&tcp->flags, TCP_FLAG_ACK_NOW);
+			tcp_output(tcp);
+		}
+		return 0;
+	}
+
+	if (!(flags & TCP_ACK)) {
+		return 0;
+	}
+
+	if (tcp->state == TCP_STATE_SYN_RECEIVED) {
+		if (ack != tcp->iss + 1) {
+			tcp_send_reset(buf, len);
+			return 0;
+		}
+
+		tcp->snd_una = ack;
+		tcp->retries = 0;
+		ctimer_stop(&tcp->timer);
+		tcp->state = TCP_STATE_ESTABLISHED;
+
+		if (!tcp->listener ||
+		    tcp->listener->state != TCP_STATE_LISTEN) {
+			tcp_send(tcp, tcp->snd_nxt, 0, TCP_RST | TCP_ACK);
+			tcp_release(tcp);
+			return 0;
+		}
+
+		NET_DBG("tcp %p accepted on listener %p\n", tcp,
+			tcp->listener);
+
+		nano_fifo_put(&tcp->listener->accept_q, tcp);
+		tcp->listener = NULL;
+	}
+
+	tcp_ack_input(tcp, ack, wnd, len);
+	if (!tcp->context) {
+		/* Released by the ACK of the last FIN */
+		return 0;
+	}
+
+	switch (tcp->state) {
+	case TCP_STATE_ESTABLISHED:
+	case TCP_STATE_FIN_WAIT_1:
+	case TCP_STATE_FIN_WAIT_2:
+		break;
+	default:
+		/* The peer already sent its FIN */
+		if (len || fin) {
+			atomic_set_bit(&tcp->flags, TCP_FLAG_ACK_NOW);
+		}
+		tcp_output(tcp);
+		return 0;
+	}
+
+	if ((len || fin) && seq != tcp->rcv_nxt) {
+		trim = tcp->rcv_nxt - seq;
+		if (SEQ_LT(seq, tcp->rcv_nxt) && trim < len) {
+			/* Partly retransmitted segment */
+			data += trim;
+			len -= trim;
+		} else {
+			/* Duplicate or out of order segment */
+			len = 0;
+			fin = false;
+		}
+		atomic_set_bit(&tcp->flags, TCP_FLAG_ACK_NOW);
+	}
+
+	if (len) {
+		if (len > tcp_rcv_wnd(tcp)) {
+			len = tcp_rcv_wnd(tcp);
+			fin = false;
+		}
+
+		if (len) {
+			kept = tcp_data_input(tcp, buf, data, len);
+		}
+
+		atomic_set_bit(&tcp->flags, TCP_FLAG_ACK_NOW);
+	}
+
+	if (fin) {
+		tcp->rcv_nxt++;
+		atomic_set_bit(&tcp->flags, TCP_FLAG_ACK_NOW);
+
+		switch (tcp->state) {
+		case TCP_STATE_ESTABLISHED:
+			tcp->state = TCP_STATE_CLOSE_WAIT;
+			break;
+		case TCP_STATE_FIN_WAIT_1:
+			tcp->state = TCP_STATE_CLOSING;
+			break;
+		case TCP_STATE_FIN_WAIT_2:
+			tcp->state = TCP_STATE_TIME_WAIT;
+			tcp_timer_start(tcp, TCP_TIME_WAIT_TIMEOUT);
+			break;
+		default:
+			break;
+		}
+
+		if (kept) {
+			/* The data wakes up the receiver */
+			atomic_set_bit(&tcp->flags, TCP_FLAG_EOF);
+		} else {
+			tcp_eof(tcp);
+		}
+	}
+
+	tcp_output(tcp);
+
+	return kept;
+}
+
+int net_tcp_input(struct net_buf *buf)
+{
+	struct uip_tcp_hdr *hdr = NET_BUF_TCP(buf);
+	uint8_t hdr_len = (hdr->tcpoffset >> 4) * 4;
+	struct net_tcp *tcp;
+	uint16_t len;
+
+	if (hdr_len < UIP_TCPH_LEN || UIP_IPH_LEN + hdr_len > uip_len(buf) ||
+	    !hdr->srcport || !hdr->destport) {
+		UIP_STAT(++uip_stat.tcp.drop);
+		return 0;
+	}
+
+	len = uip_len(buf) - UIP_IPH_LEN - hdr_len;
+
+	tcp = tcp_lookup(buf);
+	if (!tcp) {
+		if (hdr->flags & TCP_SYN) {
+			UIP_STAT(++uip_stat.tcp.synrst);
+		}
+		tcp_send_reset(buf, len);
+		return 0;
+	}
+
+	if (tcp->state == TCP_STATE_LISTEN) {
+		tcp_listen_input(tcp, buf, hdr_len);
+		return 0;
+	}
+
+	return tcp_input(tcp, buf, hdr_len, len);
+}
+
+/* Application side, the connection is run by the TX fiber when it gets
+ * a buffer of the context that carries no data.
+ */
+static int tcp_kick(struct net_tcp *tcp, bool wait)
+{
+	struct net_buf *buf;
+	int ret;
+
+	if (wait) {
+		buf = ip_buf_get_tx(tcp->context);
+	} else {
+		buf = ip_buf_get_reserve_tx_nowait(UIP_IPTCPH_LEN);
+	}
+	if (!buf) {
+		return -ENOBUFS;
+	}
+
+	ip_buf_context(buf) = tcp->context;
+	ip_buf_appdatalen(buf) = 0;
+
+	ret = net_send(buf);
+	if (ret < 0) {
+		ip_buf_unref(buf);
+	}
+
+	return ret;
+}
+
+void net_tcp_init(void)
+{
+	net_buf_pool_init(eof_pool);
+}
+
+struct net_tcp *net_tcp_get(struct net_context *context)
+{
+	struct net_tuple *tuple = net_context_get_tuple(context);
+	struct net_tcp *tcp;
+
+	tcp = tcp_alloc(context);
+	if (!tcp) {
+		return NULL;
+	}
+
+	if (!tuple->remote_port) {
+		tcp->state = TCP_STATE_LISTEN;
+		return tcp;
+	}
+
+	atomic_set_bit(&tcp->flags, TCP_FLAG_CONNECT);
+	if (tcp_kick(tcp, true) < 0) {
+		tcp_free(tcp);
+		return NULL;
+	}
+
+	return tcp;
+}
+
+void net_tcp_put(struct net_tcp *tcp)
+{
+	struct nano_fifo *queue = net_context_get_queue(tcp->context);
+	struct net_buf *buf;
+
+	atomic_set_bit(&tcp->flags, TCP_FLAG_CLOSE);
+
+	/* Data not read is discarded, and its buffers made available for
+	 * closing the connection.
+	 */
+	while ((buf = nano_fifo_get(queue, TICKS_NONE))) {
+		ip_buf_unref(buf);
+	}
+
+	tcp_kick(tcp, true);
+}
+
+struct net_context *net_tcp_accept(struct net_tcp *tcp, int32_t timeout)
+{
+	struct net_tcp *conn;
+
+	if (tcp->state != TCP_STATE_LISTEN) {
+		return NULL;
+	}
+
+#ifndef CONFIG_NANO_TIMEOUTS
+	if (timeout != TICKS_UNLIMITED) {
+		timeout = TICKS_NONE;
+	}
+#endif
+
+	conn = nano_fifo_get(&tcp->accept_q, timeout);
+
+	return conn ? conn->context : NULL;
+}
+
+int net_tcp_send_wait(struct net_tcp *tcp)
+{
+	nano_sem_take(&tcp->send_sem, TICKS_UNLIMITED);
+
+	if (tcp->state == TCP_STATE_LISTEN ||
+	    (tcp->state == TCP_STATE_CLOSED &&
+	     !atomic_test_bit(&tcp->flags, TCP_FLAG_CONNECT))) {
+		nano_sem_give(&tcp->send_sem);
+		return -ENOTCONN;
+	}
+
+	return 0;
+}
+
+/* Release the listening connection and the ones not accepted yet */
+static void tcp_close_listener(struct net_tcp *listener)
+{
+	struct net_tcp *tcp;
+	int i;
+
+	listener->state = TCP_STATE_CLOSED;
+
+	while ((tcp = nano_fifo_get(&listener->accept_q, TICKS_NONE))) {
+		if (tcp->state != TCP_STATE_CLOSED) {
+			tcp_send(tcp, tcp->snd_nxt, 0, TCP_RST | TCP_ACK);
+		}
+		tcp_release(tcp);
+	}
+
+	for (i = 0; i < CONFIG_TCP_CONNS; i++) {
+		tcp = &tcp_conns[i];
+		if (tcp->context && tcp->listener == listener) {
+			tcp_send(tcp, tcp->snd_nxt, 0, TCP_RST | TCP_ACK);
+			tcp_release(tcp);
+		}
+	}
+
+	tcp_release(listener);
+}
+
+static void tcp_close(struct net_tcp *tcp)
+{
+	switch (tcp->state) {
+	case TCP_STATE_LISTEN:
+		tcp_close_listener(tcp);
+		return;
+	case TCP_STATE_CLOSED:
+		tcp_release(tcp);
+		return;
+	case TCP_STATE_SYN_SENT:
+		tcp_release(tcp);
+		return;
+	case TCP_STATE_ESTABLISHED:
+		tcp->state = TCP_STATE_FIN_WAIT_1;
+		break;
+	case TCP_STATE_CLOSE_WAIT:
+		tcp->state = TCP_STATE_LAST_ACK;
+		break;
+	default:
+		/* Already closing */
+		break;
+	}
+
+	tcp_output(tcp);
+}
+
+/* The connection is looked up as the context may not know it yet when
+ * it is opened.
+ */
+static struct net_tcp *tcp_find(struct net_context *context)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_TCP_CONNS; i++) {
+		if (context && tcp_conns[i].context == context) {
+			return &tcp_conns[i];
+		}
+	}
+
+	return NULL;
+}
+
+int net_tcp_send(struct net_buf *buf)
+{
+	struct net_tcp *tcp = tcp_find(ip_buf_context(buf));
+
+	if (!tcp) {
+		return -EINVAL;
+	}
+
+	if (!ip_buf_appdatalen(buf)) {
+		ip_buf_unref(buf);
+	} else if (atomic_test_bit(&tcp->flags, TCP_FLAG_CLOSE) ||
+		   (tcp->state != TCP_STATE_SYN_SENT &&
+		    tcp->state != TCP_STATE_ESTABLISHED &&
+		    tcp->state != TCP_STATE_CLOSE_WAIT &&
+		    !atomic_test_bit(&tcp->flags, TCP_FLAG_CONNECT))) {
+		NET_DBG("tcp %p not connected, data discarded\n", tcp);
+		ip_buf_unref(buf);
+		nano_sem_give(&tcp->send_sem);
+	} else {
+		tcp->send_pending = buf;
+	}
+
+	if (atomic_test_and_clear_bit(&tcp->flags, TCP_FLAG_CONNECT)) {
+		tcp_open(tcp);
+	}
+
+	if (atomic_test_bit(&tcp->flags, TCP_FLAG_CLOSE)) {
+		tcp_close(tcp);
+	} else {
+		tcp_output(tcp);
+	}
+
+	return 1;
+}
+
+bool net_tcp_eof(struct net_tcp *tcp)
+{
+	return atomic_test_bit(&tcp->flags, TCP_FLAG_EOF);
+}
+
+struct net_buf *net_tcp_received(struct net_tcp *tcp, struct net_buf *buf)
+{
+	if (!ip_buf_appdatalen(buf)) {
+		/* End of stream */
+		ip_buf_unref(buf);
+		return NULL;
+	}
+
+	atomic_sub(&tcp->rcv_queued, ip_buf_appdatalen(buf));
+
+	if (atomic_test_and_clear_bit(&tcp->flags, TCP_FLAG_WND_UPDATE) &&
+	    tcp_kick(tcp, false) < 0) {
+		atomic_set_bit(&tcp->flags, TCP_FLAG_WND_UPDATE);
+	}
+
+	return buf;
+}
@@ -0,0 +1,76 @@
+/** @file
+ * @brief TCP connections of the network contexts
+ *
+ * Internal interface between the TCP code and the rest of the IP stack.
+ */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NET_TCP_H
+#define __NET_TCP_H
+
+#include <stdbool.h>
+
+#include <net/buf.h>
+#include <net/net_socket.h>
+
+struct net_tcp;
+
+#ifdef CONFIG_NETWORKING_WITH_TCP
+
+/* Initialize the TCP connections */
+void net_tcp_init(void);
+
+/* Allocate the connection of a new TCP context. A context with a remote
+ * port connects to it, a context without one listens on its local port.
+ */
+struct net_tcp *net_tcp_get(struct net_context *context);
+
+/* Close the connection of a context released by the application, the
+ * context itself is released once the connection is closed.
+ */
+void net_tcp_put(struct net_tcp *tcp);
+
+/* Wait for a connection of a listening context */
+struct net_context *net_tcp_accept(struct net_tcp *tcp, int32_t timeout);
+
+/* Called by net_send() before queueing application data, waits until
+ * the connection can take it.
+ */
+int net_tcp_send_wait(struct net_tcp *tcp);
+
+/* Called in the TX fiber for each buffer sent on a TCP context, the
+ * buffer is always consumed.
+ */
+int net_tcp_send(struct net_buf *buf);
+
+/* True once all the data sent by the peer has been received */
+bool net_tcp_eof(struct net_tcp *tcp);
+
+/* Called by net_receive() for each buffer taken by the application,
+ * returns NULL for the end of stream marker.
+ */
+struct net_buf *net_tcp_received(struct net_tcp *tcp, struct net_buf *buf);
+
+/* Called by uIP in the RX fiber for each valid TCP segment, returns 1
+ * if the buffer was queued to the application.
+ */
+int net_tcp_input(struct net_buf *buf);
+
+#endif /* CONFIG_NETWORKING_WITH_TCP */
+
+#endif /* __NET_TCP_H */
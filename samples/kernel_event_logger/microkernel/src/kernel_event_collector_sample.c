@@ -450,11 +450,14 @@ void profiling_data_collector(void)
  */
 void kernel_event_logger_fiber_start(void)
 {
+	/* The kernel event export fiber is the collector when it is enabled */
+#ifndef CONFIG_KERNEL_EVENT_LOGGER_EXPORT
 	PRINTF("\x1b[2J\x1b[15;1H");
 	task_fiber_start(&kernel_event_logger_stack[0][0], STSIZE,
 		(nano_fiber_entry_t) profiling_data_collector, 0, 0, 6, 0);
 	task_fiber_start(&kernel_event_logger_stack[1][0], STSIZE,
 		(nano_fiber_entry_t) summary_data_printer, 0, 0, 6, 0);
+#endif
 }
 
 #ifdef CONFIG_NANOKERNEL
@@ -0,0 +1,195 @@
+/* main.c - TCP loopback throughput demo */
+
+/*
+ * Copyright (c) 2016 Intel Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* A client sends a stream of data to a server over a TCP connection on
+ * the loopback interface. The server checks the data and prints the
+ * throughput once the client closed the connection.
+ */
+
+#include <zephyr.h>
+
+#if defined(CONFIG_STDOUT_CONSOLE)
+#include <stdio.h>
+#define PRINT           printf
+#else
+#include <misc/printk.h>
+#define PRINT           printk
+#endif
+
+#include <net/ip_buf.h>
+#include <net/net_core.h>
+#include <net/net_socket.h>
+
+#include <net_driver_loopback.h>
+
+#define PORT       4242
+#define TOTAL_LEN  (256 * 1024)
+
+#define STACKSIZE 2000
+
+static char fiberServerStack[STACKSIZE];
+static char fiberClientStack[STACKSIZE];
+
+const struct in6_addr in6addr_any = IN6ADDR_ANY_INIT;            /* ::  */
+const struct in6_addr in6addr_loopback = IN6ADDR_LOOPBACK_INIT;  /* ::1 */
+
+static struct net_addr any_addr;
+static struct net_addr server_addr;
+static struct net_addr client_addr;
+
+static inline uint8_t pattern(uint32_t offset)
+{
+	return offset % 251;
+}
+
+/* sanitycheck looks for these lines to tell the result of the run */
+static void report(bool passed)
+{
+	if (passed) {
+		PRINT("PROJECT EXECUTION SUCCESSFUL\n");
+	} else {
+		PRINT("PROJECT EXECUTION FAILED\n");
+	}
+}
+
+void fiber_server(void)
+{
+	struct net_context *listener, *ctx;
+	struct net_buf *buf;
+	uint32_t received = 0;
+	uint32_t start, ticks;
+	uint8_t *data;
+	bool failure = false;
+	int i;
+
+	listener = net_context_get(IPPROTO_TCP, &any_addr, 0,
+				   &server_addr, PORT);
+	if (!listener) {
+		PRINT("%s: Cannot get network context\n", __func__);
+		report(false);
+		return;
+	}
+
+	ctx = net_context_accept(listener, TICKS_UNLIMITED);
+	if (!ctx) {
+		PRINT("%s: Cannot accept connection\n", __func__);
+		net_context_put(listener);
+		report(false);
+		return;
+	}
+
+	start = sys_tick_get_32();
+
+	while ((buf = net_receive(ctx, TICKS_UNLIMITED))) {
+		data = ip_buf_appdata(buf);
+
+		for (i = 0; i < ip_buf_appdatalen(buf) && !failure; i++) {
+			if (data[i] != pattern(received + i)) {
+				PRINT("Data mismatch at offset %u\n",
+				      received + i);
+				failure = true;
+			}
+		}
+
+		received += ip_buf_appdatalen(buf);
+		ip_buf_unref(buf);
+	}
+
+	ticks = sys_tick_get_32() - start;
+
+	net_context_put(ctx);
+	net_context_put(listener);
+
+	PRINT("Received %u bytes in %u ticks", received, ticks);
+	if (ticks) {
+		PRINT(", %u bytes/s",
+		      (uint32_t)((uint64_t)received *
+				 sys_clock_ticks_per_sec / ticks));
+	}
+	PRINT("\n");
+
+	report(!failure && received == TOTAL_LEN);
+}
+
+void fiber_client(void)
+{
+	struct net_context *ctx;
+	struct net_buf *buf;
+	uint32_t sent = 0;
+	uint16_t len;
+	uint8_t *ptr;
+	int i;
+
+	ctx = net_context_get(IPPROTO_TCP, &server_addr, PORT,
+			      &client_addr, 0);
+	if (!ctx) {
+		PRINT("%s: Cannot get network context\n", __func__);
+		return;
+	}
+
+	while (sent < TOTAL_LEN) {
+		buf = ip_buf_get_tx(ctx);
+		if (!buf) {
+			break;
+		}
+
+		len = min(net_buf_tailroom(buf), TOTAL_LEN - sent);
+		ptr = net_buf_add(buf, len);
+		for (i = 0; i < len; i++) {
+			ptr[i] = pattern(sent + i);
+		}
+
+		/* Blocks until the connection takes the data */
+		if (net_send(buf) < 0) {
+			PRINT("%s: sending %d bytes failed\n", __func__, len);
+			ip_buf_unref(buf);
+			break;
+		}
+
+		sent += len;
+	}
+
+	PRINT("Sent %u bytes\n", sent);
+
+	net_context_put(ctx);
+}
+
+void main(void)
+{
+	PRINT("%s: run TCP loopback throughput test\n", __func__);
+
+	sys_rand32_init();
+
+	net_init();
+	net_driver_loopback_init();
+
+	any_addr.in6_addr = in6addr_any;
+	any_addr.family = AF_INET6;
+
+	server_addr.in6_addr = in6addr_loopback;
+	server_addr.family = AF_INET6;
+
+	client_addr.in6_addr = in6addr_loopback;
+	client_addr.family = AF_INET6;
+
+	task_fiber_start(&fiberServerStack[0], STACKSIZE,
+			 (nano_fiber_entry_t)fiber_server, 0, 0, 7, 0);
+
+	task_fiber_start(&fiberClientStack[0], STACKSIZE,
+			 (nano_fiber_entry_t)fiber_client, 0, 0, 7, 0);
+}
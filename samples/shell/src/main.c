@@ -16,6 +16,7 @@
 
 #include <zephyr.h>
 #include <misc/printk.h>
+#include <misc/util.h>
 #include <misc/shell.h>
 #define DEVICE_NAME "test shell"
 
@@ -35,10 +36,42 @@ static void shell_cmd_highticks(int argc, char *argv[])
 }
 
 
+#if defined(CONFIG_THREAD_CPU_ACCOUNTING) && defined(CONFIG_THREAD_MONITOR)
+#define MAX_THREADS 16
+
+static void shell_cmd_cpu(int argc, char *argv[])
+{
+	static struct sys_thread_cpu_usage usage[MAX_THREADS];
+	uint64_t total = 0;
+	int count, i;
+
+	count = sys_thread_cpu_usage_get(usage, ARRAY_SIZE(usage));
+	if (count > ARRAY_SIZE(usage)) {
+		count = ARRAY_SIZE(usage);
+	}
+
+	for (i = 0; i < count; i++) {
+		total += usage[i].cycles;
+	}
+
+	if (total == 0) {
+		return;
+	}
+
+	for (i = 0; i < count; i++) {
+		printk("thread %p: %u%%\n", usage[i].thread,
+		       (uint32_t)(usage[i].cycles * 100 / total));
+	}
+}
+#endif
+
 const struct shell_cmd commands[] = {
 	{ "ping", shell_cmd_ping },
 	{ "ticks", shell_cmd_ticks },
 	{ "highticks", shell_cmd_highticks },
+#if defined(CONFIG_THREAD_CPU_ACCOUNTING) && defined(CONFIG_THREAD_MONITOR)
+	{ "cpu", shell_cmd_cpu },
+#endif
 	{ NULL, NULL }
 };
 
@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2016 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Convert a kernel event export stream to a timeline
+
+Reads the binary stream produced by CONFIG_KERNEL_EVENT_LOGGER_EXPORT, either
+captured from the pipe UART or dumped from the sys_k_event_export_ram buffer,
+and prints the events along with the CPU occupancy of each thread and the
+interrupt statistics. The timeline can also be written in the Chrome trace
+event format, to be viewed with chrome://tracing or similar tools.
+
+See include/misc/kernel_event_logger.h for the stream format.
+"""
+
+import argparse
+import collections
+import json
+import struct
+import sys
+
+HEADER_EVENT_ID = 0x0000
+CONTEXT_SWITCH_EVENT_ID = 0x0001
+INTERRUPT_EVENT_ID = 0x0002
+SLEEP_EVENT_ID = 0x0003
+TASK_MON_TASK_STATE_CHANGE_EVENT_ID = 0x0004
+TASK_MON_CMD_PACKET_EVENT_ID = 0x0005
+TASK_MON_KEVENT_EVENT_ID = 0x0006
+
+EXPORT_MAGIC = 0x56454b5a
+EXPORT_VERSION = 1
+
+EVENT_NAMES = {
+    CONTEXT_SWITCH_EVENT_ID: "context switch",
+    INTERRUPT_EVENT_ID: "interrupt",
+    SLEEP_EVENT_ID: "sleep",
+    TASK_MON_TASK_STATE_CHANGE_EVENT_ID: "task state change",
+    TASK_MON_CMD_PACKET_EVENT_ID: "command packet",
+    TASK_MON_KEVENT_EVENT_ID: "kernel event",
+}
+
+Event = collections.namedtuple("Event", "event_id dropped data")
+
+
+class StreamError(Exception):
+    pass
+
+
+def parse_stream(stream):
+    """Return the stream header values and the list of events"""
+
+    if len(stream) < 20:
+        raise StreamError("stream too short")
+
+    for order in ("<", ">"):
+        event_id, _, size32, magic = struct.unpack_from(order + "HBBI", stream)
+        if magic == EXPORT_MAGIC:
+            break
+    else:
+        raise StreamError("no stream header")
+
+    if event_id != HEADER_EVENT_ID or size32 < 4:
+        raise StreamError("bad stream header")
+
+    header = struct.unpack_from(order + "%dI" % size32, stream, 4)
+    if header[1] != EXPORT_VERSION:
+        raise StreamError("unsupported stream version %d" % header[1])
+
+    events = []
+    offset = 4 + 4 * size32
+    while offset + 4 <= len(stream):
+        event_id, dropped, size32 = struct.unpack_from(order + "HBB", stream,
+                                                       offset)
+        offset += 4
+        if offset + 4 * size32 > len(stream):
+            sys.stderr.write("warning: truncated record at offset %d\n" %
+                             (offset - 4))
+            break
+        data = struct.unpack_from(order + "%dI" % size32, stream, offset)
+        offset += 4 * size32
+        events.append(Event(event_id, dropped, data))
+
+    ticks_per_sec, cycles_per_tick = header[2], header[3]
+    return ticks_per_sec, cycles_per_tick, events
+
+
+def describe(event):
+    name = EVENT_NAMES.get(event.event_id, "event 0x%04x" % event.event_id)
+
+    if event.event_id == CONTEXT_SWITCH_EVENT_ID:
+        details = "thread 0x%08x leaves the CPU" % event.data[1]
+    elif event.event_id == INTERRUPT_EVENT_ID:
+        details = "irq %d" % event.data[1]
+    elif event.event_id == SLEEP_EVENT_ID:
+        details = "slept %d ticks, woken up by irq %d" % (event.data[1],
+                                                          event.data[2])
+    else:
+        details = " ".join("0x%08x" % d for d in event.data[1:])
+
+    return name, details
+
+
+class Timeline:
+    """Thread occupancy, sleep and interrupt statistics of a stream"""
+
+    def __init__(self, events):
+        self.events = [e for e in events if e.data]
+        self.occupancy = collections.Counter()
+        self.slices = []
+        self.sleeps = []
+        self.irq_times = collections.defaultdict(list)
+        self.dropped = sum(e.dropped for e in events)
+
+        last_switch = None
+        for e in self.events:
+            tick = e.data[0]
+            if e.event_id == CONTEXT_SWITCH_EVENT_ID:
+                # the thread logged is the one leaving the CPU: it ran
+                # since the previous context switch
+                if last_switch is not None:
+                    self.occupancy[e.data[1]] += tick - last_switch
+                    self.slices.append((e.data[1], last_switch, tick))
+                last_switch = tick
+            elif e.event_id == INTERRUPT_EVENT_ID:
+                self.irq_times[e.data[1]].append(tick)
+            elif e.event_id == SLEEP_EVENT_ID:
+                self.sleeps.append((tick - e.data[1], tick, e.data[2]))
+
+    def print_summary(self):
+        total = sum(self.occupancy.values())
+
+        print("\nCPU occupancy per thread (%d ticks):" % total)
+        for thread, ticks in self.occupancy.most_common():
+            print("  0x%08x %10d ticks %6.2f%%" %
+                  (thread, ticks, 100.0 * ticks / total if total else 0))
+
+        slept = sum(end - start for start, end, _ in self.sleeps)
+        print("\nSleep: %d periods, %d ticks" % (len(self.sleeps), slept))
+
+        print("\nInterrupts:")
+        for irq in sorted(self.irq_times):
+            times = self.irq_times[irq]
+            gaps = [b - a for a, b in zip(times, times[1:])]
+            line = "  irq %3d: %8d" % (irq, len(times))
+            if gaps:
+                line += ", interval min %d avg %.1f max %d ticks" % (
+                    min(gaps), float(sum(gaps)) / len(gaps), max(gaps))
+            print(line)
+
+        if self.dropped:
+            print("\n%d events dropped" % self.dropped)
+
+    def chrome_trace(self, ticks_per_sec):
+        def us(ticks):
+            return ticks * 1000000.0 / ticks_per_sec
+
+        trace = []
+        for thread, start, end in self.slices:
+            trace.append({"name": "0x%08x" % thread, "ph": "X", "pid": 0,
+                          "tid": "0x%08x" % thread, "ts": us(start),
+                          "dur": us(end - start)})
+        for start, end, irq in self.sleeps:
+            trace.append({"name": "sleep", "ph": "X", "pid": 0,
+                          "tid": "sleep", "ts": us(start),
+                          "dur": us(end - start), "args": {"wakeup irq": irq}})
+        for irq, times in self.irq_times.items():
+            for tick in times:
+                trace.append({"name": "irq %d" % irq, "ph": "i", "s": "g",
+                              "pid": 0, "tid": "interrupts", "ts": us(tick)})
+
+        return {"traceEvents": trace, "displayTimeUnit": "ms"}
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("stream", help="kernel event export stream file")
+    parser.add_argument("-q", "--quiet", action="store_true",
+                        help="only print the summary, not every event")
+    parser.add_argument("-c", "--chrome", metavar="FILE",
+                        help="write the timeline in Chrome trace format")
+    args = parser.parse_args()
+
+    with open(args.stream, "rb") as f:
+        stream = f.read()
+
+    try:
+        ticks_per_sec, cycles_per_tick, events = parse_stream(stream)
+    except StreamError as e:
+        sys.exit("%s: %s" % (args.stream, e))
+
+    print("%d events, %d ticks per second, %d cycles per tick" %
+          (len(events), ticks_per_sec, cycles_per_tick))
+
+    if not args.quiet:
+        for e in events:
+            name, details = describe(e)
+            tick = e.data[0] if e.data else 0
+            print("%12.3f ms  %-18s %s" %
+                  (tick * 1000.0 / ticks_per_sec, name, details))
+
+    timeline = Timeline(events)
+    timeline.print_summary()
+
+    if args.chrome:
+        with open(args.chrome, "w") as f:
+            json.dump(timeline.chrome_trace(ticks_per_sec), f)
+
+
+if __name__ == "__main__":
+    main()
@@ -71,6 +71,46 @@ void queue_test(void)
 	PRINT_F(output_file, FORMAT, "dequeue 4 bytes msg in FIFO",
 			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
 
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		task_fifo_put(DEMOQX8, data_bench, TICKS_UNLIMITED);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT, "enqueue 8 bytes msg in FIFO",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		task_fifo_get(DEMOQX8, data_bench, TICKS_UNLIMITED);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT, "dequeue 8 bytes msg in FIFO",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		task_fifo_put(DEMOQX16, data_bench, TICKS_UNLIMITED);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT, "enqueue 16 bytes msg in FIFO",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		task_fifo_get(DEMOQX16, data_bench, TICKS_UNLIMITED);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT, "dequeue 16 bytes msg in FIFO",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
 	task_sem_give(STARTRCV);
 
 	et = BENCH_START();
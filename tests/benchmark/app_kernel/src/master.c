@@ -28,7 +28,7 @@
 #include "master.h"
 
 char Msg[MAX_MSG];
-char data_bench[OCTET_TO_SIZEOFUNIT(MESSAGE_SIZE)];
+char __aligned(4) data_bench[OCTET_TO_SIZEOFUNIT(MESSAGE_SIZE)];
 
 #ifdef PIPE_BENCH
 kpipe_t TestPipes[] = {PIPE_NOBUFF, PIPE_SMALLBUFF, PIPE_BIGBUFF};
@@ -51,6 +51,7 @@
 #define NR_OF_SEMA_RUNS 500
 #define NR_OF_MUTEX_RUNS 1000
 #define NR_OF_POOL_RUNS 1000
+#define NR_OF_POOL_FRAG_RUNS 100
 #define NR_OF_MAP_RUNS 1000
 #define NR_OF_EVENT_RUNS  1000
 #define NR_OF_MBOX_RUNS 128
@@ -20,6 +20,26 @@
 
 #ifdef MEMPOOL_BENCH
 
+/* number of smallest blocks in FRAGPOOL */
+#define FRAG_BLOCKS (1024 / 16)
+
+static struct k_block frag_blocks[FRAG_BLOCKS];
+
+/**
+ *
+ * @brief Split FRAGPOOL into smallest blocks, keeping one of them free
+ *
+ * @return N/A
+ */
+static void fragment_pool(void)
+{
+	int i;
+
+	for (i = 0; i < FRAG_BLOCKS - 1; i++) {
+		task_mem_pool_alloc(&frag_blocks[i], FRAGPOOL, 16, TICKS_NONE);
+	}
+}
+
 /**
  *
  * @brief Memory pool get/free test
@@ -44,6 +64,46 @@ void mempool_test(void)
 	PRINT_F(output_file, FORMAT,
 			"average alloc and dealloc memory pool block",
 			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, (2 * NR_OF_POOL_RUNS)));
+
+	fragment_pool();
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_POOL_RUNS; i++) {
+		task_mem_pool_alloc(&block, FRAGPOOL, 16, TICKS_UNLIMITED);
+		task_mem_pool_free(&block);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT,
+			"average alloc and dealloc fragmented memory pool block",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, (2 * NR_OF_POOL_RUNS)));
+
+	/*
+	 * Measure how long it takes to get the whole pool back as one block:
+	 * free all the small blocks, then allocate the largest block (which
+	 * may require the pool to be defragmented first).
+	 */
+	et = 0;
+	for (i = 0; i < NR_OF_POOL_FRAG_RUNS; i++) {
+		uint32_t t;
+		int j;
+
+		if (i != 0) {
+			fragment_pool();
+		}
+		t = BENCH_START();
+		for (j = 0; j < FRAG_BLOCKS - 1; j++) {
+			task_mem_pool_free(&frag_blocks[j]);
+		}
+		task_mem_pool_alloc(&block, FRAGPOOL, 1024, TICKS_UNLIMITED);
+		et += TIME_STAMP_DELTA_GET(t);
+		task_mem_pool_free(&block);
+	}
+	check_result();
+
+	PRINT_F(output_file, FORMAT,
+			"free fragmented memory pool and alloc largest block",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_POOL_FRAG_RUNS));
 }
 
 #endif /* MEMPOOL_BENCH */
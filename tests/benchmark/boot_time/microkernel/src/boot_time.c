@@ -23,15 +23,40 @@ Measure boot time for both nanokernel and microkernel project which includes
 - from _start to main()
 - from _start to task
 - from _start to idle (for microkernel)
+- the duration of each device initialization
  */
 
 #include <zephyr.h>
+#include <device.h>
 #include <tc_util.h>
 
 /* externs */
 extern uint64_t __start_tsc; /* timestamp when kernel begins executing */
 extern uint64_t __main_tsc;  /* timestamp when main() begins executing */
 extern uint64_t __idle_tsc;  /* timestamp when CPU went idle */
+extern struct device __device_init_start[];
+extern struct device __device_init_end[];
+
+/* print the duration of the initialization of each device, in init order */
+static void deviceInitTimes(void)
+{
+	struct device *dev;
+	uint32_t total = 0;
+
+	TC_PRINT("Device initialization:\n");
+	for (dev = __device_init_start; dev != __device_init_end; dev++) {
+		if (dev->config->name[0] != '\0') {
+			TC_PRINT("  %s: ", dev->config->name);
+		} else {
+			TC_PRINT("  init function %p: ", dev->config->init);
+		}
+		TC_PRINT("%d cycles, %d us\n", dev->init_cycles,
+			 dev->init_cycles / CONFIG_CPU_CLOCK_FREQ_MHZ);
+		total += dev->init_cycles;
+	}
+	TC_PRINT("  total: %d cycles, %d us\n", total,
+		 total / CONFIG_CPU_CLOCK_FREQ_MHZ);
+}
 
 void bootTimeTask(void)
 {
@@ -89,6 +114,8 @@ void bootTimeTask(void)
 
 #endif
 
+	deviceInitTimes();
+
 	TC_PRINT("Boot Time Measurement finished\n");
 
 	// for sanity regression test utility.
@@ -55,6 +55,9 @@ void nanoTest(void)
 
 	nanoIntLockUnlock();
 	printDashLine();
+
+	nanoIntToFiberReady();
+	printDashLine();
 }
 
 #ifdef CONFIG_NANOKERNEL
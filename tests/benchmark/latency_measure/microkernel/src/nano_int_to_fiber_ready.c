@@ -0,0 +1,151 @@
+/* nano_int_to_fiber_ready.c - measure fiber wakeup vs. runnable fibers */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This file contains a test which measures the time taken by an interrupt
+ * handler to make a waiting fiber runnable, as a function of the number of
+ * fibers that are already runnable.
+ * A low priority fiber (fiberWaiter) blocks on a semaphore. Then a high
+ * priority fiber (fiberDriver) starts a number of medium priority fibers,
+ * which become runnable but can't run yet, and invokes the software
+ * interrupt. The interrupt handler releases the semaphore, which inserts
+ * fiberWaiter behind all the runnable fibers. The time delta is measured
+ * around the semaphore release in the interrupt handler.
+ */
+
+#include "timestamp.h"
+#include "utils.h"
+
+#include <arch/cpu.h>
+#include <irq_offload.h>
+
+#ifndef STACKSIZE
+#define STACKSIZE 512
+#endif
+
+#ifdef CONFIG_SOC_QUARK_D2000
+#define MAX_READY_FIBERS 8
+#else
+#define MAX_READY_FIBERS 40
+#endif
+
+/* stacks used by the fibers */
+static char __stack readyStacks[MAX_READY_FIBERS][STACKSIZE];
+static char __stack waiterStack[STACKSIZE];
+static char __stack driverStack[STACKSIZE];
+
+/* semaphore taken by waiting fiber and released by the interrupt handler */
+static struct nano_sem testSema;
+
+static int numReady;
+
+static uint32_t timestamp;
+
+/**
+ *
+ * @brief Test ISR used to measure the fiber wakeup time
+ *
+ * The interrupt handler takes both timestamps around the semaphore release.
+ *
+ * @return N/A
+ */
+static void latencyTestIsr(void *unused)
+{
+	uint32_t start;
+
+	ARG_UNUSED(unused);
+
+	start = TIME_STAMP_DELTA_GET(0);
+	nano_isr_sem_give(&testSema);
+	timestamp = TIME_STAMP_DELTA_GET(start);
+}
+
+/**
+ *
+ * @brief Runnable fiber
+ *
+ * Fiber does nothing: it only occupies the list of runnable fibers.
+ *
+ * @return N/A
+ */
+static void fiberReady(void)
+{
+}
+
+/**
+ *
+ * @brief Waiting fiber
+ *
+ * Fiber starts and waits on semaphore, to be made runnable by the interrupt
+ * handler.
+ *
+ * @return N/A
+ */
+static void fiberWaiter(void)
+{
+	nano_fiber_sem_take(&testSema, TICKS_UNLIMITED);
+}
+
+/**
+ *
+ * @brief Interrupt preparation fiber
+ *
+ * Fiber starts the runnable fibers, which can't preempt it, then invokes
+ * the software interrupt.
+ *
+ * @return N/A
+ */
+static void fiberDriver(void)
+{
+	int i;
+
+	for (i = 0; i < numReady; i++) {
+		fiber_fiber_start(&readyStacks[i][0], STACKSIZE,
+				  (nano_fiber_entry_t) fiberReady, 0, 0, 10, 0);
+	}
+
+	irq_offload(latencyTestIsr, NULL);
+}
+
+/**
+ *
+ * @brief The test main function
+ *
+ * @return 0 on success
+ */
+int nanoIntToFiberReady(void)
+{
+	PRINT_FORMAT(" 6- Measure time from ISR to make a fiber runnable, as"
+				 " runnable fibers grow");
+	nano_sem_init(&testSema);
+
+	for (numReady = 0; numReady <= MAX_READY_FIBERS;
+	     numReady += MAX_READY_FIBERS / 4) {
+		TICK_SYNCH();
+		task_fiber_start(&waiterStack[0], STACKSIZE,
+						 (nano_fiber_entry_t) fiberWaiter, 0, 0, 12, 0);
+		task_fiber_start(&driverStack[0], STACKSIZE,
+						 (nano_fiber_entry_t) fiberDriver, 0, 0, 2, 0);
+
+		PRINT_FORMAT(" %2d runnable fibers: wakeup time is %lu tcs = %lu nsec",
+					 numReady, timestamp,
+					 SYS_CLOCK_HW_CYCLES_TO_NS(timestamp));
+	}
+	return 0;
+}
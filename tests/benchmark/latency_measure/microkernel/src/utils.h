@@ -93,6 +93,7 @@ int nanoIntToFiber(void);
 int nanoIntToFiberSem(void);
 int nanoCtxSwitch(void);
 int nanoIntLockUnlock(void);
+int nanoIntToFiberReady(void);
 
 /* pointer to the ISR */
 typedef void (*ptestIsr) (void *unused);
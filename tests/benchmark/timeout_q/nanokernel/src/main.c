@@ -0,0 +1,125 @@
+/* main.c - timeout queue scaling benchmark */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * DESCRIPTION
+ * This module measures the cost of starting and stopping a nanokernel timer
+ * while a growing number of other timers are already pending, i.e. how the
+ * timeout queue scales with its length.
+ */
+
+#include <zephyr.h>
+#include <stdio.h>
+#include <tc_util.h>
+#include <misc/util.h>
+
+#include "timestamp.h"
+
+#ifdef CONFIG_TIMEOUT_WHEEL
+#define TIMEOUT_Q_NAME "timing wheel"
+#else
+#define TIMEOUT_Q_NAME "delta list"
+#endif
+
+#define MAX_TIMERS 10000
+#define NUM_PROBES 1000
+
+/* pending timers expire well after the measurements are done */
+#define MIN_TICKS 1000
+#define SPREAD_TICKS 8192
+
+static struct nano_timer timers[MAX_TIMERS];
+static struct nano_timer probe;
+
+static const int num_timers[] = { 10, 100, 1000, MAX_TIMERS };
+
+uint32_t tm_off; /* time necessary to read the time */
+
+/* spread the timeouts over the queue, in a scrambled order */
+static inline int timer_ticks(int i)
+{
+	return MIN_TICKS + ((i * 7919) % SPREAD_TICKS);
+}
+
+/**
+ *
+ * @brief Measure the timeout queue operations with @a n pending timers
+ *
+ * @param n Number of pending timers
+ *
+ * @return N/A
+ */
+static void timeout_q_measure(int n)
+{
+	uint32_t start_stop;
+	uint32_t stop_all;
+	uint32_t timestamp;
+	unsigned int key;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		nano_timer_init(&timers[i], &timers[i]);
+		nano_timer_start(&timers[i], timer_ticks(i));
+	}
+	nano_timer_init(&probe, &probe);
+
+	key = irq_lock();
+
+	timestamp = TIME_STAMP_DELTA_GET(0);
+	for (i = 0; i < NUM_PROBES; i++) {
+		nano_timer_start(&probe, timer_ticks(i * 13));
+		nano_timer_stop(&probe);
+	}
+	start_stop = TIME_STAMP_DELTA_GET(timestamp);
+
+	timestamp = TIME_STAMP_DELTA_GET(0);
+	for (i = 0; i < n; i++) {
+		nano_timer_stop(&timers[i]);
+	}
+	stop_all = TIME_STAMP_DELTA_GET(timestamp);
+
+	irq_unlock(key);
+
+	printf("%6d timers: start+stop %6u tcs (%8u nsec), stop %6u tcs\n",
+	       n, start_stop / NUM_PROBES,
+	       SYS_CLOCK_HW_CYCLES_TO_NS_AVG(start_stop, NUM_PROBES),
+	       stop_all / n);
+}
+
+/**
+ *
+ * @brief Timeout queue benchmark entry point
+ *
+ * @return N/A
+ */
+void main(void)
+{
+	int i;
+
+	bench_test_init();
+
+	printf("Timeout queue benchmark (" TIMEOUT_Q_NAME ")\n");
+	printf("tcs = timer clock cycles: 1 tcs is %u nsec\n",
+	       SYS_CLOCK_HW_CYCLES_TO_NS(1));
+
+	for (i = 0; i < ARRAY_SIZE(num_timers); i++) {
+		timeout_q_measure(num_timers[i]);
+	}
+
+	TC_END_REPORT(TC_PASS);
+}
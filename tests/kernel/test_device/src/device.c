@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file
+ * @brief Test device lookup by name
+ *
+ * This module tests the following scenarios:
+ * 1. each device is found by its name
+ * 2. of two devices with the same name, the first initialized is found
+ * 3. an unknown name is not found
+ * 4. several devices are found with a single device_get_bindings() call
+ * 5. a LAZY level device is initialized once, by its first lookup when
+ *    lazy initialization is enabled, during system initialization otherwise
+ * 6. a LAZY level device is not found while its init function runs
+ */
+
+#include <tc_util.h>
+#include <device.h>
+#include <init.h>
+#include <misc/util.h>
+
+static int lazy_init_count;
+static struct device *lazy_init_lookup;
+
+static int dev_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static int lazy_dev_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	lazy_init_count++;
+
+	/* stands for a lookup made by a thread preempting the init function */
+	lazy_init_lookup = device_get_binding("TEST_DEV_LAZY");
+
+	return 0;
+}
+
+DEVICE_INIT(dev_a, "TEST_DEV_A", dev_init, NULL, NULL,
+	    APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+DEVICE_INIT(dev_b, "TEST_DEV_B", dev_init, NULL, NULL,
+	    APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+DEVICE_INIT(dev_c, "TEST_DEV_C", dev_init, NULL, NULL,
+	    NANOKERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+DEVICE_INIT(dev_dup_first, "TEST_DEV_DUP", dev_init, NULL, NULL,
+	    SECONDARY, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+DEVICE_INIT(dev_dup_second, "TEST_DEV_DUP", dev_init, NULL, NULL,
+	    APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+DEVICE_INIT(dev_lazy, "TEST_DEV_LAZY", lazy_dev_init, NULL, NULL,
+	    LAZY, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+static char *names[] = {
+	"TEST_DEV_A", "TEST_DEV_B", "TEST_DEV_C", "TEST_DEV_DUP",
+	"TEST_DEV_NONE",
+};
+
+static struct device *expected[] = {
+	DEVICE_GET(dev_a), DEVICE_GET(dev_b), DEVICE_GET(dev_c),
+	DEVICE_GET(dev_dup_first), NULL,
+};
+
+static int test_get_binding(void)
+{
+	struct device *dev;
+	int i;
+
+	TC_PRINT("Testing device_get_binding()\n");
+
+	for (i = 0; i < ARRAY_SIZE(names); i++) {
+		dev = device_get_binding(names[i]);
+		if (dev != expected[i]) {
+			TC_ERROR(" *** %s: got %p, expected %p\n",
+				 names[i], dev, expected[i]);
+			return TC_FAIL;
+		}
+	}
+
+	return TC_PASS;
+}
+
+static int test_get_bindings(void)
+{
+	struct device *devices[ARRAY_SIZE(names)];
+	int missing;
+	int i;
+
+	TC_PRINT("Testing device_get_bindings()\n");
+
+	missing = device_get_bindings(names, devices, ARRAY_SIZE(names));
+	if (missing != 1) {
+		TC_ERROR(" *** %d names not found, expected 1\n", missing);
+		return TC_FAIL;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(names); i++) {
+		if (devices[i] != expected[i]) {
+			TC_ERROR(" *** %s: got %p, expected %p\n",
+				 names[i], devices[i], expected[i]);
+			return TC_FAIL;
+		}
+	}
+
+	return TC_PASS;
+}
+
+static int test_lazy_init(void)
+{
+	int i;
+
+	TC_PRINT("Testing LAZY level device initialization\n");
+
+#ifdef CONFIG_DEVICE_INIT_LAZY
+	if (lazy_init_count != 0) {
+		TC_ERROR(" *** LAZY device initialized before its lookup\n");
+		return TC_FAIL;
+	}
+#endif
+
+	for (i = 0; i < 2; i++) {
+		if (device_get_binding("TEST_DEV_LAZY") != DEVICE_GET(dev_lazy)) {
+			TC_ERROR(" *** LAZY device not found\n");
+			return TC_FAIL;
+		}
+	}
+
+	if (lazy_init_count != 1) {
+		TC_ERROR(" *** LAZY device initialized %d times\n",
+			 lazy_init_count);
+		return TC_FAIL;
+	}
+
+#ifdef CONFIG_DEVICE_INIT_LAZY
+	if (lazy_init_lookup != NULL) {
+		TC_ERROR(" *** LAZY device found before the end of its init\n");
+		return TC_FAIL;
+	}
+#endif
+
+	return TC_PASS;
+}
+
+void main(void)
+{
+	int status = TC_FAIL;
+
+	TC_START("Test Device Lookup\n");
+
+	if (test_lazy_init() != TC_PASS ||
+	    test_get_binding() != TC_PASS ||
+	    test_get_bindings() != TC_PASS) {
+		goto done_tests;
+	}
+
+	status = TC_PASS;
+
+done_tests:
+	TC_END_REPORT(status);
+}
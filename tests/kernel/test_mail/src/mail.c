@@ -26,6 +26,9 @@
  *    task_mbox_data_get
  *    task_mbox_data_block_get
  *
+ *    task_mbox_frags_put
+ *    task_mbox_data_frags_get
+ *
  * The module does NOT test the following mailbox APIs:
  *
  *    task_mbox_block_put
@@ -73,6 +76,9 @@ DEFINE_MAILBOX(noRcvrMbox);
 
 extern kmemory_pool_t testPool;
 extern kmemory_pool_t smallBlkszPool;
+extern kmemory_pool_t fragPool;
+
+#define NUM_FRAGS	4     /* # of blocks in fragPool */
 
 /**
  *
@@ -351,6 +357,33 @@ int MsgSenderTask(void)
 	TC_PRINT("%s: task_mbox_put(timeout) for long-duration receive test is OK\n",
 		__func__);
 
+	/* Send two-fragment message used in fragment receive test */
+
+	struct k_mbox_frag *frag1;
+	struct k_mbox_frag *frag2;
+
+	if ((task_mbox_frag_alloc(&frag1, fragPool, MSGSIZE,
+				  TICKS_NONE) != RC_OK) ||
+	    (task_mbox_frag_alloc(&frag2, fragPool, MSGSIZE,
+				  TICKS_NONE) != RC_OK)) {
+		TC_ERROR("task_mbox_frag_alloc failed\n");
+		return TC_FAIL;
+	}
+	memcpy(K_MBOX_FRAG_DATA(frag1), myData1, MSGSIZE);
+	memcpy(K_MBOX_FRAG_DATA(frag2), myData2, MSGSIZE);
+	frag1->next = frag2;
+
+	setMsg_Sender(&MSTmsg, myMbox, msgRcvrTask, NULL, 0, MSG_INFO2);
+	task_mbox_frags_put(myMbox, XFER_PRIO, &MSTmsg, frag1, semSync1);
+
+	if (task_sem_take(semSync1, TICKS_UNLIMITED) != RC_OK) {
+		TC_ERROR("task_mbox_frags_put completion was not signalled\n");
+		return TC_FAIL;
+	}
+
+	TC_PRINT("%s: task_mbox_frags_put for fragment receive test is OK\n",
+		__func__);
+
 	return TC_PASS;
 }
 
@@ -678,5 +711,74 @@ int MsgRcvrTask(void)
 			__func__);
 	TC_PRINT("%s: task_mbox_data_get of message data #3 is OK\n", __func__);
 
+	/* Receive fragment chain and take it over without copying */
+
+	struct k_mbox_frag *frags;
+	struct k_mbox_frag *frag;
+	int i;
+
+	setMsg_Receiver(&MRTmsg, myMbox, msgSenderTask, NULL, MSGSIZE * 2);
+	retValue = task_mbox_get(myMbox, &MRTmsg, TICKS_UNLIMITED);
+	if (RC_OK != retValue) {
+		TC_ERROR("task_mbox_get of fragment message returned %d\n",
+			retValue);
+		return TC_FAIL;
+	}
+	if (MRTmsg.size != MSGSIZE * 2) {
+		TC_ERROR("task_mbox_get of fragment message got wrong size (%d)\n",
+			MRTmsg.size);
+		return TC_FAIL;
+	}
+
+	retValue = task_mbox_data_frags_get(&MRTmsg, &frags);
+	if (RC_OK != retValue) {
+		TC_ERROR("task_mbox_data_frags_get returned %d\n", retValue);
+		return TC_FAIL;
+	}
+	if ((frags->next == NULL) || (frags->next->next != NULL) ||
+	    (strcmp(K_MBOX_FRAG_DATA(frags), myData1) != 0) ||
+	    (strcmp(K_MBOX_FRAG_DATA(frags->next), myData2) != 0)) {
+		TC_ERROR("task_mbox_data_frags_get got wrong fragments\n");
+		return TC_FAIL;
+	}
+
+	TC_PRINT("%s: task_mbox_data_frags_get of fragment message is OK\n",
+		__func__);
+
+	/* Forward the chain, then gather it into a buffer */
+
+	setMsg_Sender(&MRTmsg, myMbox, msgRcvrTask, NULL, 0, MSG_INFO1);
+	task_mbox_frags_put(myMbox, XFER_PRIO, &MRTmsg, frags, 0);
+
+	setMsg_Receiver(&MRTmsg, myMbox, ANYTASK, rxBuffer, MSGSIZE * 2);
+	retValue = task_mbox_get(myMbox, &MRTmsg, TICKS_NONE);
+	if (RC_OK != retValue) {
+		TC_ERROR("task_mbox_get of forwarded fragments returned %d\n",
+			retValue);
+		return TC_FAIL;
+	}
+	if ((MRTmsg.info != MSG_INFO1) || (MRTmsg.size != MSGSIZE * 2) ||
+	    (strcmp(rxBuffer, myData1) != 0) ||
+	    (strcmp(rxBuffer + MSGSIZE, myData2) != 0)) {
+		TC_ERROR("task_mbox_get of forwarded fragments got wrong data\n");
+		return TC_FAIL;
+	}
+
+	/* All fragments must have been returned to the pool */
+
+	frags = NULL;
+	for (i = 0; i < NUM_FRAGS; i++) {
+		if (task_mbox_frag_alloc(&frag, fragPool, MSGSIZE,
+					 TICKS_NONE) != RC_OK) {
+			TC_ERROR("fragment %d was not freed\n", i);
+			return TC_FAIL;
+		}
+		frag->next = frags;
+		frags = frag;
+	}
+	task_mbox_frags_free(frags);
+
+	TC_PRINT("%s: task_mbox_get of forwarded fragments is OK\n", __func__);
+
 	return TC_PASS;
 }
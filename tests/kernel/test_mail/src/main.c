@@ -59,6 +59,7 @@ extern const kmbox_t noRcvrMbox;
 
 kmemory_pool_t testPool			= TESTPOOL;
 kmemory_pool_t smallBlkszPool	= SMALLBLKSZPOOL;
+kmemory_pool_t fragPool			= FRAGPOOL;
 
 /**
  *
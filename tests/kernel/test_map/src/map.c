@@ -25,6 +25,8 @@
  *     task_mem_map_alloc
  *     task_mem_map_free
  *     task_mem_map_used_get
+ *     isr_mem_map_alloc (with CONFIG_MEM_MAP_LOCK_FREE)
+ *     isr_mem_map_free (with CONFIG_MEM_MAP_LOCK_FREE)
  *
  * @note
  * One should ensure that the block is released to the same map from which it
@@ -35,6 +37,9 @@
 #include <tc_util.h>
 #include <stdbool.h>
 #include <zephyr.h>
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+#include <irq_offload.h>
+#endif
 
 #define NUMBLOCKS   2       /*
                              * Number of memory blocks.  This number
@@ -52,6 +57,43 @@ int testMapFreeAllBlocks(void **P);
 DEFINE_MEM_MAP(MAP_LgBlks, 2, 1024);
 #endif
 
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+static void *isrPtr[NUMBLOCKS + 1];   /* blocks allocated from an ISR */
+static int isrRetValue[NUMBLOCKS + 1];
+
+/**
+ *
+ * @brief ISR that tries to allocate one block more than the map holds
+ *
+ * @return  N/A
+ */
+
+static void isrMapAllocAll(void *arg)
+{
+	int i;
+
+	ARG_UNUSED(arg);
+
+	for (i = 0; i <= NUMBLOCKS; i++) {
+		isrRetValue[i] = isr_mem_map_alloc(MAP_LgBlks, &isrPtr[i]);
+	}
+}
+
+/**
+ *
+ * @brief ISR that frees a memory block
+ *
+ * @param ptr    pointer to the memory block address
+ *
+ * @return  N/A
+ */
+
+static void isrMapFree(void *ptr)
+{
+	isr_mem_map_free(MAP_LgBlks, (void **)ptr);
+}
+#endif
+
 /**
  *
  * @brief Verify return value
@@ -128,6 +170,19 @@ void HelperTask(void)
 	}
 	TC_PRINT("%s: freed all blocks allocated by this task\n", __func__);
 
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+	task_sem_give(SEM_HELPERDONE);
+
+	/*
+	 * Part 6 of test.
+	 * RegressionTask is blocked waiting for a memory block again.  Freeing
+	 * a memory block from an ISR will unblock RegressionTask.
+	 */
+	task_sem_take(SEM_REGRESSDONE, TICKS_UNLIMITED);
+	TC_PRINT("%s: About to free a memory block from an ISR\n", __func__);
+	irq_offload(isrMapFree, &isrPtr[0]);
+#endif
+
 exitTest1:
 
 	TC_END_RESULT(tcRC);
@@ -267,6 +322,77 @@ int testMapFreeAllBlocks(void **p)
 	return TC_PASS;
 }   /* testMapFreeAllBlocks */
 
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+/**
+ *
+ * @brief Allocate and free memory blocks from an ISR
+ *
+ * This routine tests the following:
+ *
+ *   isr_mem_map_alloc, isr_mem_map_free
+ *
+ * It gets all blocks of the memory map from an ISR, then waits for a block
+ * that HelperTask frees from an ISR.
+ *
+ * @return  TC_PASS, TC_FAIL
+ */
+
+int testMapIsrAllocFree(void)
+{
+	int retValue;
+	void *b;
+	int i;
+
+	irq_offload(isrMapAllocAll, NULL);
+
+	for (i = 0; i < NUMBLOCKS; i++) {
+		if (!verifyRetValue(RC_OK, isrRetValue[i])) {
+			TC_ERROR("Failed isr_mem_map_alloc, retValue %d\n",
+				isrRetValue[i]);
+			return TC_FAIL;
+		}
+	}
+
+	if (!verifyRetValue(RC_FAIL, isrRetValue[NUMBLOCKS]) ||
+	    (isrPtr[NUMBLOCKS] != NULL)) {
+		TC_ERROR("Failed isr_mem_map_alloc, retValue %d\n",
+			isrRetValue[NUMBLOCKS]);
+		return TC_FAIL;
+	}
+
+	if (task_mem_map_used_get(MAP_LgBlks) != NUMBLOCKS) {
+		TC_ERROR("Failed task_mem_map_used_get\n");
+		return TC_FAIL;
+	}
+
+	TC_PRINT("%s: start to wait for block\n", __func__);
+	task_sem_give(SEM_REGRESSDONE);    /* Allow HelperTask to run part 6 */
+	retValue = task_mem_map_alloc(MAP_LgBlks, &b, 5);
+	if (verifyRetValue(RC_OK, retValue) && (b == isrPtr[0])) {
+		TC_PRINT("%s: task_mem_map_alloc OK, block allocated at %p\n",
+			__func__, b);
+	} else {
+		TC_ERROR("Failed task_mem_map_alloc, retValue %d\n", retValue);
+		return TC_FAIL;
+	}
+
+	/* Wait for HelperTask to complete */
+	task_sem_take(SEM_HELPERDONE, TICKS_UNLIMITED);
+
+	task_mem_map_free(MAP_LgBlks, &b);
+	for (i = 1; i < NUMBLOCKS; i++) {
+		irq_offload(isrMapFree, &isrPtr[i]);
+	}
+
+	if (task_mem_map_used_get(MAP_LgBlks) != 0) {
+		TC_ERROR("Failed isr_mem_map_free\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}   /* testMapIsrAllocFree */
+#endif
+
 /**
  *
  * @brief Print the pointers
@@ -390,6 +516,15 @@ void RegressionTask(void)
 	TC_PRINT("%s: 1 block freed, used %d block\n",
 		__func__,  task_mem_map_used_get(MAP_LgBlks));
 
+#ifdef CONFIG_MEM_MAP_LOCK_FREE
+	/* Part 6 of test */
+	tcRC = testMapIsrAllocFree();
+	if (tcRC == TC_FAIL) {
+		TC_ERROR("Failed testMapIsrAllocFree function\n");
+		goto exitTest;           /* terminate test */
+	}
+#endif
+
 exitTest:
 
 	TC_END_RESULT(tcRC);
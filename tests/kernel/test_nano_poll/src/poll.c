@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file
+ * @brief Test nanokernel multi-object wait
+ *
+ * A fiber polls a semaphore, a FIFO, a LIFO and a timer. This module tests
+ * the following scenarios:
+ * 1. the fiber is woken up by each object becoming ready: a semaphore given
+ *    by a task, data put in the FIFO by an ISR, data put in the LIFO by a
+ *    task, and the timer expiry
+ * 2. the fiber is woken up by the poll timeout when no object becomes ready
+ * 3. an object polled by a fiber cannot be polled by another fiber
+ * 4. a task polling objects returns an object already ready, times out, and
+ *    is woken up by the timer expiry
+ * 5. the expiry of a timer without user data is reported, whether it expires
+ *    while polled or before, until the timer is tested
+ * 6. a fiber polling without timeout waits again when the semaphore that woke
+ *    it up is taken by an ISR before the fiber runs
+ */
+
+#include <tc_util.h>
+#include <misc/nano_poll.h>
+#include <irq_offload.h>
+#include <errno.h>
+
+#define FIBER_STACKSIZE 512
+#define FIBER_PRIORITY  5
+
+#define TIMER_TICKS     5
+#define POLL_TICKS      5
+
+enum {
+	EVENT_SEM,
+	EVENT_FIFO,
+	EVENT_LIFO,
+	EVENT_TIMER,
+	NUM_EVENTS
+};
+
+static char __stack poll_stack[FIBER_STACKSIZE];
+static char __stack busy_stack[FIBER_STACKSIZE];
+
+static struct nano_sem sem;
+static struct nano_fifo fifo;
+static struct nano_lifo lifo;
+static struct nano_timer timer;
+
+/* first word of FIFO and LIFO data is reserved for the kernel */
+static void *fifo_data[2];
+static void *lifo_data[2];
+
+static struct nano_poll_event events[NUM_EVENTS] = {
+	NANO_POLL_EVENT_INITIALIZER(NANO_POLL_TYPE_SEM, &sem),
+	NANO_POLL_EVENT_INITIALIZER(NANO_POLL_TYPE_FIFO, &fifo),
+	NANO_POLL_EVENT_INITIALIZER(NANO_POLL_TYPE_LIFO, &lifo),
+	NANO_POLL_EVENT_INITIALIZER(NANO_POLL_TYPE_TIMER, &timer),
+};
+
+static struct nano_poll_event busy_event =
+	NANO_POLL_EVENT_INITIALIZER(NANO_POLL_TYPE_SEM, &sem);
+
+static struct nano_sem done_sem;
+
+static struct nano_timer null_timer;
+static struct nano_poll_event null_timer_event =
+	NANO_POLL_EVENT_INITIALIZER(NANO_POLL_TYPE_TIMER, &null_timer);
+
+static int poll_result;
+static int busy_result;
+
+static void poll_fiber(int timeout, int arg2)
+{
+	ARG_UNUSED(arg2);
+
+	poll_result = nano_fiber_poll(events, NUM_EVENTS, timeout);
+	nano_fiber_sem_give(&done_sem);
+}
+
+static void null_timer_fiber(int arg1, int arg2)
+{
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+
+	poll_result = nano_fiber_poll(&null_timer_event, 1, TICKS_UNLIMITED);
+	nano_fiber_sem_give(&done_sem);
+}
+
+static void busy_fiber(int arg1, int arg2)
+{
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+
+	busy_result = nano_fiber_poll(&busy_event, 1, TICKS_UNLIMITED);
+	nano_fiber_sem_give(&done_sem);
+}
+
+/* the fiber runs right away and waits on the objects */
+static void poll_fiber_start(int32_t timeout)
+{
+	task_fiber_start(poll_stack, FIBER_STACKSIZE, poll_fiber, timeout, 0,
+			 FIBER_PRIORITY, 0);
+}
+
+static int poll_fiber_result(int expected)
+{
+	if (!nano_task_sem_take(&done_sem, sys_clock_ticks_per_sec)) {
+		TC_ERROR(" *** polling fiber not woken up\n");
+		return TC_FAIL;
+	}
+
+	if (poll_result != expected) {
+		TC_ERROR(" *** poll returned %d, expected %d\n",
+			 poll_result, expected);
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+static void isr_fifo_put(void *arg)
+{
+	nano_isr_fifo_put(&fifo, arg);
+}
+
+/* wake up the polling fiber, then take the semaphore before it runs */
+static void isr_sem_give_take(void *arg)
+{
+	ARG_UNUSED(arg);
+
+	nano_isr_sem_give(&sem);
+	nano_isr_sem_take(&sem, TICKS_NONE);
+}
+
+static void signal_event(int index)
+{
+	switch (index) {
+	case EVENT_SEM:
+		nano_task_sem_give(&sem);
+		break;
+	case EVENT_FIFO:
+		irq_offload(isr_fifo_put, fifo_data);
+		break;
+	case EVENT_LIFO:
+		nano_task_lifo_put(&lifo, lifo_data);
+		break;
+	case EVENT_TIMER:
+		nano_task_timer_start(&timer, TIMER_TICKS);
+		break;
+	}
+}
+
+/* the object is left ready by the poll: take it */
+static int consume_event(int index)
+{
+	switch (index) {
+	case EVENT_SEM:
+		return nano_task_sem_take(&sem, TICKS_NONE);
+	case EVENT_FIFO:
+		return nano_task_fifo_get(&fifo, TICKS_NONE) == fifo_data;
+	case EVENT_LIFO:
+		return nano_task_lifo_get(&lifo, TICKS_NONE) == lifo_data;
+	case EVENT_TIMER:
+		return nano_task_timer_test(&timer, TICKS_NONE) == &timer;
+	}
+
+	return 0;
+}
+
+static int test_fiber_wakeup(void)
+{
+	int i;
+
+	TC_PRINT("Testing fiber woken up by each object\n");
+
+	for (i = 0; i < NUM_EVENTS; i++) {
+		poll_fiber_start(TICKS_UNLIMITED);
+		signal_event(i);
+
+		if (poll_fiber_result(i) != TC_PASS) {
+			return TC_FAIL;
+		}
+		if (!consume_event(i)) {
+			TC_ERROR(" *** object %d not ready after poll\n", i);
+			return TC_FAIL;
+		}
+	}
+
+	return TC_PASS;
+}
+
+static int test_fiber_lost_race(void)
+{
+	TC_PRINT("Testing fiber losing the object to another thread\n");
+
+	poll_fiber_start(TICKS_UNLIMITED);
+	irq_offload(isr_sem_give_take, NULL);
+
+	/* without a timeout, the fiber waits again */
+	if (nano_task_sem_take(&done_sem, TICKS_NONE)) {
+		TC_ERROR(" *** poll returned %d without a ready object\n",
+			 poll_result);
+		return TC_FAIL;
+	}
+
+	signal_event(EVENT_SEM);
+	if (poll_fiber_result(EVENT_SEM) != TC_PASS) {
+		return TC_FAIL;
+	}
+	if (!consume_event(EVENT_SEM)) {
+		TC_ERROR(" *** object %d not ready after poll\n", EVENT_SEM);
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+static int test_fiber_timeout(void)
+{
+	uint32_t start_tick = sys_tick_get_32();
+	uint32_t elapsed;
+
+	TC_PRINT("Testing fiber poll timeout\n");
+
+	poll_fiber_start(POLL_TICKS);
+	if (poll_fiber_result(-EAGAIN) != TC_PASS) {
+		return TC_FAIL;
+	}
+
+	elapsed = sys_tick_get_32() - start_tick;
+	if (elapsed < POLL_TICKS) {
+		TC_ERROR(" *** poll timed out after %d ticks, not %d\n",
+			 elapsed, POLL_TICKS);
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+static int test_fiber_busy(void)
+{
+	TC_PRINT("Testing object polled by two fibers\n");
+
+	poll_fiber_start(TICKS_UNLIMITED);
+	task_fiber_start(busy_stack, FIBER_STACKSIZE, busy_fiber, 0, 0,
+			 FIBER_PRIORITY, 0);
+
+	if (!nano_task_sem_take(&done_sem, sys_clock_ticks_per_sec) ||
+	    busy_result != -EADDRINUSE) {
+		TC_ERROR(" *** second fiber polled a polled object\n");
+		return TC_FAIL;
+	}
+
+	signal_event(EVENT_SEM);
+	if (poll_fiber_result(EVENT_SEM) != TC_PASS) {
+		return TC_FAIL;
+	}
+	consume_event(EVENT_SEM);
+
+	return TC_PASS;
+}
+
+static int test_task_poll(void)
+{
+	int rc;
+
+	TC_PRINT("Testing task poll\n");
+
+	signal_event(EVENT_LIFO);
+	rc = nano_task_poll(events, NUM_EVENTS, TICKS_NONE);
+	if (rc != EVENT_LIFO || !consume_event(EVENT_LIFO)) {
+		TC_ERROR(" *** ready object not returned: %d\n", rc);
+		return TC_FAIL;
+	}
+
+	rc = nano_task_poll(events, NUM_EVENTS, POLL_TICKS);
+	if (rc != -EAGAIN) {
+		TC_ERROR(" *** poll returned %d, expected timeout\n", rc);
+		return TC_FAIL;
+	}
+
+	signal_event(EVENT_TIMER);
+	rc = nano_task_poll(events, NUM_EVENTS, TICKS_UNLIMITED);
+	if (rc != EVENT_TIMER || !consume_event(EVENT_TIMER)) {
+		TC_ERROR(" *** timer expiry not returned: %d\n", rc);
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+static int test_null_timer(void)
+{
+	int rc;
+
+	TC_PRINT("Testing timer without user data\n");
+
+	task_fiber_start(poll_stack, FIBER_STACKSIZE, null_timer_fiber, 0, 0,
+			 FIBER_PRIORITY, 0);
+	nano_task_timer_start(&null_timer, TIMER_TICKS);
+	if (poll_fiber_result(0) != TC_PASS) {
+		return TC_FAIL;
+	}
+
+	/* the expiry is reported until the timer is tested */
+	rc = nano_task_poll(&null_timer_event, 1, TICKS_NONE);
+	if (rc != 0) {
+		TC_ERROR(" *** timer expiry not kept: %d\n", rc);
+		return TC_FAIL;
+	}
+
+	nano_task_timer_test(&null_timer, TICKS_NONE);
+	rc = nano_task_poll(&null_timer_event, 1, TICKS_NONE);
+	if (rc != -EAGAIN) {
+		TC_ERROR(" *** tested timer still ready: %d\n", rc);
+		return TC_FAIL;
+	}
+
+	/* the timer expires before it is polled */
+	nano_task_timer_start(&null_timer, TIMER_TICKS);
+	while (nano_timer_ticks_remain(&null_timer)) {
+	}
+
+	rc = nano_task_poll(&null_timer_event, 1, TICKS_NONE);
+	if (rc != 0) {
+		TC_ERROR(" *** timer expiry before poll not returned: %d\n",
+			 rc);
+		return TC_FAIL;
+	}
+	nano_task_timer_test(&null_timer, TICKS_NONE);
+
+	return TC_PASS;
+}
+
+void main(void)
+{
+	int status = TC_FAIL;
+
+	TC_START("Test Nanokernel Multi-Object Wait\n");
+
+	nano_sem_init(&sem);
+	nano_fifo_init(&fifo);
+	nano_lifo_init(&lifo);
+	nano_timer_init(&timer, &timer);
+	nano_timer_init(&null_timer, NULL);
+	nano_sem_init(&done_sem);
+
+	if (test_fiber_wakeup() != TC_PASS ||
+	    test_fiber_lost_race() != TC_PASS ||
+	    test_fiber_timeout() != TC_PASS ||
+	    test_fiber_busy() != TC_PASS ||
+	    test_task_poll() != TC_PASS ||
+	    test_null_timer() != TC_PASS) {
+		goto done_tests;
+	}
+
+	status = TC_PASS;
+
+done_tests:
+	TC_END_REPORT(status);
+}
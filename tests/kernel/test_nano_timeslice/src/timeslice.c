@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file
+ * @brief Test nanokernel fiber time slicing
+ *
+ * Two fibers of equal priority are made runnable; the first one busy waits
+ * until the second one runs. This module tests the following scenarios:
+ * 1. the busy fiber is preempted once its time slice expires
+ * 2. the busy fiber is not preempted with time slicing disabled
+ * 3. the busy fiber is not preempted when its priority is above the time
+ *    slicing priority threshold
+ */
+
+#include <tc_util.h>
+
+#define FIBER_STACKSIZE 512
+#define FIBER_PRIORITY  5
+#define SLICE_TICKS     CONFIG_NANO_TIMESLICE_SIZE
+#define BUSY_TICKS      (SLICE_TICKS * 10)
+
+static char __stack launcher_stack[FIBER_STACKSIZE];
+static char __stack busy_stack[FIBER_STACKSIZE];
+static char __stack other_stack[FIBER_STACKSIZE];
+
+static struct nano_sem done_sem;
+
+static volatile int other_ran;
+static uint32_t busy_ticks;
+
+static void busy_fiber(int arg1, int arg2)
+{
+	uint32_t start = sys_tick_get_32();
+
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+
+	while (!other_ran && (sys_tick_get_32() - start) < BUSY_TICKS) {
+		/* busy wait */
+	}
+	busy_ticks = sys_tick_get_32() - start;
+
+	nano_fiber_sem_give(&done_sem);
+}
+
+static void other_fiber(int arg1, int arg2)
+{
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+
+	other_ran = 1;
+
+	nano_fiber_sem_give(&done_sem);
+}
+
+/* make both fibers runnable, in order, before either of them runs */
+static void launcher_fiber(int arg1, int arg2)
+{
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+
+	fiber_fiber_start(busy_stack, FIBER_STACKSIZE, busy_fiber, 0, 0,
+			  FIBER_PRIORITY, 0);
+	fiber_fiber_start(other_stack, FIBER_STACKSIZE, other_fiber, 0, 0,
+			  FIBER_PRIORITY, 0);
+}
+
+static int run_fibers(int expect_preemption)
+{
+	other_ran = 0;
+
+	task_fiber_start(launcher_stack, FIBER_STACKSIZE, launcher_fiber, 0, 0,
+			 FIBER_PRIORITY - 1, 0);
+
+	nano_task_sem_take(&done_sem, TICKS_UNLIMITED);
+	nano_task_sem_take(&done_sem, TICKS_UNLIMITED);
+
+	TC_PRINT(" busy fiber ran for %d ticks\n", busy_ticks);
+
+	if (expect_preemption && busy_ticks > SLICE_TICKS + 1) {
+		TC_ERROR(" *** busy fiber not preempted after %d ticks\n",
+			 SLICE_TICKS);
+		return TC_FAIL;
+	}
+
+	if (!expect_preemption && busy_ticks < BUSY_TICKS) {
+		TC_ERROR(" *** busy fiber preempted\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+void main(void)
+{
+	int status = TC_FAIL;
+
+	TC_START("Test Nanokernel Fiber Time Slicing\n");
+
+	nano_sem_init(&done_sem);
+
+	TC_PRINT("Testing preemption at the end of the time slice\n");
+	if (run_fibers(1) != TC_PASS) {
+		goto done_tests;
+	}
+
+	TC_PRINT("Testing time slicing disabled\n");
+	sys_fiber_time_slice_set(0, 0);
+	if (run_fibers(0) != TC_PASS) {
+		goto done_tests;
+	}
+
+	TC_PRINT("Testing time slicing priority threshold\n");
+	sys_fiber_time_slice_set(SLICE_TICKS, FIBER_PRIORITY + 1);
+	if (run_fibers(0) != TC_PASS) {
+		goto done_tests;
+	}
+
+	status = TC_PASS;
+
+done_tests:
+	TC_END_REPORT(status);
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file
+ * @brief Test nanokernel work queue APIs
+ *
+ * This module tests the following work queue scenarios:
+ * 1. work items run in submission order on a private work queue
+ * 2. a work item submitted twice while pending runs once
+ * 3. a work item submitted from an ISR runs on the system work queue
+ * 4. a work item cancelled while pending does not run
+ * 5. a delayed work item runs after its delay
+ * 6. a cancelled delayed work item does not run
+ */
+
+#include <tc_util.h>
+#include <misc/nano_work.h>
+#include <irq_offload.h>
+#include <errno.h>
+
+#define WORKQUEUE_STACKSIZE 512
+#define WORKQUEUE_PRIORITY  5
+
+#define NUM_WORK_ITEMS      4
+#define DELAY_TICKS         5
+
+static char __stack workqueue_stack[WORKQUEUE_STACKSIZE];
+static struct nano_workqueue workqueue;
+
+static struct nano_work work_items[NUM_WORK_ITEMS];
+static struct nano_delayed_work delayed_work;
+
+static struct nano_sem done_sem;
+
+static int run_order[NUM_WORK_ITEMS * 2];
+static int num_runs;
+static uint32_t run_tick;
+static int cancel_result;
+
+static void work_handler(struct nano_work *work)
+{
+	run_order[num_runs++] = work - work_items;
+	run_tick = sys_tick_get_32();
+	nano_fiber_sem_give(&done_sem);
+}
+
+static void delayed_work_handler(struct nano_work *work)
+{
+	ARG_UNUSED(work);
+
+	num_runs++;
+	run_tick = sys_tick_get_32();
+	nano_fiber_sem_give(&done_sem);
+}
+
+static void isr_submit_twice(void *arg)
+{
+	nano_work_submit((struct nano_work *)arg);
+	nano_work_submit((struct nano_work *)arg);
+}
+
+static void isr_submit_cancel(void *arg)
+{
+	struct nano_work *work = arg;
+
+	nano_work_submit(work);
+	cancel_result = nano_work_pending(work) ? nano_work_cancel(work) : 1;
+}
+
+static int test_submit_order(void)
+{
+	int i;
+
+	TC_PRINT("Testing work item submission order\n");
+
+	num_runs = 0;
+	for (i = 0; i < NUM_WORK_ITEMS; i++) {
+		nano_work_submit_to_queue(&workqueue, &work_items[i]);
+	}
+
+	for (i = 0; i < NUM_WORK_ITEMS; i++) {
+		if (!nano_task_sem_take(&done_sem, sys_clock_ticks_per_sec)) {
+			TC_ERROR(" *** work item %d did not run\n", i);
+			return TC_FAIL;
+		}
+		if (run_order[i] != i) {
+			TC_ERROR(" *** work item %d ran in position %d\n",
+				 run_order[i], i);
+			return TC_FAIL;
+		}
+	}
+
+	return TC_PASS;
+}
+
+static int test_resubmit(void)
+{
+	TC_PRINT("Testing resubmission of a pending work item\n");
+
+	/* the ISR submits twice before the work queue fiber can run */
+	num_runs = 0;
+	irq_offload(isr_submit_twice, &work_items[0]);
+	if (!nano_task_sem_take(&done_sem, sys_clock_ticks_per_sec)) {
+		TC_ERROR(" *** work item submitted from ISR did not run\n");
+		return TC_FAIL;
+	}
+
+	task_sleep(2);
+	if (num_runs != 1) {
+		TC_ERROR(" *** work item ran %d times, not once\n", num_runs);
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+static int test_cancel(void)
+{
+	TC_PRINT("Testing cancellation of a pending work item\n");
+
+	num_runs = 0;
+	irq_offload(isr_submit_cancel, &work_items[1]);
+	if (cancel_result != 0) {
+		TC_ERROR(" *** nano_work_cancel() of a pending work item failed\n");
+		return TC_FAIL;
+	}
+	task_sleep(2);
+	if (num_runs != 0) {
+		TC_ERROR(" *** cancelled work item ran\n");
+		return TC_FAIL;
+	}
+
+	/* the work item can be submitted again after cancellation */
+	nano_work_submit(&work_items[1]);
+	if (!nano_task_sem_take(&done_sem, sys_clock_ticks_per_sec)) {
+		TC_ERROR(" *** work item did not run after cancellation\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+static int test_delayed(void)
+{
+	uint32_t start_tick;
+
+	TC_PRINT("Testing delayed work item\n");
+
+	num_runs = 0;
+	start_tick = sys_tick_get_32();
+	nano_delayed_work_submit(&delayed_work, DELAY_TICKS);
+	if (!nano_task_sem_take(&done_sem, DELAY_TICKS * 4)) {
+		TC_ERROR(" *** delayed work item did not run\n");
+		return TC_FAIL;
+	}
+	if (run_tick - start_tick < DELAY_TICKS) {
+		TC_ERROR(" *** delayed work item ran after %d ticks, not %d\n",
+			 run_tick - start_tick, DELAY_TICKS);
+		return TC_FAIL;
+	}
+
+	TC_PRINT("Testing cancellation of a delayed work item\n");
+
+	num_runs = 0;
+	nano_delayed_work_submit(&delayed_work, DELAY_TICKS);
+	if (nano_delayed_work_cancel(&delayed_work) != 0) {
+		TC_ERROR(" *** nano_delayed_work_cancel() failed\n");
+		return TC_FAIL;
+	}
+	task_sleep(DELAY_TICKS * 2);
+	if (num_runs != 0) {
+		TC_ERROR(" *** cancelled delayed work item ran\n");
+		return TC_FAIL;
+	}
+	if (nano_delayed_work_cancel(&delayed_work) != -EINVAL) {
+		TC_ERROR(" *** idle delayed work item was cancelled\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+void main(void)
+{
+	int status = TC_FAIL;
+	int i;
+
+	TC_START("Test Nanokernel Work Queue APIs\n");
+
+	nano_sem_init(&done_sem);
+
+	for (i = 0; i < NUM_WORK_ITEMS; i++) {
+		nano_work_init(&work_items[i], work_handler);
+	}
+	nano_delayed_work_init(&delayed_work, delayed_work_handler);
+
+	nano_workqueue_start(&workqueue, workqueue_stack,
+			     sizeof(workqueue_stack), WORKQUEUE_PRIORITY);
+
+	if (test_submit_order() != TC_PASS ||
+	    test_resubmit() != TC_PASS ||
+	    test_cancel() != TC_PASS ||
+	    test_delayed() != TC_PASS) {
+		goto done_tests;
+	}
+
+	status = TC_PASS;
+
+done_tests:
+	TC_END_REPORT(status);
+}
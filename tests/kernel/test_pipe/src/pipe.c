@@ -22,6 +22,8 @@
  *
  *    task_pipe_put()
  *    task_pipe_get()
+ *    task_pipe_put_reserve(), task_pipe_put_commit()
+ *    task_pipe_get_peek(), task_pipe_get_release()
  *
  * The following target pipe routine does not yet have a test case:
  *    task_pipe_block_put()
@@ -30,6 +32,7 @@
 #include <zephyr.h>
 #include <tc_util.h>
 #include <misc/util.h>
+#include <string.h>
 
 #define  ONE_SECOND     (sys_clock_ticks_per_sec)
 
@@ -944,6 +947,116 @@ int pipeGetTimeoutTest(void)
 	return TC_PASS;
 }
 
+/**
+ *
+ * @brief Routine to test the zero-copy pipe APIs
+ *
+ * This routine fills the pipe through task_pipe_put_reserve() and
+ * task_pipe_put_commit(), and empties it through task_pipe_get_peek() and
+ * task_pipe_get_release(), wrapping around the end of the pipe buffer if
+ * the pipe buffer is not empty at its start.
+ *
+ * @return TC_PASS on success, TC_FAIL on failure
+ */
+
+int pipeSpanTest(void)
+{
+	struct k_pipe_span  span;
+	int  rv;        /* return code from task_pipe_XXX() */
+	int  bytes;     /* # of bytes transferred by task_pipe_XXX() */
+	int  offset;    /* # of bytes transferred through spans */
+
+	rv = task_pipe_put_reserve(pipeId, &span, PIPE_SIZE + 1, _ALL_N);
+	if (rv != RC_FAIL) {
+		TC_ERROR("Expected return code %d, not %d\n", RC_FAIL, rv);
+		return TC_FAIL;
+	}
+
+	/* fill the pipe, in 2 spans if its free space wraps around */
+	for (offset = 0; offset < PIPE_SIZE; offset += bytes) {
+		rv = task_pipe_put_reserve(pipeId, &span, PIPE_SIZE - offset,
+								   _1_TO_N);
+		if ((rv != RC_OK) || (span.size <= 0)) {
+			TC_ERROR("Failed to reserve %d bytes, rv %d\n",
+					 PIPE_SIZE - offset, rv);
+			return TC_FAIL;
+		}
+		memcpy(span.data, &txBuffer[offset], span.size);
+
+		/* data is not in the pipe until it is committed */
+		if (offset == 0) {
+			rv = task_pipe_get(pipeId, rxBuffer, 1, &bytes, _ALL_N,
+							   TICKS_NONE);
+			if (rv != RC_FAIL) {
+				TC_ERROR("Expected return code %d, not %d\n",
+						 RC_FAIL, rv);
+				return TC_FAIL;
+			}
+		}
+
+		bytes = span.size;
+		task_pipe_put_commit(&span);
+		if ((span.size != 0) || (span.data != NULL)) {
+			TC_ERROR("Span not reset by task_pipe_put_commit()\n");
+			return TC_FAIL;
+		}
+	}
+
+	rv = task_pipe_put_reserve(pipeId, &span, 1, _1_TO_N);
+	if (rv != RC_FAIL) {
+		TC_ERROR("Expected return code %d, not %d\n", RC_FAIL, rv);
+		return TC_FAIL;
+	}
+
+	rv = task_pipe_get(pipeId, rxBuffer, PIPE_SIZE, &bytes, _ALL_N,
+					   TICKS_NONE);
+	if ((rv != RC_OK) || (bytes != PIPE_SIZE) ||
+		(receiveBufferCheck(rxBuffer, PIPE_SIZE) != PIPE_SIZE)) {
+		TC_ERROR("Failed to get committed data, rv %d\n", rv);
+		return TC_FAIL;
+	}
+
+	rv = task_pipe_put(pipeId, txBuffer, PIPE_SIZE, &bytes, _ALL_N,
+					   TICKS_NONE);
+	if ((rv != RC_OK) || (bytes != PIPE_SIZE)) {
+		TC_ERROR("Failed to fill pipe, rv %d\n", rv);
+		return TC_FAIL;
+	}
+
+	/* empty the pipe, in 2 spans if its data wraps around */
+	for (offset = 0; offset < PIPE_SIZE; offset += bytes) {
+		rv = task_pipe_get_peek(pipeId, &span, PIPE_SIZE, _1_TO_N);
+		if ((rv != RC_OK) || (span.size <= 0) ||
+			(span.size > PIPE_SIZE - offset) ||
+			(memcmp(span.data, &txBuffer[offset], span.size) != 0)) {
+			TC_ERROR("Failed to peek at data, rv %d\n", rv);
+			return TC_FAIL;
+		}
+
+		/* space is not freed until the data is released */
+		if (offset == 0) {
+			rv = task_pipe_put(pipeId, txBuffer, 1, &bytes, _ALL_N,
+							   TICKS_NONE);
+			if (rv != RC_FAIL) {
+				TC_ERROR("Expected return code %d, not %d\n",
+						 RC_FAIL, rv);
+				return TC_FAIL;
+			}
+		}
+
+		bytes = span.size;
+		task_pipe_get_release(&span);
+	}
+
+	rv = task_pipe_get_peek(pipeId, &span, 1, _1_TO_N);
+	if (rv != RC_FAIL) {
+		TC_ERROR("Expected return code %d, not %d\n", RC_FAIL, rv);
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
 /**
  *
  * @brief Alternate task in the test suite
@@ -1042,5 +1155,11 @@ int RegressionTask(void)
 		return TC_FAIL;
 	}
 
+	TC_PRINT("Testing zero-copy pipe spans ...\n");
+	tcRC = pipeSpanTest();
+	if (tcRC != TC_PASS) {
+		return TC_FAIL;
+	}
+
 	return TC_PASS;
 }
@@ -19,15 +19,112 @@
 #include <zephyr.h>
 #include <tc_util.h>
 #include <misc/ring_buffer.h>
+#ifdef CONFIG_RING_BUFFER_LOCK_FREE
+#include <irq_offload.h>
+#endif
 
 SYS_RING_BUF_DECLARE_POW2(ring_buf, 8);
 
+#ifdef CONFIG_RING_BUFFER_LOCK_FREE
+#define ring_buf_put sys_ring_buf_put_lock_free
+#else
+#define ring_buf_put sys_ring_buf_put
+#endif
+
 char data[] = "ABCDEFGHIJKLMNOPQRSTUVWX";
 #define TYPE	1
 #define VALUE	2
 
 #define INITIAL_SIZE	2
 
+#ifdef CONFIG_RING_BUFFER_LOCK_FREE
+static void isr_put(void *arg)
+{
+	ARG_UNUSED(arg);
+
+	sys_ring_buf_put_lock_free(&ring_buf, TYPE + 1, VALUE, NULL, 0);
+}
+
+static int test_isr_put(void)
+{
+	uint8_t getsize, getval;
+	uint16_t gettype;
+	uint32_t getdata[1];
+
+	printk("Testing lock-free puts from a task and an ISR\n");
+
+	sys_ring_buf_put_lock_free(&ring_buf, TYPE, VALUE, NULL, 0);
+	irq_offload(isr_put, NULL);
+
+	getsize = SIZE32_OF(getdata);
+	if (sys_ring_buf_get(&ring_buf, &gettype, &getval, getdata,
+			     &getsize) < 0 || gettype != TYPE) {
+		printk("task entry not retrieved first\n");
+		return TC_FAIL;
+	}
+
+	getsize = SIZE32_OF(getdata);
+	if (sys_ring_buf_get(&ring_buf, &gettype, &getval, getdata,
+			     &getsize) < 0 || gettype != TYPE + 1) {
+		printk("ISR entry not retrieved second\n");
+		return TC_FAIL;
+	}
+
+	if (!sys_ring_buf_is_empty(&ring_buf)) {
+		printk("ring buffer not empty\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+
+static int test_nested_isr_put(void)
+{
+	uint8_t getsize, getval;
+	uint16_t gettype;
+	uint32_t getdata[1];
+
+	printk("Testing a lock-free put from an ISR nested in a task put\n");
+
+	/*
+	 * Stand for a task put preempted before publishing its entry: the
+	 * ISR entry must stay hidden until the outermost producer is done.
+	 */
+	atomic_inc(&ring_buf.nesting);
+	irq_offload(isr_put, NULL);
+
+	if (!sys_ring_buf_is_empty(&ring_buf)) {
+		atomic_dec(&ring_buf.nesting);
+		printk("ISR entry published by a nested put\n");
+		return TC_FAIL;
+	}
+
+	atomic_dec(&ring_buf.nesting);
+	sys_ring_buf_put_lock_free(&ring_buf, TYPE, VALUE, NULL, 0);
+
+	getsize = SIZE32_OF(getdata);
+	if (sys_ring_buf_get(&ring_buf, &gettype, &getval, getdata,
+			     &getsize) < 0 || gettype != TYPE + 1) {
+		printk("ISR entry not published by the outermost put\n");
+		return TC_FAIL;
+	}
+
+	getsize = SIZE32_OF(getdata);
+	if (sys_ring_buf_get(&ring_buf, &gettype, &getval, getdata,
+			     &getsize) < 0 || gettype != TYPE) {
+		printk("task entry not retrieved after the ISR entry\n");
+		return TC_FAIL;
+	}
+
+	if (!sys_ring_buf_is_empty(&ring_buf)) {
+		printk("ring buffer not empty\n");
+		return TC_FAIL;
+	}
+
+	return TC_PASS;
+}
+#endif
+
 void main(void)
 {
 	int ret, put_count, i, rv;
@@ -41,8 +138,8 @@ void main(void)
 	rv = TC_FAIL;
 	put_count = 0;
 	while (1) {
-		ret = sys_ring_buf_put(&ring_buf, TYPE, VALUE,
-				       (uint32_t *)data, dsize);
+		ret = ring_buf_put(&ring_buf, TYPE, VALUE,
+				   (uint32_t *)data, dsize);
 		if (ret == -EMSGSIZE) {
 			printk("ring buffer is full\n");
 			break;
@@ -98,6 +195,15 @@ void main(void)
 	}
 	printk("empty buffer detected\n");
 
+#ifdef CONFIG_RING_BUFFER_LOCK_FREE
+	if (test_isr_put() != TC_PASS) {
+		goto done;
+	}
+	if (test_nested_isr_put() != TC_PASS) {
+		goto done;
+	}
+#endif
+
 	rv = TC_PASS;
 done:
 	printk("head: %d tail: %d\n", ring_buf.head, ring_buf.tail);
@@ -28,12 +28,16 @@
  * task_sem_take()
  * isr_sem_give()
  * fiber_sem_give()
+ * task_cmd_pkt_sem_give()
+ * task_cmd_pkt_event_send()
+ * task_cmd_pkts_submit()
  */
 
 #include <zephyr.h>
 #include <tc_util.h>
 
 #include <util_test_common.h>
+#include <microkernel/command_packet.h>
 
 extern void trigger_isrSemaSignal(ksem_t semaphore);
 extern void releaseTestFiber(void);
@@ -42,6 +46,17 @@ extern void releaseTestFiber(void);
 
 #define OBJ_TIMEOUT  SECONDS(1)
 
+/* larger than the command stack, to be submitted in several chunks */
+#define BIG_BATCH_SIZE (CONFIG_COMMAND_STACK_SIZE + 8)
+
+/* semaphores given from an ISR while a full chunk is processed */
+#define BATCH_ISR_GIVES CONFIG_COMMAND_STACK_RESERVE
+
+/* utilize non-public microkernel API for test purposes */
+extern struct nano_stack _k_command_stack;
+
+static int batchStackDepth;
+
 extern ksem_t simpleSem;
 extern ksem_t altSem;
 extern ksem_t hpSem;
@@ -288,6 +303,125 @@ int simpleGroupTest(void)
 	return TC_PASS;
 }
 
+/**
+ *
+ * @brief Event handler giving semaphores from an ISR
+ *
+ * The handler runs in the microkernel server while it processes the first
+ * packet of a batch chunk, the rest of the chunk being on the command stack.
+ *
+ * @param event    signalled event
+ *
+ * @return 0, the event is not passed on to a waiting task
+ */
+
+static int batchEventHandler(int event)
+{
+	int i;
+
+	ARG_UNUSED(event);
+
+	for (i = 0; i < BATCH_ISR_GIVES; i++) {
+		trigger_isrSemaSignal(semList[1]);
+	}
+
+	batchStackDepth = _k_command_stack.next - _k_command_stack.base;
+
+	return 0;
+}
+
+/**
+ *
+ * @brief Test giving semaphores with a batch of command packets
+ *
+ * @return TC_PASS on success, TC_FAIL on failure
+ */
+
+static int batchedGiveTest(void)
+{
+	static cmdPkt_t bigBatch[BIG_BATCH_SIZE];
+	cmdPkt_t pkts[8];
+	int     num = 0;
+	int     i;
+	int     j;
+	int     status;
+
+	task_sem_group_reset(semList);
+
+	/* give each semaphore of the group twice, in a single batch */
+
+	for (i = 0; i < 2; i++) {
+		for (j = 0; semList[j] != ENDLIST; j++) {
+			task_cmd_pkt_sem_give(&pkts[num++], semList[j]);
+		}
+	}
+	task_cmd_pkts_submit(pkts, num);
+
+	for (j = 0; semList[j] != ENDLIST; j++) {
+		status = task_sem_count_get(semList[j]);
+		if (status != 2) {
+			TC_ERROR("task_sem_count_get() returned %d not %d\n",
+					 status, 2);
+			return TC_FAIL;
+		}
+	}
+
+	task_sem_group_reset(semList);
+
+	/* give a semaphore more times than the command stack has room for */
+
+	for (i = 0; i < BIG_BATCH_SIZE; i++) {
+		task_cmd_pkt_sem_give(&bigBatch[i], semList[0]);
+	}
+	task_cmd_pkts_submit(bigBatch, BIG_BATCH_SIZE);
+
+	status = task_sem_count_get(semList[0]);
+	if (status != BIG_BATCH_SIZE) {
+		TC_ERROR("task_sem_count_get() returned %d not %d\n",
+				 status, BIG_BATCH_SIZE);
+		return TC_FAIL;
+	}
+
+	task_sem_group_reset(semList);
+
+	/*
+	 * give semaphores from an ISR while a full chunk is in flight: the
+	 * command stack keeps room for them
+	 */
+
+	task_event_handler_set(BATCH_EVENT, batchEventHandler);
+	task_cmd_pkt_event_send(&bigBatch[0], BATCH_EVENT);
+	for (i = 1; i < BIG_BATCH_SIZE; i++) {
+		task_cmd_pkt_sem_give(&bigBatch[i], semList[0]);
+	}
+	task_cmd_pkts_submit(bigBatch, BIG_BATCH_SIZE);
+	task_event_handler_set(BATCH_EVENT, NULL);
+
+	if (batchStackDepth > CONFIG_COMMAND_STACK_SIZE) {
+		TC_ERROR("Command stack overflow, %d packets queued\n",
+				 batchStackDepth);
+		return TC_FAIL;
+	}
+
+	status = task_sem_count_get(semList[0]);
+	if (status != BIG_BATCH_SIZE - 1) {
+		TC_ERROR("task_sem_count_get() returned %d not %d\n",
+				 status, BIG_BATCH_SIZE - 1);
+		return TC_FAIL;
+	}
+
+	status = task_sem_count_get(semList[1]);
+	if (status != BATCH_ISR_GIVES) {
+		TC_ERROR("task_sem_count_get() returned %d not %d\n",
+				 status, BATCH_ISR_GIVES);
+		return TC_FAIL;
+	}
+
+	task_sem_group_reset(semList);
+
+	return TC_PASS;
+}
+
 /**
  *
  * @brief Test a group of semaphores with waiting
@@ -641,6 +775,12 @@ int RegressionTask(void)
 		return TC_FAIL;
 	}
 
+	TC_PRINT("Testing batched semaphore release\n");
+	tcRC = batchedGiveTest();
+	if (tcRC != TC_PASS) {
+		return TC_FAIL;
+	}
+
 	TC_PRINT("Testing semaphore groups with blocking\n");
 	tcRC = simpleGroupWaitTest();
 	if (tcRC != TC_PASS) {
@@ -37,6 +37,9 @@
  *
  * Scenario #4:
  * Timeout scenarios with multiple semaphores and fibers.
+ *
+ * Scenario #5:
+ * Fibers of different priorities pend on a priority-ordered semaphore.
  */
 
 #include <tc_util.h>
@@ -501,6 +504,84 @@ static int test_multiple_waiters(void)
 	return TC_PASS;
 }
 
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+/*
+ * priority-ordered waiters test
+ *
+ * Fibers of different priorities pend on a semaphore ordered by priority, in
+ * an order unrelated to their priorities. The task then gives the semaphore
+ * once per fiber, and checks that the fibers got it by decreasing priority,
+ * and in the order they started pending for fibers of the same priority.
+ */
+#define NUM_PRIO_WAITERS 5
+static const int prio_waiters_prio[NUM_PRIO_WAITERS] = { 7, 5, 9, 5, 3 };
+static const int prio_waiters_order[NUM_PRIO_WAITERS] = { 4, 1, 3, 0, 2 };
+static char __stack prio_waiters_stacks[NUM_PRIO_WAITERS][FIBER_STACKSIZE];
+static struct nano_sem prio_waiters;
+static int prio_waiters_woken[NUM_PRIO_WAITERS];
+static int prio_waiters_num_woken;
+
+/**
+ *
+ * @brief Fiber entry point for priority-ordered waiters test
+ *
+ * @return N/A
+ */
+
+static void fiber_prio_waiters(int id, int arg2)
+{
+	ARG_UNUSED(arg2);
+
+	nano_fiber_sem_take(&prio_waiters, TICKS_UNLIMITED);
+	prio_waiters_woken[prio_waiters_num_woken++] = id;
+}
+
+/**
+ *
+ * @brief Entry point for priority-ordered waiters test
+ *
+ * @return TC_PASS on success, TC_FAIL on failure
+ */
+
+static int test_prio_waiters(void)
+{
+	int ii;
+
+	nano_sem_init(&prio_waiters);
+	nano_sem_wait_prio_set(&prio_waiters);
+
+	/* each fiber preempts the task and pends on the semaphore */
+	for (ii = 0; ii < NUM_PRIO_WAITERS; ii++) {
+		task_fiber_start(prio_waiters_stacks[ii], FIBER_STACKSIZE,
+				 fiber_prio_waiters, ii, 0,
+				 prio_waiters_prio[ii], 0);
+	}
+
+	for (ii = 0; ii < NUM_PRIO_WAITERS; ii++) {
+		nano_task_sem_give(&prio_waiters);
+	}
+
+	if (prio_waiters_num_woken != NUM_PRIO_WAITERS) {
+		TC_ERROR(" *** %d fibers woken up, expected %d.\n",
+			 prio_waiters_num_woken, NUM_PRIO_WAITERS);
+		return TC_FAIL;
+	}
+
+	for (ii = 0; ii < NUM_PRIO_WAITERS; ii++) {
+		if (prio_waiters_woken[ii] != prio_waiters_order[ii]) {
+			TC_ERROR(" *** fiber %d woken up in position %d, "
+				 "expected fiber %d.\n", prio_waiters_woken[ii],
+				 ii, prio_waiters_order[ii]);
+			return TC_FAIL;
+		}
+	}
+
+	TC_PRINT("Fibers woken up in priority order, as expected.\n");
+
+	return TC_PASS;
+}
+#endif
+
 /* timeout tests
  *
  * Test the nano_xxx_sem_wait_timeout() APIs.
@@ -968,6 +1049,13 @@ void main(void)
 		goto doneTests;
 	}
 
+#ifdef CONFIG_NANO_WAIT_Q_PRIO
+	rv = test_prio_waiters();
+	if (rv != TC_PASS) {
+		goto doneTests;
+	}
+#endif
+
 doneTests:
 	TC_END_RESULT(rv);
 	TC_END_REPORT(rv);
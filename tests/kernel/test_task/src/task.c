@@ -270,6 +270,9 @@ void helperTaskSleepTest(void)
 int taskSleepTest(void)
 {
 	int32_t  tick;
+#ifdef CONFIG_THREAD_CPU_ACCOUNTING
+	uint64_t helper_cycles = task_cpu_cycles_get(HT_TASKID);
+#endif
 
 	task_sem_give(HT_SEM);
 
@@ -309,6 +312,17 @@ int taskSleepTest(void)
 		return TC_FAIL;
 	}
 
+#ifdef CONFIG_THREAD_CPU_ACCOUNTING
+	/* the helper task was charged for the time it ran */
+	helper_cycles = task_cpu_cycles_get(HT_TASKID) - helper_cycles;
+	if (helper_cycles < (uint64_t)(SLEEP_TIME - tick_error_allowed) *
+			    sys_clock_hw_cycles_per_tick) {
+		TC_ERROR("helper task was charged for %d cycles only\n",
+			 (uint32_t)helper_cycles);
+		return TC_FAIL;
+	}
+#endif
+
 	return TC_PASS;
 }
 
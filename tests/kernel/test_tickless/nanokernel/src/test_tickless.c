@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file
+ * @brief Test nanokernel tickless idle
+ *
+ * The background task waits on a nanokernel timer, leaving the CPU idle for
+ * IDLE_TICKS ticks, and the interrupts taken meanwhile are counted with the
+ * kernel event logger. With tickless idle, the system timer is programmed for
+ * the timer expiry and only a few interrupts are taken; without it, one
+ * interrupt per tick is taken.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <misc/kernel_event_logger.h>
+
+#define IDLE_TICKS              50
+
+/* wakeups tolerated while idling in tickless mode */
+#define MAX_TICKLESS_INTERRUPTS 4
+
+static struct nano_timer timer;
+
+/* discard the events logged so far, return the number of interrupts */
+static int interrupt_events_count(void)
+{
+	uint32_t data[4];
+	uint16_t event_id;
+	uint8_t dropped;
+	uint8_t size;
+	int count = 0;
+
+	do {
+		size = ARRAY_SIZE(data);
+		if (sys_k_event_logger_get(&event_id, &dropped,
+					   data, &size) <= 0) {
+			break;
+		}
+		if (dropped) {
+			TC_ERROR(" *** %d events dropped\n", dropped);
+		}
+		if (event_id == KERNEL_EVENT_LOGGER_INTERRUPT_EVENT_ID) {
+			count++;
+		}
+	} while (1);
+
+	return count;
+}
+
+void main(void)
+{
+	int status = TC_FAIL;
+	uint32_t start_tick;
+	uint32_t elapsed;
+	int count;
+
+	TC_START("Test Nanokernel Tickless Idle\n");
+
+	nano_timer_init(&timer, NULL);
+
+	/* start on a tick boundary with an empty event log */
+	task_sleep(1);
+	interrupt_events_count();
+
+	start_tick = sys_tick_get_32();
+	nano_task_timer_start(&timer, IDLE_TICKS);
+	nano_task_timer_test(&timer, TICKS_UNLIMITED);
+	elapsed = sys_tick_get_32() - start_tick;
+
+	count = interrupt_events_count();
+
+	TC_PRINT("%d interrupts while idle for %d ticks\n", count, elapsed);
+
+	if (elapsed < IDLE_TICKS) {
+		TC_ERROR(" *** timer expired after %d ticks, not %d\n",
+			 elapsed, IDLE_TICKS);
+		goto done_tests;
+	}
+
+#ifdef CONFIG_TICKLESS_IDLE
+	if (count > MAX_TICKLESS_INTERRUPTS) {
+		TC_ERROR(" *** more than %d interrupts in tickless idle\n",
+			 MAX_TICKLESS_INTERRUPTS);
+		goto done_tests;
+	}
+#else
+	if (count < IDLE_TICKS - 1) {
+		TC_ERROR(" *** less than one interrupt per tick\n");
+		goto done_tests;
+	}
+#endif
+
+	status = TC_PASS;
+
+done_tests:
+	TC_END_REPORT(status);
+}
@@ -18,6 +18,8 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
 #include <misc/printk.h>
 
 #include <net/buf.h>
@@ -49,6 +51,140 @@ static void buf_destroy(struct net_buf *buf)
 static NET_BUF_POOL(bufs_pool, 22, 74, &bufs_fifo, buf_destroy,
 		    sizeof(struct bt_data));
 
+static struct nano_fifo frags_fifo;
+
+static NET_BUF_POOL(frags_pool, 4, 74, &frags_fifo, NULL,
+		    sizeof(struct bt_data));
+
+static struct nano_fifo refs_fifo;
+
+static NET_BUF_POOL(refs_pool, 2, 0, &refs_fifo, NULL, 0);
+
+static int frags_free(void)
+{
+	struct net_buf *bufs[ARRAY_SIZE(frags_pool)];
+	struct net_buf *buf;
+	int count = 0;
+	int i;
+
+	while ((buf = nano_fifo_get(&frags_fifo, TICKS_NONE))) {
+		bufs[count++] = buf;
+	}
+
+	for (i = 0; i < count; i++) {
+		nano_fifo_put(&frags_fifo, bufs[i]);
+	}
+
+	return count;
+}
+
+static bool test_frags(void)
+{
+	struct net_buf *head, *frag;
+	int i;
+
+	head = net_buf_get(&frags_fifo, 0);
+	memset(net_buf_add(head, 10), 0, 10);
+
+	for (i = 0; i < ARRAY_SIZE(frags_pool) - 1; i++) {
+		frag = net_buf_get(&frags_fifo, 0);
+		memset(net_buf_add(frag, 20), 0, 20);
+		net_buf_frag_add(head, frag);
+	}
+
+	if (net_buf_frags_len(head) != 10 + 20 * i) {
+		printk("Invalid fragments length %u\n",
+		       net_buf_frags_len(head));
+		return false;
+	}
+
+	if (net_buf_frag_last(head) != frag) {
+		printk("Invalid last fragment\n");
+		return false;
+	}
+
+	frag = head->frags->frags;
+	if (net_buf_frag_del(head, head->frags) != frag ||
+	    head->frags != frag || frags_free() != 1) {
+		printk("Fragment not released\n");
+		return false;
+	}
+
+	net_buf_unref(head);
+
+	if (frags_free() != ARRAY_SIZE(frags_pool)) {
+		printk("Fragment chain not released\n");
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_clone(void)
+{
+	static const uint8_t data[] = { 0xde, 0xad, 0xbe, 0xef };
+	struct net_buf *buf, *clone;
+
+	buf = net_buf_get(&frags_fifo, 8);
+	memcpy(net_buf_add(buf, sizeof(data)), data, sizeof(data));
+
+	clone = net_buf_clone(buf);
+	if (clone->data != buf->data || clone->len != buf->len ||
+	    net_buf_headroom(clone) != 8) {
+		printk("Clone does not share the data\n");
+		return false;
+	}
+
+	/* The storage is kept until the clone is released */
+	net_buf_unref(buf);
+	if (frags_free() != ARRAY_SIZE(frags_pool) - 2) {
+		printk("Cloned buffer released too early\n");
+		return false;
+	}
+
+	net_buf_push_le16(clone, 0x1234);
+	if (clone->shared || net_buf_headroom(clone) != 6 ||
+	    memcmp(clone->data + 2, data, sizeof(data)) ||
+	    frags_free() != ARRAY_SIZE(frags_pool) - 1) {
+		printk("Clone not unshared when written\n");
+		return false;
+	}
+
+	net_buf_unref(clone);
+
+	return frags_free() == ARRAY_SIZE(frags_pool);
+}
+
+static bool test_clone_get(void)
+{
+	struct net_buf *head, *frag;
+
+	head = net_buf_get(&frags_fifo, 4);
+	memset(net_buf_add(head, 20), 0, 20);
+
+	/* A buffer without storage refers to a part of the data */
+	frag = net_buf_clone_get(&refs_fifo, head);
+	frag->len = 8;
+	net_buf_pull(head, frag->len);
+
+	if (frag->data + frag->len != head->data ||
+	    net_buf_headroom(frag) != 4 ||
+	    net_buf_tailroom(frag) != 74 - 4 - 8) {
+		printk("Clone does not refer to the data\n");
+		return false;
+	}
+
+	net_buf_unref(head);
+	if (frags_free() != ARRAY_SIZE(frags_pool) - 1) {
+		printk("Cloned buffer released too early\n");
+		return false;
+	}
+
+	net_buf_unref(frag);
+
+	return frags_free() == ARRAY_SIZE(frags_pool);
+}
+
 #ifdef CONFIG_MICROKERNEL
 void mainloop(void)
 #else
@@ -62,6 +198,8 @@ void main(void)
 	printk("sizeof(bufs_pool)      = %u\n", sizeof(bufs_pool));
 
 	net_buf_pool_init(bufs_pool);
+	net_buf_pool_init(frags_pool);
+	net_buf_pool_init(refs_pool);
 
 	for (i = 0; i < ARRAY_SIZE(bufs_pool); i++) {
 		struct net_buf *buf;
@@ -85,5 +223,9 @@ void main(void)
 		return;
 	}
 
+	if (!test_frags() || !test_clone() || !test_clone_get()) {
+		return;
+	}
+
 	printk("Buffer tests passed\n");
 }
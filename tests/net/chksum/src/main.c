@@ -0,0 +1,185 @@
+/* main.c - Internet checksum tests */
+
+/*
+ * Copyright (c) 2016 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zephyr.h>
+#include <stdint.h>
+#include <string.h>
+#include <tc_util.h>
+
+#include "contiki/ip/uip.h"
+
+/* Longer than a few 32-byte blocks, to go through every summing loop */
+#define MAX_LEN 300
+#define MAX_OFFSET 8
+
+/* Offset of the checksum field in the update test header */
+#define CHKSUM_OFFSET 10
+
+static uint8_t data[MAX_OFFSET + MAX_LEN] __aligned(8);
+
+/* One's complement sum of the byte pairs of a buffer, in host order */
+static uint16_t ref_chksum_add(uint16_t sum, const uint8_t *ptr, int len)
+{
+	uint32_t acc = sum;
+	int i;
+
+	for (i = 0; i + 1 < len; i += 2) {
+		acc += ((uint16_t)ptr[i] << 8) | ptr[i + 1];
+	}
+
+	if (len & 1) {
+		acc += (uint16_t)ptr[len - 1] << 8;
+	}
+
+	while (acc >> 16) {
+		acc = (acc & 0xffff) + (acc >> 16);
+	}
+
+	return acc;
+}
+
+static void fill(uint8_t pattern)
+{
+	uint32_t seed = 0x12345678;
+	int i;
+
+	for (i = 0; i < sizeof(data); i++) {
+		if (pattern) {
+			data[i] = pattern;
+		} else {
+			seed = seed * 1103515245 + 12345;
+			data[i] = seed >> 16;
+		}
+	}
+}
+
+static int test_add(void)
+{
+	static const uint16_t sums[] = { 0x0000, 0x1234, 0xffff };
+	static const uint8_t patterns[] = { 0, 0xff };
+	uint16_t expected, sum;
+	int p, s, offset, len;
+
+	for (p = 0; p < ARRAY_SIZE(patterns); p++) {
+		fill(patterns[p]);
+
+		for (s = 0; s < ARRAY_SIZE(sums); s++) {
+			for (offset = 0; offset < MAX_OFFSET; offset++) {
+				for (len = 0; len <= MAX_LEN; len++) {
+					expected = ref_chksum_add(sums[s],
+								  &data[offset],
+								  len);
+					sum = uip_chksum_add(sums[s],
+							     &data[offset],
+							     len);
+					if (sum != expected) {
+						TC_ERROR("offset %d len %d sum "
+							 "0x%04x: 0x%04x not "
+							 "0x%04x\n", offset,
+							 len, sums[s], sum,
+							 expected);
+						return TC_FAIL;
+					}
+				}
+			}
+		}
+	}
+
+	return TC_PASS;
+}
+
+/* Checksum field value of the header, as stored in the packet */
+static uint16_t header_chksum(uint8_t *hdr, int len)
+{
+	memset(&hdr[CHKSUM_OFFSET], 0, sizeof(uint16_t));
+
+	return uip_htons(~uip_chksum_add(0, hdr, len));
+}
+
+static int test_update(void)
+{
+	uint8_t *hdr = data;
+	int len = 40;
+	uint16_t chksum, updated, from16, to16;
+	uint32_t from32, to32;
+	int i;
+
+	fill(0);
+
+	for (i = 0; i < 64; i++) {
+		chksum = header_chksum(hdr, len);
+
+		/* Rewrite a 16-bit field, like a port */
+		memcpy(&from16, &hdr[20], sizeof(from16));
+		to16 = from16 * 31 + i;
+		memcpy(&hdr[20], &to16, sizeof(to16));
+
+		updated = uip_chksum_update16(chksum, from16, to16);
+		chksum = header_chksum(hdr, len);
+		if (updated != chksum) {
+			TC_ERROR("16-bit update 0x%04x not 0x%04x\n",
+				 updated, chksum);
+			return TC_FAIL;
+		}
+
+		/* Rewrite a 32-bit field, like an IPv4 address */
+		memcpy(&from32, &hdr[12], sizeof(from32));
+		to32 = from32 * 1103515245 + i;
+		memcpy(&hdr[12], &to32, sizeof(to32));
+
+		updated = uip_chksum_update32(chksum, from32, to32);
+		chksum = header_chksum(hdr, len);
+		if (updated != chksum) {
+			TC_ERROR("32-bit update 0x%04x not 0x%04x\n",
+				 updated, chksum);
+			return TC_FAIL;
+		}
+
+		/* The header with its checksum sums to 0xffff */
+		memcpy(&hdr[CHKSUM_OFFSET], &chksum, sizeof(chksum));
+		if (uip_chksum_add(0, hdr, len) != 0xffff) {
+			TC_ERROR("Header does not check\n");
+			return TC_FAIL;
+		}
+	}
+
+	return TC_PASS;
+}
+
+void main(void)
+{
+	int rv = TC_FAIL;
+
+	TC_START("Test Internet checksum");
+
+	TC_PRINT("Testing uip_chksum_add()\n");
+	if (test_add() != TC_PASS) {
+		goto done;
+	}
+
+	TC_PRINT("Testing uip_chksum_update16() and uip_chksum_update32()\n");
+	if (test_update() != TC_PASS) {
+		goto done;
+	}
+
+	rv = TC_PASS;
+
+done:
+	TC_END_RESULT(rv);
+	TC_END_REPORT(rv);
+}